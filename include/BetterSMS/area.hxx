@@ -15,6 +15,9 @@ namespace BetterSMS {
     namespace Stage {
         using NextStageCallback = void (*)(TMarDirector *);
 
+        // Registration-time description of a shine stage. BetterSMS packs all
+        // registered infos into a flat lookup table on first use and repacks
+        // it when a stage is registered or an info gains scenarios.
         class ShineAreaInfo {
         public:
             ShineAreaInfo() = delete;
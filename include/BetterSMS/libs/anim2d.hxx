@@ -6,17 +6,19 @@
 #include <JSystem/J2D/J2DPicture.hxx>
 #include <JSystem/JUtility/JUTTexture.hxx>
 
+#include "../time.hxx"
+
 class SimpleTexAnimator {
 public:
     SimpleTexAnimator()
-        : mTextures(nullptr), mTexCount(0), mRotation(0.0f), mSpin(0.0f), mLastTime(0),
+        : mTextures(nullptr), mTexCount(0), mRotation(0.0f), mSpin(0.0f), mAppliedFrame(-1),
           mCurrentFrame(0.0f), mFrameRate(30.0f) {}
     SimpleTexAnimator(const ResTIMG **textures, size_t texCount)
-        : mTextures(textures), mTexCount(texCount), mRotation(0.0f), mSpin(0.0f), mLastTime(0),
+        : mTextures(textures), mTexCount(texCount), mRotation(0.0f), mSpin(0.0f), mAppliedFrame(-1),
           mCurrentFrame(0.0f), mFrameRate(30.0f) {}
     SimpleTexAnimator(const u8 **textures, size_t texCount)
-        : mTexCount(texCount), mRotation(0.0f), mSpin(0.0f), mLastTime(0), mCurrentFrame(0.0f),
-          mFrameRate(30.0f) {
+        : mTexCount(texCount), mRotation(0.0f), mSpin(0.0f), mAppliedFrame(-1),
+          mCurrentFrame(0.0f), mFrameRate(30.0f) {
         mTextures = reinterpret_cast<const ResTIMG **>(textures);
     }
     ~SimpleTexAnimator() {}
@@ -29,19 +31,17 @@ public:
         mTextures     = textures;
         mTexCount     = texCount;
         mCurrentFrame = texCount;
+        mAppliedFrame = -1;
     }
     void setCurrentFrame(u32 frame) { mCurrentFrame = static_cast<f32>(frame); }
     void setFrameRate(f32 rate) { mFrameRate = rate; }
     void setRotation(f32 rotation) { mRotation = rotation; }
     void setSpin(f32 degreesPerFrame) { mSpin = degreesPerFrame; };
 
-    void process(J2DPicture *picture) {
-        if (mLastTime == 0)
-            mLastTime = OSTicksToSeconds(f64(OSGetTime()));
-
-        f64 currentTime = OSTicksToSeconds(f64(OSGetTime()));
-        f64 diff        = currentTime - mLastTime;
-        mLastTime       = currentTime;
+    // Advances by the shared frame clock, so every animator moves in step.
+    // Returns the new texture when the integer frame changes, else nullptr.
+    const ResTIMG *advance() {
+        const f32 diff = BetterSMS::Time::frameDelta();
 
         mCurrentFrame += diff * mFrameRate;
         mRotation += diff * mFrameRate * mSpin;
@@ -49,13 +49,24 @@ public:
         if (mCurrentFrame >= mTexCount)
             mCurrentFrame -= mTexCount - 1.0;
 
-        picture->changeTexture(mTextures[static_cast<size_t>(mCurrentFrame) % mTexCount], 0);
+        const s32 frame = static_cast<size_t>(mCurrentFrame) % mTexCount;
+        if (frame == mAppliedFrame)
+            return nullptr;
+
+        mAppliedFrame = frame;
+        return mTextures[frame];
+    }
+
+    void process(J2DPicture *picture) {
+        const ResTIMG *texture = advance();
+        if (texture)
+            picture->changeTexture(texture, 0);
         picture->mRotation = mRotation;
     }
 
     void resetAnimation() {
         mRotation     = 0.0f;
-        mLastTime     = 0;
+        mAppliedFrame = -1;
         mCurrentFrame = 0;
     }
 
@@ -64,7 +75,7 @@ private:
     size_t mTexCount;
     f32 mRotation;
     f32 mSpin;
-    f64 mLastTime;
+    s32 mAppliedFrame;
     f32 mCurrentFrame;
     f32 mFrameRate;
 };
\ No newline at end of file
@@ -27,8 +27,9 @@ struct BoundingBox {
         this->rotation = rotation;
     }
     BoundingBox(const TVec3f &center, const TVec3f &size) {
-        this->center = center;
-        this->size   = size;
+        this->center   = center;
+        this->size     = size;
+        this->rotation = {0.0f, 0.0f, 0.0f};
     }
     BoundingBox(const TVec3f &center, const TVec3f &size, const TVec3f &rotation) {
         this->center   = center;
@@ -36,11 +37,51 @@ struct BoundingBox {
         this->rotation = rotation;
     }
 
+    bool isAxisAligned() const {
+        return rotation.x == 0.0f && rotation.y == 0.0f && rotation.z == 0.0f;
+    }
+
     TVec3f sample(f32 lx, f32 ly, f32 lz, f32 scale = 1.0f,
                   BoundingType type = BoundingType::Box) const {
+        TVec3f local_point = sampleLocal(size, lx, ly, lz, scale, type);
+        if (isAxisAligned()) {
+            local_point += center;
+            return local_point;
+        }
+
         Mtx rot;
         MsMtxSetTRS(rot, 0, 0, 0, rotation.x, rotation.y, rotation.z, 1, 1, 1);
 
+        // Transform this point to the global space.
+        TVec3f global_point;
+        PSMTXMultVec(rot, local_point, global_point);
+        global_point += center;
+
+        return global_point;
+    }
+
+    bool contains(const TVec3f &point, f32 scale = 1.0f,
+                  BoundingType type = BoundingType::Box) const {
+        TVec3f local_point = point;
+        local_point -= center;
+
+        if (isAxisAligned()) {
+            return containsLocal(size, local_point, scale, type);
+        }
+
+        Mtx rot, inv_rot;
+        MsMtxSetTRS(rot, 0, 0, 0, rotation.x, rotation.y, rotation.z, 1, 1, 1);
+
+        PSMTXInverse(rot, inv_rot);
+
+        TVec3f inv_point;
+        PSMTXMultVec(inv_rot, local_point, inv_point);
+        return containsLocal(size, inv_point, scale, type);
+    }
+
+    // Maps a unit sample to a point in the unrotated, uncentered volume
+    static TVec3f sampleLocal(const TVec3f &size, f32 lx, f32 ly, f32 lz, f32 scale,
+                              BoundingType type) {
         // Calculate the point in the local space of the box.
         TVec3f local_point;
         local_point.x = (lx - 0.5f) * size.x;
@@ -49,65 +90,141 @@ struct BoundingBox {
 
         if (type == BoundingType::Box) {
             local_point.scale(scale);
+            return local_point;
+        }
+
+        // Step 3: Calculate the magnitude of the normalized point and normalize the point to
+        // ensure it lies within the unit sphere.
+        float magnitude = sqrtf(local_point.x * local_point.x + local_point.y * local_point.y +
+                                local_point.z * local_point.z);
+
+        local_point.x /= magnitude;
+        local_point.y /= magnitude;
+        local_point.z /= magnitude;
+
+        // Step 4: Scale the point by the half-lengths of the box to get the corresponding point
+        // in the spheroid space.
+        TVec3f spheroid_point;
+        spheroid_point.x = local_point.x * (size.x * 0.5f);
+        spheroid_point.y = local_point.y * (size.y * 0.5f);
+        spheroid_point.z = local_point.z * (size.z * 0.5f);
+
+        spheroid_point.scale(scale);
+        return spheroid_point;
+    }
+
+    // Tests a point already moved into the unrotated, uncentered space of the volume
+    static bool containsLocal(const TVec3f &size, const TVec3f &local_point, f32 scale,
+                              BoundingType type) {
+        if (type == BoundingType::Box) {
+            return (fabsf(local_point.x) <= size.x * 0.5f * scale) &&
+                   (fabsf(local_point.y) <= size.y * 0.5f * scale) &&
+                   (fabsf(local_point.z) <= size.z * 0.5f * scale);
+        }
+
+        // Normalize the point's coordinates with respect to the half-lengths of the box.
+        f32 nx = local_point.x / (size.x * 0.5f * scale);
+        f32 ny = local_point.y / (size.y * 0.5f * scale);
+        f32 nz = local_point.z / (size.z * 0.5f * scale);
 
-            // Transform this point to the global space.
-            TVec3f global_point;
-            PSMTXMultVec(rot, local_point, global_point);
-            global_point += center;
-
-            return global_point;
-        } else {
-            // Step 3: Calculate the magnitude of the normalized point and normalize the point to
-            // ensure it lies within the unit sphere.
-            float magnitude = sqrtf(local_point.x * local_point.x + local_point.y * local_point.y +
-                                    local_point.z * local_point.z);
-
-            local_point.x /= magnitude;
-            local_point.y /= magnitude;
-            local_point.z /= magnitude;
-
-            // Step 4: Scale the point by the half-lengths of the box to get the corresponding point
-            // in the spheroid space.
-            TVec3f spheroid_point;
-            spheroid_point.x = local_point.x * (size.x * 0.5f);
-            spheroid_point.y = local_point.y * (size.y * 0.5f);
-            spheroid_point.z = local_point.z * (size.z * 0.5f);
-
-            spheroid_point.scale(scale);
-
-            // Transform this point to the global space.
-            TVec3f global_point;
-            PSMTXMultVec(rot, spheroid_point, global_point);
-            global_point += center;
-
-            return global_point;
+        // The point is inside the spheroid if the sum of the squares of its normalized
+        // coordinates is less than or equal to 1.
+        return (nx * nx + ny * ny + nz * nz) <= 1.0f;
+    }
+};
+
+// BoundingBox that keeps its rotation matrix and inverse between calls.
+// The matrices are only rebuilt when the rotation actually changes, and an
+// unrotated box skips matrix work entirely.
+class CachedBoundingBox {
+public:
+    CachedBoundingBox() : mBox(), mIsAxisAligned(true) {
+        mBox.center   = {0.0f, 0.0f, 0.0f};
+        mBox.size     = {1.0f, 1.0f, 1.0f};
+        mBox.rotation = {0.0f, 0.0f, 0.0f};
+        PSMTXIdentity(mRotMtx);
+        PSMTXIdentity(mInvRotMtx);
+    }
+    CachedBoundingBox(const TVec3f &center, const TVec3f &size, const TVec3f &rotation)
+        : CachedBoundingBox() {
+        set(center, size, rotation);
+    }
+
+    [[nodiscard]] const BoundingBox &getBox() const { return mBox; }
+    [[nodiscard]] bool isAxisAligned() const { return mIsAxisAligned; }
+
+    void set(const TVec3f &center, const TVec3f &size, const TVec3f &rotation) {
+        mBox.center = center;
+        mBox.size   = size;
+        setRotation(rotation);
+    }
+
+    void setRotation(const TVec3f &rotation) {
+        if (rotation.x == mBox.rotation.x && rotation.y == mBox.rotation.y &&
+            rotation.z == mBox.rotation.z) {
+            return;
         }
+
+        mBox.rotation  = rotation;
+        mIsAxisAligned = mBox.isAxisAligned();
+
+        if (mIsAxisAligned) {
+            PSMTXIdentity(mRotMtx);
+            PSMTXIdentity(mInvRotMtx);
+            return;
+        }
+
+        MsMtxSetTRS(mRotMtx, 0, 0, 0, rotation.x, rotation.y, rotation.z, 1, 1, 1);
+        PSMTXInverse(mRotMtx, mInvRotMtx);
+    }
+
+    TVec3f sample(f32 lx, f32 ly, f32 lz, f32 scale = 1.0f,
+                  BoundingType type = BoundingType::Box) const {
+        TVec3f local_point = BoundingBox::sampleLocal(mBox.size, lx, ly, lz, scale, type);
+        if (mIsAxisAligned) {
+            local_point += mBox.center;
+            return local_point;
+        }
+
+        TVec3f global_point;
+        PSMTXMultVec(mRotMtx, local_point, global_point);
+        global_point += mBox.center;
+
+        return global_point;
     }
 
     bool contains(const TVec3f &point, f32 scale = 1.0f,
                   BoundingType type = BoundingType::Box) const {
-        Mtx rot, inv_rot;
-        MsMtxSetTRS(rot, 0, 0, 0, rotation.x, rotation.y, rotation.z, 1, 1, 1);
+        return BoundingBox::containsLocal(mBox.size, toLocal(point), scale, type);
+    }
 
-        PSMTXInverse(rot, inv_rot);
+    // Tests `count` points, writing each result to `out`. Returns how many were contained.
+    size_t containsMany(const TVec3f *points, bool *out, size_t count, f32 scale = 1.0f,
+                        BoundingType type = BoundingType::Box) const {
+        size_t contained = 0;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = BoundingBox::containsLocal(mBox.size, toLocal(points[i]), scale, type);
+            contained += out[i] ? 1 : 0;
+        }
+        return contained;
+    }
 
-        TVec3f local_point = point, inv_point;
-        local_point -= center;
-        PSMTXMultVec(inv_rot, local_point, inv_point);
-        if (type == BoundingType::Box) {
-            return (fabsf(inv_point.x) <= size.x * 0.5f * scale) &&
-                   (fabsf(inv_point.y) <= size.y * 0.5f * scale) &&
-                   (fabsf(inv_point.z) <= size.z * 0.5f * scale);
-        } else {
-            // Normalize the point's coordinates with respect to the half-lengths of the box.
-            inv_point.x /= (size.x * 0.5f * scale);
-            inv_point.y /= (size.y * 0.5f * scale);
-            inv_point.z /= (size.z * 0.5f * scale);
-
-            // The point is inside the spheroid if the sum of the squares of its normalized
-            // coordinates is less than or equal to 1.
-            return sqrtf((inv_point.x * inv_point.x + inv_point.y * inv_point.y +
-                          inv_point.z * inv_point.z)) <= 1.0f;
+private:
+    TVec3f toLocal(const TVec3f &point) const {
+        TVec3f local_point = point;
+        local_point -= mBox.center;
+
+        if (mIsAxisAligned) {
+            return local_point;
         }
+
+        TVec3f inv_point;
+        PSMTXMultVec(mInvRotMtx, local_point, inv_point);
+        return inv_point;
     }
-};
\ No newline at end of file
+
+    BoundingBox mBox;
+    Mtx mRotMtx;
+    Mtx mInvRotMtx;
+    bool mIsAxisAligned;
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <Dolphin/MTX.h>
+#include <Dolphin/math.h>
+#include <Dolphin/types.h>
+#include <JSystem/JGeometry/JGMVec.hxx>
+#include <SMS/ppc_intrinsics.h>
+
+// Square roots and trigonometry in three accuracy tiers, so hot paths can pick
+// what they can afford instead of whatever sqrtf happens to resolve to:
+//
+//   FAST   - frsqrte estimate refined by one Newton step, the same as the
+//            library sqrtf. Good for distances compared against a threshold.
+//   MEDIUM - two Newton steps in single precision, within 3 ULP. Good for
+//            normals and anything fed back into the simulation.
+//   EXACT  - refined in double precision and rounded once, matching a
+//            correctly rounded sqrtf for all but a handful of inputs.
+//
+// The bounds assume frsqrte is good to about 12 bits. tools/MathCheck checks
+// them against libm over every mantissa and can rerun with a weaker estimate.
+//
+// Every scalar helper is constexpr; constant evaluation uses a bit trick seed
+// in place of frsqrte so the same call works in both contexts.
+
+namespace BetterSMS {
+    namespace Math {
+
+        enum class Tier : u8 { FAST, MEDIUM, EXACT };
+
+        namespace Detail {
+            constexpr bool isConstantEvaluated() {
+#if defined(__has_builtin) && __has_builtin(__builtin_is_constant_evaluated)
+                return __builtin_is_constant_evaluated();
+#else
+                return false;
+#endif
+            }
+
+            constexpr f64 seedRsqrt(f64 x) {
+                if (!isConstantEvaluated())
+                    return __frsqrte(x);
+                const u64 bits = __builtin_bit_cast(u64, x);
+                return __builtin_bit_cast(f64, 0x5FE6EB50C7B537A9ULL - (bits >> 1));
+            }
+
+            constexpr f32 seedRsqrt(f32 x) {
+                if (!isConstantEvaluated())
+                    return __frsqrtes(x);
+                const u32 bits = __builtin_bit_cast(u32, x);
+                return __builtin_bit_cast(f32, static_cast<u32>(0x5F375A86) - (bits >> 1));
+            }
+
+            template <typename T> constexpr T newtonRsqrt(T x, T y) {
+                return y * (T(1.5) - (T(0.5) * x * y * y));
+            }
+        }  // namespace Detail
+
+        // 1 / sqrt(x), x must be positive
+        template <Tier P = Tier::MEDIUM> constexpr f32 rsqrt(f32 x) {
+            if constexpr (P == Tier::EXACT) {
+                const f64 d = x;
+                f64 y       = Detail::seedRsqrt(d);
+                y           = Detail::newtonRsqrt(d, y);
+                y           = Detail::newtonRsqrt(d, y);
+                y           = Detail::newtonRsqrt(d, y);
+                if (Detail::isConstantEvaluated()) {
+                    y = Detail::newtonRsqrt(d, y);
+                    y = Detail::newtonRsqrt(d, y);
+                }
+                return static_cast<f32>(y);
+            } else {
+                f32 y = Detail::seedRsqrt(x);
+                y     = Detail::newtonRsqrt(x, y);
+                if constexpr (P == Tier::MEDIUM)
+                    y = Detail::newtonRsqrt(x, y);
+                if (Detail::isConstantEvaluated()) {
+                    y = Detail::newtonRsqrt(x, y);
+                    y = Detail::newtonRsqrt(x, y);
+                }
+                return y;
+            }
+        }
+
+        // sqrt(x), non positive input is returned unchanged like the library sqrtf
+        template <Tier P = Tier::MEDIUM> constexpr f32 sqrt(f32 x) {
+            if (!(x > 0.0f))
+                return x;
+            if constexpr (P == Tier::EXACT) {
+                // Multiply in double so the single rounding happens at the end
+                const f64 d = x;
+                f64 y       = Detail::seedRsqrt(d);
+                y           = Detail::newtonRsqrt(d, y);
+                y           = Detail::newtonRsqrt(d, y);
+                y           = Detail::newtonRsqrt(d, y);
+                if (Detail::isConstantEvaluated()) {
+                    y = Detail::newtonRsqrt(d, y);
+                    y = Detail::newtonRsqrt(d, y);
+                }
+                return static_cast<f32>(d * y);
+            } else {
+                return x * rsqrt<P>(x);
+            }
+        }
+
+        template <Tier P = Tier::MEDIUM> constexpr f32 hypot(f32 x, f32 y) {
+            return sqrt<P>(x * x + y * y);
+        }
+
+        template <Tier P = Tier::MEDIUM> constexpr f32 magnitude(f32 x, f32 y, f32 z) {
+            return sqrt<P>(x * x + y * y + z * z);
+        }
+
+        // Scales vec to unit length and returns its original length. A zero
+        // vector is left untouched and reports 0.
+        template <Tier P = Tier::MEDIUM> inline f32 normalize(TVec3f &vec) {
+            const f32 sq = vec.x * vec.x + vec.y * vec.y + vec.z * vec.z;
+            if (!(sq > 0.0f))
+                return 0.0f;
+            const f32 inv = rsqrt<P>(sq);
+            vec.x *= inv;
+            vec.y *= inv;
+            vec.z *= inv;
+            return sq * inv;
+        }
+
+        template <Tier P = Tier::MEDIUM> inline f32 normalize(const TVec3f &vec, TVec3f &out) {
+            out = vec;
+            return normalize<P>(out);
+        }
+
+        template <Tier P = Tier::MEDIUM> inline f32 normalize(Vec &vec) {
+            return normalize<P>(reinterpret_cast<TVec3f &>(vec));
+        }
+
+        // Batch forms run one tier over a whole array so the loop stays free
+        // of calls into the library. in and out may alias.
+        template <Tier P = Tier::MEDIUM> inline void rsqrt(const f32 *in, f32 *out, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = rsqrt<P>(in[i]);
+        }
+
+        template <Tier P = Tier::MEDIUM> inline void sqrt(const f32 *in, f32 *out, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = sqrt<P>(in[i]);
+        }
+
+        template <Tier P = Tier::MEDIUM> inline void normalize(TVec3f *vecs, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                normalize<P>(vecs[i]);
+        }
+
+        // Table driven sine and cosine in radians, linearly interpolated
+        // between SinTableSize samples of one turn. Max error is about 5e-6,
+        // the cost is a multiply, two loads and a lerp. Use the math.h
+        // functions when exact results are required.
+        constexpr size_t SinTableSize = 1024;
+
+        f32 sinTable(f32 radians);
+        f32 cosTable(f32 radians);
+        void sinCosTable(f32 radians, f32 &sin, f32 &cos);
+        void batchSinCosTable(const f32 *radians, f32 *sins, f32 *coss, size_t count);
+
+    }  // namespace Math
+}  // namespace BetterSMS
@@ -6,50 +6,71 @@
 #include <JSystem/JGeometry/JGMVec.hxx>
 #include <SMS/MarioUtil/MathUtil.hxx>
 
+// Host builds of tools/MathCheck define the config themselves
+#ifndef BETTER_SMS_USE_PS_MATH
 #include "../module.hxx"
+#endif
 #include "constmath.hxx"
+#include "fastmath.hxx"
 
 namespace BetterSMS {
 
+#ifdef __powerpc__
+    // Paired single loops behind the array forms, in src/asm/geometry.s
+    namespace Detail {
+        void psMagnitudeArray(const TVec3f *vecs, f32 *out, size_t count);
+        void psNormalizeArray(const TVec3f *vecs, TVec3f *out, size_t count);
+        void psDotArray(const TVec3f *a, const TVec3f *b, f32 *out, size_t count);
+        void psAngleBetweenArray(const TVec3f *a, const TVec3f *b, f32 *out, size_t count);
+        void psLookAtRatioArray(const TVec3f *a, const TVec3f *b, f32 *out, size_t count);
+        // up may be null to pick each up the way normalToRotationU does
+        void psNormalToRotationArray(const TVec3f *norms, const TVec3f *up, Mtx *out,
+                                     size_t count);
+        void psDecomposeArray(const Mtx *mtx, TVec3f *translation, TVec3f *rotation,
+                              TVec3f *scale, size_t count);
+    }  // namespace Detail
+#endif
+
     class Matrix {
     public:
         static void normalToRotation(const TVec3f &norm, const TVec3f &up, Mtx &out) {
             TVec3f forward{};
             PSVECNormalize(norm, forward);
-
-            TVec3f localup{};
-            TVec3f right{};
-
-            PSVECCrossProduct(up, forward, right);
-            PSVECNormalize(right, right);
-            PSVECCrossProduct(forward, right, localup);
-
-            PSMTXIdentity(out);
-            out[0][0] = right.x;
-            out[0][1] = right.y;
-            out[0][2] = right.z;
-
-            out[1][0] = localup.x;
-            out[1][1] = localup.y;
-            out[1][2] = localup.z;
-
-            out[2][0] = forward.x;
-            out[2][1] = forward.y;
-            out[2][2] = forward.z;
+            unitNormalToRotation(forward, up, out);
         }
 
         static void normalToRotationU(const TVec3f &norm, Mtx &out) {
             TVec3f forward{};
             PSVECNormalize(norm, forward);
-            TVec3f up = fabsf(forward.y) < 0.999f ? TVec3f::up() : TVec3f::forward();
-            normalToRotation(norm, up, out);
+            const TVec3f up = fabsf(forward.y) < 0.999f ? TVec3f::up() : TVec3f::forward();
+            unitNormalToRotation(forward, up, out);
         }
 
         static void normalToRotationF(const TVec3f &norm, Mtx &out) {
             TVec3f forward{};
             PSVECNormalize(norm, forward);
-            TVec3f up = fabsf(forward.y) > 0.001f ? TVec3f::forward() : TVec3f::up();
-            normalToRotation(norm, up, out);
+            const TVec3f up = fabsf(forward.y) > 0.001f ? TVec3f::forward() : TVec3f::up();
+            unitNormalToRotation(forward, up, out);
+        }
+
+        // Batch forms for callers that orient many surfaces in one pass
+        static void normalToRotation(const TVec3f *norms, const TVec3f &up, Mtx *out,
+                                     size_t count) {
+#ifdef __powerpc__
+            Detail::psNormalToRotationArray(norms, &up, out, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                normalToRotation(norms[i], up, out[i]);
+#endif
+        }
+
+        static void normalToRotationU(const TVec3f *norms, Mtx *out, size_t count) {
+#ifdef __powerpc__
+            Detail::psNormalToRotationArray(norms, nullptr, out, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                normalToRotationU(norms[i], out[i]);
+#endif
         }
 
         static float determinant(const Mtx& mtx) {
@@ -60,62 +81,109 @@ namespace BetterSMS {
 
         static void decompose(const Mtx &mtx, TVec3f &translation, TVec3f &rotation,
                               TVec3f &scale) {
-            scale.x = sqrtf(mtx[0][0] * mtx[0][0] + mtx[1][0] * mtx[1][0] + mtx[2][0] * mtx[2][0]);
-            scale.y = sqrtf(mtx[0][1] * mtx[0][1] + mtx[1][1] * mtx[1][1] + mtx[2][1] * mtx[2][1]);
-            scale.z = sqrtf(mtx[0][2] * mtx[0][2] + mtx[1][2] * mtx[1][2] + mtx[2][2] * mtx[2][2]);
+            translation.x = mtx[0][3];
+            translation.y = mtx[1][3];
+            translation.z = mtx[2][3];
 
-            if (scale.x == 0.0f || scale.y == 0.0f || scale.z == 0.0f) {
+            const f32 sqX = mtx[0][0] * mtx[0][0] + mtx[1][0] * mtx[1][0] + mtx[2][0] * mtx[2][0];
+            const f32 sqY = mtx[0][1] * mtx[0][1] + mtx[1][1] * mtx[1][1] + mtx[2][1] * mtx[2][1];
+            const f32 sqZ = mtx[0][2] * mtx[0][2] + mtx[1][2] * mtx[1][2] + mtx[2][2] * mtx[2][2];
+
+            if (sqX == 0.0f || sqY == 0.0f || sqZ == 0.0f) {
+                scale.x    = Math::sqrt<Math::Tier::MEDIUM>(sqX);
+                scale.y    = Math::sqrt<Math::Tier::MEDIUM>(sqY);
+                scale.z    = Math::sqrt<Math::Tier::MEDIUM>(sqZ);
                 rotation.x = 0.0f;
                 rotation.y = 0.0f;
                 rotation.z = 0.0f;
-                translation.x = mtx[0][3];
-                translation.y = mtx[1][3];
-                translation.z = mtx[2][3];
                 return;
             }
 
+            // One reciprocal root per axis gives both the scale and its inverse
+            f32 invX = Math::rsqrt<Math::Tier::MEDIUM>(sqX);
+            f32 invY = Math::rsqrt<Math::Tier::MEDIUM>(sqY);
+            f32 invZ = Math::rsqrt<Math::Tier::MEDIUM>(sqZ);
+
+            scale.x = sqX * invX;
+            scale.y = sqY * invY;
+            scale.z = sqZ * invZ;
+
             if (determinant(mtx) < 0.0f) {
                 scale.x = -scale.x;
                 scale.y = -scale.y;
                 scale.z = -scale.z;
+                invX    = -invX;
+                invY    = -invY;
+                invZ    = -invZ;
             }
 
-            // Scale rotation matrix
-            Mtx rot{};
-            PSMTXCopy(mtx, rot);
+            // Only the rotation terms read below are unscaled
+            rotationFromTerms(mtx[0][0] * invX, mtx[1][0] * invX, mtx[1][1] * invY,
+                              mtx[2][0] * invX, mtx[2][1] * invY, mtx[2][2] * invZ, rotation);
+        }
 
-            for (size_t i = 0; i < 3; i++) {
-                rot[i][0] /= scale.x;
-                rot[i][1] /= scale.y;
-                rot[i][2] /= scale.z;
-            }
+        static void decompose(const Mtx *mtx, TVec3f *translation, TVec3f *rotation,
+                              TVec3f *scale, size_t count) {
+#ifdef __powerpc__
+            Detail::psDecomposeArray(mtx, translation, rotation, scale, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                decompose(mtx[i], translation[i], rotation[i], scale[i]);
+#endif
+        }
 
-            f32 sy = -rot[2][0];
-            f32 y  = M_PI * 0.5f + acosf(sy);
-            f32 cy = cosf(y);
+    private:
+#ifdef __powerpc__
+        friend void Detail::psDecomposeArray(const Mtx *mtx, TVec3f *translation,
+                                             TVec3f *rotation, TVec3f *scale, size_t count);
+#endif
 
+        // Euler angles from the unscaled rotation entries decompose reads
+        static void rotationFromTerms(f32 r00, f32 r10, f32 r11, f32 r20, f32 r21, f32 r22,
+                                      TVec3f &rotation) {
+            const f32 sy = -r20;
             if (sy > 0.999f) {
                 rotation.x = 0;
                 rotation.y = -radiansToAngle(M_PI * 0.5f);
-                rotation.z = radiansToAngle(atan2f(-rot[1][0], rot[1][1]));
+                rotation.z = radiansToAngle(atan2f(-r10, r11));
             } else if (sy < -0.999f) {
                 rotation.x = 0;
                 rotation.y = -radiansToAngle(-M_PI * 0.5f);
-                rotation.z = radiansToAngle(atan2f(-rot[1][0], rot[1][1]));
+                rotation.z = radiansToAngle(atan2f(-r10, r11));
             } else {
-                f32 cx = rot[2][2] / cy;
-                f32 sx = rot[2][1] / cy;
-                f32 cz = rot[0][0] / cy;
-                f32 sz = rot[1][0] / cy;
+                // cos(pi/2 + acos(sy)) == -sqrt(1 - sy^2), saves the cosf call
+                const f32 y     = M_PI * 0.5f + acosf(sy);
+                const f32 invCy = -Math::rsqrt<Math::Tier::MEDIUM>(1.0f - sy * sy);
 
-                rotation.x = radiansToAngle(atan2f(sx, cx));
+                rotation.x = radiansToAngle(atan2f(r21 * invCy, r22 * invCy));
                 rotation.y = radiansToAngle(y);
-                rotation.z = radiansToAngle(atan2f(sz, cz));
+                rotation.z = radiansToAngle(atan2f(r10 * invCy, r00 * invCy));
             }
+        }
 
-            translation.x = mtx[0][3];
-            translation.y = mtx[1][3];
-            translation.z = mtx[2][3];
+        // forward must already be unit length
+        static void unitNormalToRotation(const TVec3f &forward, const TVec3f &up, Mtx &out) {
+            TVec3f localup{};
+            TVec3f right{};
+
+            PSVECCrossProduct(up, forward, right);
+            PSVECNormalize(right, right);
+            PSVECCrossProduct(forward, right, localup);
+
+            out[0][0] = right.x;
+            out[0][1] = right.y;
+            out[0][2] = right.z;
+            out[0][3] = 0.0f;
+
+            out[1][0] = localup.x;
+            out[1][1] = localup.y;
+            out[1][2] = localup.z;
+            out[1][3] = 0.0f;
+
+            out[2][0] = forward.x;
+            out[2][1] = forward.y;
+            out[2][2] = forward.z;
+            out[2][3] = 0.0f;
         }
     };
 
@@ -125,7 +193,7 @@ namespace BetterSMS {
 #if BETTER_SMS_USE_PS_MATH
             return PSVECMag(vec);
 #else
-            return sqrtf(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z);
+            return Math::magnitude<Math::Tier::MEDIUM>(vec.x, vec.y, vec.z);
 #endif
         }
 
@@ -133,7 +201,7 @@ namespace BetterSMS {
 #if BETTER_SMS_USE_PS_MATH
             return PSVECMag(&vec);
 #else
-            return sqrtf(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z);
+            return Math::magnitude<Math::Tier::MEDIUM>(vec.x, vec.y, vec.z);
 #endif
         }
 
@@ -148,7 +216,7 @@ namespace BetterSMS {
 #if BETTER_SMS_USE_PS_MATH
             PSVECNormalize(vec, out);
 #else
-            out.scale(magnitude(vec), vec);
+            Math::normalize<Math::Tier::MEDIUM>(vec, out);
 #endif
         }
 
@@ -156,10 +224,8 @@ namespace BetterSMS {
 #if BETTER_SMS_USE_PS_MATH
             PSVECNormalize(&vec, &out);
 #else
-            const f32 mag = magnitude(vec);
-            out.x         = vec.x / mag;
-            out.y         = vec.y / mag;
-            out.z         = vec.z / mag;
+            out = vec;
+            Math::normalize<Math::Tier::MEDIUM>(out);
 #endif
         }
 
@@ -205,34 +271,75 @@ namespace BetterSMS {
             return MsGetRotFromZaxisY(diff);
         }
 
+        // Equivalent to wrapping atan2(b.z, -b.x) - atan2(a.z, a.x) into (-pi, pi],
+        // folded into a single atan2 of the planar cross and dot products
         static f32 lookAtRatio(const TVec3f &a, const TVec3f &b) {
-            f32 angle = atan2f(b.z, -b.x) - atan2f(a.z, a.x);
-            if (angle > M_PI) {
-                angle -= 2 * M_PI;
-            } else if (angle <= -M_PI) {
-                angle += 2 * M_PI;
-            }
-            return fabsf(angle) / M_PI;
+            return fabsf(atan2f(a.x * b.z + a.z * b.x, a.z * b.z - a.x * b.x)) / M_PI;
         }
 
         static f32 lookAtRatio(const Vec &a, const Vec &b) {
-            f32 angle = atan2f(b.z, -b.x) - atan2f(a.z, a.x);
-            if (angle > M_PI) {
-                angle -= 2 * M_PI;
-            } else if (angle <= -M_PI) {
-                angle += 2 * M_PI;
-            }
-            return fabsf(angle) / M_PI;
+            return fabsf(atan2f(a.x * b.z + a.z * b.x, a.z * b.z - a.x * b.x)) / M_PI;
         }
 
+        // Cosine of the angle between a and b, with one reciprocal root in
+        // place of two magnitudes and a divide
         static f32 angleBetween(const TVec3f &a, const TVec3f &b) {
-            return dot(a, b) / (magnitude(a) * magnitude(b));
+            const f32 sq = dot(a, a) * dot(b, b);
+            return sq > 0.0f ? dot(a, b) * Math::rsqrt<Math::Tier::MEDIUM>(sq) : 0.0f;
         }
 
         static f32 angleBetween(const Vec &a, const Vec &b) {
-            return dot(a, b) / (magnitude(a) * magnitude(b));
+            const f32 sq = dot(a, a) * dot(b, b);
+            return sq > 0.0f ? dot(a, b) * Math::rsqrt<Math::Tier::MEDIUM>(sq) : 0.0f;
+        }
+
+        // Array forms, out may alias the input where the types match. On the
+        // console they run as paired single loops with MEDIUM tier roots,
+        // elsewhere they repeat the scalar forms.
+        static void magnitude(const TVec3f *vecs, f32 *out, size_t count) {
+#ifdef __powerpc__
+            Detail::psMagnitudeArray(vecs, out, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                out[i] = magnitude(vecs[i]);
+#endif
         }
 
+        static void normalized(const TVec3f *vecs, TVec3f *out, size_t count) {
+#ifdef __powerpc__
+            Detail::psNormalizeArray(vecs, out, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                normalized(vecs[i], out[i]);
+#endif
+        }
+
+        static void dot(const TVec3f *a, const TVec3f *b, f32 *out, size_t count) {
+#ifdef __powerpc__
+            Detail::psDotArray(a, b, out, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                out[i] = dot(a[i], b[i]);
+#endif
+        }
+
+        static void angleBetween(const TVec3f *a, const TVec3f *b, f32 *out, size_t count) {
+#ifdef __powerpc__
+            Detail::psAngleBetweenArray(a, b, out, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                out[i] = angleBetween(a[i], b[i]);
+#endif
+        }
+
+        static void lookAtRatio(const TVec3f *a, const TVec3f *b, f32 *out, size_t count) {
+#ifdef __powerpc__
+            Detail::psLookAtRatioArray(a, b, out, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+                out[i] = lookAtRatio(a[i], b[i]);
+#endif
+        }
     };
 
 }  // namespace BetterSMS
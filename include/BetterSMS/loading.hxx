@@ -8,9 +8,22 @@
 
 namespace BetterSMS {
     namespace Loading {
+        typedef void (*PreloadCallback)(TMarDirector *);
+
+        enum Phase { PHASE_IDLE, PHASE_ARCHIVES, PHASE_PRELOAD, PHASE_OBJECTS, PHASE_COUNT };
+
         void setLoading(bool isLoading);
         void setLoadingIcon(const ResTIMG **textures, size_t texCount);
         void setLayout(J2DScreen *screen);
         void setFrameRate(f32 fps);
+
+        // Runs on the stage loading thread once the scene archive is mounted
+        bool addPreloadCallback(PreloadCallback cb);
+
+        // Progress shown on the loading screen, safe to call from the loading thread
+        Phase getPhase();
+        void addArchivesExpected(u32 count, u32 bytes);
+        // Bytes are counted as they are read from disc, the size is kept for compatibility
+        void reportArchiveLoaded(u32 bytes);
     }  // namespace Loading
 }  // namespace BetterSMS
\ No newline at end of file
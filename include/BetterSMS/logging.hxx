@@ -1,10 +1,43 @@
 #pragma once
 
+#include <Dolphin/types.h>
+
+// Log calls store the format string pointer, level, category, timestamp and
+// raw arguments in a ring and return; an idle priority thread does the
+// formatting and OSReport later, so logging from the game or audio thread no
+// longer stalls it. %s arguments are copied into the record since the string
+// may be gone by then. Records from a disabled category are dropped before
+// their arguments are even read.
+
 namespace BetterSMS {
     namespace Console {
+        enum Level : u8 { LEVEL_DEBUG, LEVEL_INFO, LEVEL_WARNING, LEVEL_ERROR };
+
+        // Modules may use any category from CATEGORY_USER up to CATEGORY_COUNT
+        enum Category : u8 {
+            CATEGORY_GENERAL,
+            CATEGORY_SETTINGS,
+            CATEGORY_AUDIO,
+            CATEGORY_STAGE,
+            CATEGORY_PLAYER,
+            CATEGORY_OBJECT,
+            CATEGORY_SUNSCRIPT,
+            CATEGORY_USER  = 8,
+            CATEGORY_COUNT = 32
+        };
+
         void log(const char *msg, ...);
         void hardwareLog(const char *msg, ...);
         void emulatorLog(const char *msg, ...);
         void debugLog(const char *msg, ...);
+
+        // Printed with a timestamp and category prefix, LEVEL_DEBUG only in debug mode
+        void record(Level level, Category category, const char *msg, ...);
+
+        bool isCategoryEnabled(Category category);
+        void setCategoryEnabled(Category category, bool enabled);
+
+        // Formats every pending record on the calling thread
+        void flush();
     }  // namespace Console
 }  // namespace BetterSMS
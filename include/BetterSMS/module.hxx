@@ -50,6 +50,10 @@
 #define BETTER_SMS_USE_PS_MATH 1
 #endif
 
+#ifndef BETTER_SMS_SETTINGS_CONTAINER
+#define BETTER_SMS_SETTINGS_CONTAINER 0
+#endif
+
 #define BETTER_SMS_FOR_CALLBACK SMS_NO_INLINE
 #define BETTER_SMS_FOR_EXPORT   SMS_NO_INLINE
 
@@ -143,7 +147,9 @@ namespace BetterSMS {
     bool isModuleRegistered(const char *key);
     bool registerModule(const ModuleInfo &info);
 
+    // Both only post to the save worker and return immediately
     bool triggerAutoSave();
+    void triggerSettingsSave(Settings::SettingsGroup &group);
 
     int getScreenRenderWidth();
     int getScreenOrthoWidth();
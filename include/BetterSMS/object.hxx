@@ -9,7 +9,7 @@ namespace BetterSMS {
         typedef JDrama::TNameRef *(*NameRefInitializer)();
         typedef void (*ObjectInteractor)(THitActor *object, TMario *player);
 
-        // Get how many more objects can be registered
+        // Get how many more objects can be registered (bounded only by memory)
         size_t getRemainingCapacity();
 
         // Register a map object initializer (coins, blocks, etc)
@@ -4,6 +4,8 @@
 
 #include "../module.hxx"
 
+struct GenericModelCacheEntry;
+
 class TGenericRailObj : public TRailMapObj {
 public:
     BETTER_SMS_FOR_CALLBACK static JDrama::TNameRef *instantiate() {
@@ -12,8 +14,10 @@ public:
 
     TGenericRailObj(const char *name)
         : TRailMapObj(name), mSoundID(-1), mSoundStrength(1.0f), mContactAnim(false),
-          mModelName(nullptr), mCurrentSound(nullptr) {}
-    ~TGenericRailObj() override {}
+          mModelName(nullptr), mCurrentSound(nullptr), mModelCache(nullptr),
+          mIsStaticModel(false), mIsDisplayListBuilt(false), mIsDisplayListLocked(false),
+          mLastPerformFrame(0), mLastEntryFrame(0) {}
+    ~TGenericRailObj() override;
 
     void perform(u32 flags, JDrama::TGraphics *graphics) override;
     void load(JSUMemoryInputStream &in) override;
@@ -30,6 +34,8 @@ public:
     bool checkMarioRiding();
     void playAnimations(s8 state);
     void stopAnimations();
+    bool checkStaticModel() const;
+    void entryModel(JDrama::TGraphics *graphics);
 
     const char *mModelName;
     u8 mContactAnim;
@@ -46,6 +52,12 @@ public:
     u32 mSoundCounter;
     JAISound *mCurrentSound;
     bool mIsContactAnimPlayed;
+    GenericModelCacheEntry *mModelCache;
+    bool mIsStaticModel;
+    bool mIsDisplayListBuilt;
+    bool mIsDisplayListLocked;
+    u32 mLastPerformFrame;  // Last frame this instance's own draw pass ran
+    u32 mLastEntryFrame;    // Last frame its model was entered, by itself or a sibling
 };
 
 extern ObjData generic_railobj_data;
\ No newline at end of file
@@ -19,7 +19,7 @@ public:
     TParticleBox(const char *name)
         : TActor(name), mID(-1), mSpawnRate(10), mSpawnScale(1.0f), mShape(BoundingType::Box),
           mIsStrict(false), mSpawnTimer(), mDistanceToNext(0), mPathDistance(0), mPrevScale(1.0f),
-          mNextScale(1.0f), mCurScale(1.0f), mIsMoving(true) {}
+          mNextScale(1.0f), mCurScale(1.0f), mIsMoving(true), mIsSpawnQueued(false) {}
     virtual ~TParticleBox() override {}
 
     void load(JSUMemoryInputStream &in) override;
@@ -31,7 +31,9 @@ private:
     bool moveToNextNode(f32 speed);
     void readRailFlag();
 
-    TVec3f getRandomParticlePosition(const BoundingBox &bb) const;
+    static void emitQueued(JDrama::TActor *owner);
+
+    TVec3f getRandomParticlePosition(const CachedBoundingBox &bb) const;
 
     // Bin parameters
     const char *mParticleName;
@@ -42,6 +44,7 @@ private:
     bool mIsStrict;
 
     // Game state
+    CachedBoundingBox mBounds;
     const char *mGraphName;
     TGraphTracer *mGraphTracer;
     s32 mDistanceToNext;
@@ -53,4 +56,5 @@ private:
     bool mIsMoving;
 
     s32 mSpawnTimer;
+    bool mIsSpawnQueued;
 };
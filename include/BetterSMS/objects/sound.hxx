@@ -18,14 +18,16 @@ public:
 
     TSoundBox(const char *name)
         : TActor(name), mID(-1), mVolume(1.0f), mPitch(1.0f), mSpawnRate(1),
-          mShape(BoundingType::Box), mSpawnTimer(), mSoundPos() {}
+          mShape(BoundingType::Box), mSpawnTimer(), mSoundPos(), mIsSpawnQueued(false) {}
     virtual ~TSoundBox() override {}
 
     void load(JSUMemoryInputStream &in) override;
     void perform(u32 flags, JDrama::TGraphics *) override;
 
 private:
-    TVec3f getRandomParticlePosition(const BoundingBox &bb) const;
+    TVec3f getRandomParticlePosition(const CachedBoundingBox &bb) const;
+
+    static void emitQueued(JDrama::TActor *owner);
 
     // Bin parameters
     s32 mID;
@@ -35,6 +37,8 @@ private:
     BoundingType mShape;
 
     // Game state
+    CachedBoundingBox mBounds;
     s32 mSpawnTimer;
     TVec3f mSoundPos;
+    bool mIsSpawnQueued;
 };
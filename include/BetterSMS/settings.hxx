@@ -385,6 +385,12 @@ namespace BetterSMS {
         s32 loadSettingsGroup(SettingsGroup &group);
         bool saveAllSettings();
         bool loadAllSettings();
+
+        // Settings are loaded on a background thread at boot. Code that reads a
+        // group before the game boot callbacks run must wait for it first. The
+        // value changed callbacks of loaded settings run on the waiting thread.
+        void waitForSettingsGroup(const SettingsGroup &group);
+        void waitForAllSettings();
 #pragma endregion
     }  // namespace Settings
 }  // namespace BetterSMS
\ No newline at end of file
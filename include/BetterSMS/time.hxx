@@ -1,12 +1,16 @@
 #pragma once
 
 #include <Dolphin/OS.h>
+#include <Dolphin/types.h>
 
 namespace BetterSMS {
     namespace Time {
         const char *buildDate();
         const char *buildTime();
         OSTime ostime();
+        // Seconds since boot and since the previous frame, sampled once per game loop
+        f64 frameSeconds();
+        f32 frameDelta();
         void getCalendar(OSCalendarTime &result);
         void calendarToDate(char *dst, const OSCalendarTime &calendar);
         void calendarToTime(char *dst, const OSCalendarTime &calendar);
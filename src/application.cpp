@@ -176,6 +176,11 @@ void BetterApplicationProcess(TApplication *app) {
     bool exitLoop   = false;
     u8 delayContext = 1;
     do {
+        // The boot contexts don't read settings, so the card load overlaps them
+        if (app->mContext != TApplication::CONTEXT_GAME_BOOT_LOGO &&
+            app->mContext != TApplication::CONTEXT_GAME_BOOT)
+            waitForCoreSettings();
+
         Application::ContextCallback cb = sContextCBs[app->mContext];
         SMS_ASSERT(cb, "Application attempted to fetch context handler %u but it wasn't found!",
                    app->mContext);
@@ -212,6 +217,8 @@ void BetterApplicationProcess(TApplication *app) {
         } else if (app->mContext == TApplication::CONTEXT_GAME_BOOT) {
             app->mNextScene.set(sIntroArea, sIntroEpisode, 0);
             if (!SMS_CHECK_RESET_FLAG(app->mGamePads[0])) {
+                // Module callbacks are the first consumers of their settings
+                Settings::waitForAllSettings();
                 gameInitCallbackHandler(app);
                 app->initialize_bootAfter();
                 gameBootCallbackHandler(app);
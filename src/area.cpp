@@ -3,6 +3,7 @@
 #include <SMS/Manager/FlagManager.hxx>
 #include <SMS/raw_fn.hxx>
 
+#include "memory.hxx"
 #include "module.hxx"
 #include "p_area.hxx"
 
@@ -18,12 +19,92 @@ namespace BetterSMS {
         static NormalAreaInfo sNormalAreaInfos[BETTER_SMS_AREA_MAX];
         static ExAreaInfo sExAreaInfos[BETTER_SMS_EXAREA_MAX];
 
+        static FrozenShineArea sFrozenShineAreas[BETTER_SMS_AREA_MAX];
+        static ScenarioEntry *sFrozenScenarioTable = nullptr;
+        static bool sIsAreaTableFrozen             = false;
+
         static NextStageCallback sNextStageHandler = moveStage_override;
 
         ShineAreaInfo **getShineAreaInfos() { return sShineAreaInfos; }
         NormalAreaInfo *getNormalAreaInfos() { return sNormalAreaInfos; }
         ExAreaInfo *getExAreaInfos() { return sExAreaInfos; }
 
+        // Packs every registered ShineAreaInfo into one scenario table so
+        // runtime lookups by (stage, scenario) are a single index
+        void freezeShineAreaInfos() {
+            size_t entryCount = 0;
+            for (size_t i = 0; i < BETTER_SMS_AREA_MAX; ++i) {
+                const ShineAreaInfo *info = sShineAreaInfos[i];
+                if (!info) {
+                    continue;
+                }
+                entryCount += info->getScenarioIDs().size() + info->getExScenarioIDs().size();
+            }
+
+            if (sFrozenScenarioTable) {
+                Memory::free(sFrozenScenarioTable);
+            }
+
+            // Always allocate at least one entry so registered areas have a valid base pointer
+            sFrozenScenarioTable = static_cast<ScenarioEntry *>(Memory::hmalloc(
+                JKRHeap::sRootHeap, sizeof(ScenarioEntry) * (entryCount > 0 ? entryCount : 1), 4));
+
+            ScenarioEntry *cursor = sFrozenScenarioTable;
+            for (size_t i = 0; i < BETTER_SMS_AREA_MAX; ++i) {
+                FrozenShineArea &area     = sFrozenShineAreas[i];
+                const ShineAreaInfo *info = sShineAreaInfos[i];
+                if (!info) {
+                    area = {nullptr, 0, 0, 0};
+                    continue;
+                }
+
+                const TGlobalVector<s32> &scenarioIDs       = info->getScenarioIDs();
+                const TGlobalVector<s32> &scenarioNameIDs   = info->getScenarioNameIDs();
+                const TGlobalVector<s32> &exScenarioIDs     = info->getExScenarioIDs();
+                const TGlobalVector<s32> &exScenarioNameIDs = info->getExScenarioNameIDs();
+
+                area.mScenarios         = cursor;
+                area.mShineSelectPaneID = info->getShineSelectPaneID();
+                area.mScenarioCount     = scenarioIDs.size();
+                area.mExScenarioCount   = exScenarioIDs.size();
+
+                for (size_t j = 0; j < scenarioIDs.size(); ++j) {
+                    s32 nameID = j < scenarioNameIDs.size() ? scenarioNameIDs[j] : -1;
+                    *cursor++  = {scenarioIDs[j], nameID};
+                }
+
+                for (size_t j = 0; j < exScenarioIDs.size(); ++j) {
+                    s32 nameID = j < exScenarioNameIDs.size() ? exScenarioNameIDs[j] : -1;
+                    *cursor++  = {exScenarioIDs[j], nameID};
+                }
+            }
+
+            sIsAreaTableFrozen = true;
+        }
+
+        const FrozenShineArea &getFrozenShineArea(u32 shineStageID) {
+            static const FrozenShineArea sEmptyArea = {nullptr, 0, 0, 0};
+
+            if (shineStageID >= BETTER_SMS_AREA_MAX) {
+                return sEmptyArea;
+            }
+
+            // Registrations thaw the table and scenarios are only ever appended,
+            // so a count that differs from the info means it was added to since
+            const ShineAreaInfo *info = sShineAreaInfos[shineStageID];
+            if (sIsAreaTableFrozen && info) {
+                const FrozenShineArea &area = sFrozenShineAreas[shineStageID];
+                sIsAreaTableFrozen = area.mScenarioCount == info->getScenarioIDs().size() &&
+                                     area.mExScenarioCount == info->getExScenarioIDs().size();
+            }
+
+            if (!sIsAreaTableFrozen) {
+                freezeShineAreaInfos();
+            }
+
+            return sFrozenShineAreas[shineStageID];
+        }
+
     }  // namespace Stage
 
 }  // namespace BetterSMS
@@ -108,6 +189,7 @@ bool BetterSMS::Stage::registerShineStage(ShineAreaInfo *info) {
     if (sShineAreaInfos[info->getShineStageID()]) {
         OSReport("[WARN] Overwriting stage info for stage %d\n", info->getShineStageID());
     }
+    sIsAreaTableFrozen = false;
     sShineAreaInfos[info->getShineStageID()] = info;
     return true;
 }
@@ -139,23 +221,14 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x8029933C, 0, 0, 0), moveStageHandler);
 SMS_PATCH_BL(SMS_PORT_REGION(0x8029946C, 0, 0, 0), moveStageHandler);
 
 static s32 SMS_getShineID(u32 stageID, u32 scenarioID, bool isExStage) {
-    if (!sShineAreaInfos[stageID]) {
+    const FrozenShineArea &area = getFrozenShineArea(stageID);
+
+    const ScenarioEntry *entry =
+        isExStage ? area.getExScenario(scenarioID) : area.getScenario(scenarioID);
+    if (!entry) {
         return -1;
     }
-    const ShineAreaInfo &info = *sShineAreaInfos[stageID];
-    if (isExStage) {
-        const TGlobalVector<s32> &exScenarioIDs = info.getExScenarioIDs();
-        if (scenarioID >= exScenarioIDs.size()) {
-            return -1;
-        }
-        return exScenarioIDs[scenarioID];
-    } else {
-        const TGlobalVector<s32> &scenarioIDs = info.getScenarioIDs();
-        if (scenarioID >= scenarioIDs.size()) {
-            return -1;
-        }
-        return scenarioIDs[scenarioID];
-    }
+    return entry->mScenarioID;
 }
 SMS_PATCH_B(SMS_PORT_REGION(0x8016FAC0, 0, 0, 0), SMS_getShineID);
 SMS_PATCH_B(SMS_PORT_REGION(0x80175AF8, 0, 0, 0), SMS_getShineID);
@@ -175,12 +248,13 @@ static TExPane *constructExPaneForSelectScreen(TExPane *pane, J2DScreen *screen)
     TSelectMenu *menu;
     SMS_FROM_GPR(31, menu);
 
+    const FrozenShineArea &area = getFrozenShineArea(SMS_getShineStage(menu->mAreaID));
+
     // This check is only necessary once
-    SMS_ASSERT(sShineAreaInfos[SMS_getShineStage(menu->mAreaID)]->getShineSelectPaneID() != 0,
+    SMS_ASSERT(area.mShineSelectPaneID != 0,
                "Tried to open shine select screen for an area that has no pane ID!");
 
-    return (TExPane *)__ct__7TExPaneFP9J2DScreenUl(
-        pane, screen, sShineAreaInfos[SMS_getShineStage(menu->mAreaID)]->getShineSelectPaneID());
+    return (TExPane *)__ct__7TExPaneFP9J2DScreenUl(pane, screen, area.mShineSelectPaneID);
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x80174D40, 0, 0, 0), constructExPaneForSelectScreen);
 
@@ -189,7 +263,7 @@ static TBoundPane *constructBoundPaneForSelectScreenA(TBoundPane *pane, J2DScree
     SMS_FROM_GPR(31, menu);
 
     u32 paneID =
-        (sShineAreaInfos[SMS_getShineStage(menu->mAreaID)]->getShineSelectPaneID() & 0xFFFFFF00) |
+        (getFrozenShineArea(SMS_getShineStage(menu->mAreaID)).mShineSelectPaneID & 0xFFFFFF00) |
         'a';
 
     return (TBoundPane *)__ct__10TBoundPaneFP9J2DScreenUl(pane, screen, paneID);
@@ -201,7 +275,7 @@ static TBoundPane *constructBoundPaneForSelectScreenB(TBoundPane *pane, J2DScree
     SMS_FROM_GPR(31, menu);
 
     u32 paneID =
-        (sShineAreaInfos[SMS_getShineStage(menu->mAreaID)]->getShineSelectPaneID() & 0xFFFFFF00) |
+        (getFrozenShineArea(SMS_getShineStage(menu->mAreaID)).mShineSelectPaneID & 0xFFFFFF00) |
         'b';
 
     return (TBoundPane *)__ct__10TBoundPaneFP9J2DScreenUl(pane, screen, paneID);
@@ -245,13 +319,12 @@ static void clampSelectScreenEpisodesVisible() {
     TSelectMenu *menu;
     SMS_FROM_GPR(31, menu);
 
-    ShineAreaInfo *info = sShineAreaInfos[SMS_getShineStage(menu->mAreaID)];
-    if (!info) {
+    const FrozenShineArea &area = getFrozenShineArea(SMS_getShineStage(menu->mAreaID));
+    if (!area.isValid()) {
         return;
     }
 
-    const TGlobalVector<s32> &scenarioIDs = info->getScenarioIDs();
-    menu->mEpisodeCount                   = Min(menu->mEpisodeCount, scenarioIDs.size());
+    menu->mEpisodeCount = Min(menu->mEpisodeCount, area.getScenarioCount());
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x80174E8C, 0, 0, 0), clampSelectScreenEpisodesVisible);
 SMS_WRITE_32(SMS_PORT_REGION(0x80174E90, 0, 0, 0), 0x60000000);
@@ -263,17 +336,14 @@ static const char *getScenarioNameForSelectScreen() {
     TSelectMenu *menu;
     SMS_FROM_GPR(31, menu);
 
-    ShineAreaInfo *info = sShineAreaInfos[SMS_getShineStage(menu->mAreaID)];
-    if (!info) {
-        return MESSAGE_NO_DATA;
-    }
+    const FrozenShineArea &area = getFrozenShineArea(SMS_getShineStage(menu->mAreaID));
 
-    const TGlobalVector<s32> &scenarioNameIDs = info->getScenarioNameIDs();
-    if (menu->mEpisodeID >= scenarioNameIDs.size()) {
+    const ScenarioEntry *entry = area.getScenario(menu->mEpisodeID);
+    if (!entry) {
         return MESSAGE_NO_DATA;
     }
 
-    s32 message_idx = scenarioNameIDs[menu->mEpisodeID];
+    s32 message_idx = entry->mScenarioNameID;
     if (message_idx == -1) {
         return MESSAGE_NO_DATA;
     }
@@ -307,19 +377,18 @@ static const char *loadScenarioNameFromBMG(void *global_bmg) {
 
     const char *errMessage = BetterSMS::isDebugMode() ? MESSAGE_NO_DATA : nullptr;
 
-    ShineAreaInfo *info = sShineAreaInfos[SMS_getShineStage(gpMarDirector->mAreaID)];
-    if (!info) {
+    const FrozenShineArea &area = getFrozenShineArea(SMS_getShineStage(gpMarDirector->mAreaID));
+    if (!area.isValid()) {
         return errMessage;
     }
 
-    const TGlobalVector<s32> &scenarioNameIDs = info->getScenarioNameIDs();
-
-    s32 episode_id = TFlagManager::smInstance->getFlag(0x40003);
-    if (episode_id >= scenarioNameIDs.size()) {
+    s32 episode_id             = TFlagManager::smInstance->getFlag(0x40003);
+    const ScenarioEntry *entry = area.getScenario(episode_id);
+    if (!entry) {
         return errMessage;
     }
 
-    s32 message_idx = scenarioNameIDs[episode_id];
+    s32 message_idx = entry->mScenarioNameID;
     if (message_idx == -1) {
         return MESSAGE_NO_DATA;
     }
@@ -335,19 +404,18 @@ static const char *loadScenarioNameFromBMGAfter(void *global_bmg) {
 
     const char *errMessage = BetterSMS::isDebugMode() ? MESSAGE_NO_DATA : nullptr;
 
-    ShineAreaInfo *info = sShineAreaInfos[SMS_getShineStage(gpMarDirector->mAreaID)];
-    if (!info) {
+    const FrozenShineArea &area = getFrozenShineArea(SMS_getShineStage(gpMarDirector->mAreaID));
+    if (!area.isValid()) {
         return errMessage;
     }
 
-    const TGlobalVector<s32> &scenarioNameIDs = info->getScenarioNameIDs();
-
-    s32 episode_id = TFlagManager::smInstance->getFlag(0x40003);
-    if (episode_id >= scenarioNameIDs.size()) {
+    s32 episode_id             = TFlagManager::smInstance->getFlag(0x40003);
+    const ScenarioEntry *entry = area.getScenario(episode_id);
+    if (!entry) {
         return errMessage;
     }
 
-    s32 message_idx = scenarioNameIDs[episode_id];
+    s32 message_idx = entry->mScenarioNameID;
     if (message_idx == -1) {
         return MESSAGE_NO_DATA;
     }
@@ -0,0 +1,430 @@
+    .text
+    .file "geometry.s"
+
+# Paired single loops behind the BetterSMS::Vector3 and Matrix array forms,
+# called through src/geometry.cpp. Vectors are loaded as (x, y) and (z, 1)
+# so three squares or products sum in one ps_madd and one ps_sum0. Roots
+# take two Newton steps off the estimate like the MEDIUM tier in
+# fastmath.hxx. Only f0-f13 are used, so no paired single state is saved.
+#
+# The assembler has no paired single mnemonics, so those are emitted by the
+# macros below. They take the operands in mnemonic order, with the psq_l
+# and psq_st displacement given before the base register.
+
+    .macro PS_A xo, frD, frA, frB, frC
+    .long (4 << 26) | (\frD << 21) | (\frA << 16) | (\frB << 11) | (\frC << 6) | (\xo << 1)
+    .endm
+
+    .macro PS_X xo, frD, frA, frB
+    .long (4 << 26) | (\frD << 21) | (\frA << 16) | (\frB << 11) | (\xo << 1)
+    .endm
+
+    .macro PSQ_L frD, d, rA, w, i
+    .long (56 << 26) | (\frD << 21) | (\rA << 16) | (\w << 15) | (\i << 12) | ((\d) & 0xFFF)
+    .endm
+
+    .macro PSQ_ST frS, d, rA, w, i
+    .long (60 << 26) | (\frS << 21) | (\rA << 16) | (\w << 15) | (\i << 12) | ((\d) & 0xFFF)
+    .endm
+
+    .macro PS_SUM0 frD, frA, frC, frB
+    PS_A 10, \frD, \frA, \frB, \frC
+    .endm
+    .macro PS_MULS0 frD, frA, frC
+    PS_A 12, \frD, \frA, 0, \frC
+    .endm
+    .macro PS_MADDS0 frD, frA, frC, frB
+    PS_A 14, \frD, \frA, \frB, \frC
+    .endm
+    .macro PS_ADD frD, frA, frB
+    PS_A 21, \frD, \frA, \frB, 0
+    .endm
+    .macro PS_SEL frD, frA, frC, frB
+    PS_A 23, \frD, \frA, \frB, \frC
+    .endm
+    .macro PS_MUL frD, frA, frC
+    PS_A 25, \frD, \frA, 0, \frC
+    .endm
+    .macro PS_RSQRTE frD, frB
+    PS_A 26, \frD, 0, \frB, 0
+    .endm
+    .macro PS_MADD frD, frA, frC, frB
+    PS_A 29, \frD, \frA, \frB, \frC
+    .endm
+    .macro PS_NMSUB frD, frA, frC, frB
+    PS_A 30, \frD, \frA, \frB, \frC
+    .endm
+    .macro PS_NEG frD, frB
+    PS_X 40, \frD, 0, \frB
+    .endm
+    .macro PS_MERGE00 frD, frA, frB
+    PS_X 528, \frD, \frA, \frB
+    .endm
+    .macro PS_MERGE10 frD, frA, frB
+    PS_X 592, \frD, \frA, \frB
+    .endm
+    .macro PS_MERGE11 frD, frA, frB
+    PS_X 624, \frD, \frA, \frB
+    .endm
+
+# One Newton step of 1 / sqrt(x) on ps0, y = y * 0.5 * (3 - x * y * y)
+    .macro RSQRT_STEP y, x, t0, t1, half, three
+    fmuls   \t0, \y, \y
+    fmuls   \t1, \y, \half
+    fnmsubs \t0, \t0, \x, \three
+    fmuls   \y, \t0, \t1
+    .endm
+
+# Both lanes at once, half and three must hold the constant in both lanes
+    .macro PS_RSQRT_STEP y, x, t0, t1, half, three
+    PS_MUL   \t0, \y, \y
+    PS_MUL   \t1, \y, \half
+    PS_NMSUB \t0, \t0, \x, \three
+    PS_MUL   \y, \t0, \t1
+    .endm
+
+# Every loop takes the constants table from src/geometry.cpp:
+# 0.5, 3.0, 0.0, 1.0, 0.999
+
+# void psMagnitudeLoop(const TVec3f *vecs, f32 *out, size_t count, const f32 *consts)
+    .globl psMagnitudeLoop
+    .p2align 2
+    .type psMagnitudeLoop,@function
+psMagnitudeLoop:
+    cmplwi  5, 0
+    beqlr
+    mtctr   5
+    lfs     10, 0(6)
+    lfs     11, 4(6)
+    lfs     12, 8(6)
+.Lmagnitude:
+    PSQ_L   2, 0, 3, 0, 0
+    PSQ_L   3, 8, 3, 1, 0
+    PS_MUL  4, 2, 2
+    PS_MADD 5, 3, 3, 4
+    PS_SUM0 5, 5, 3, 4
+    frsqrte 6, 5
+    RSQRT_STEP 6, 5, 7, 8, 10, 11
+    RSQRT_STEP 6, 5, 7, 8, 10, 11
+    fmuls   7, 5, 6
+    fneg    9, 5
+    fsel    7, 9, 12, 7
+    stfs    7, 0(4)
+    addi    3, 3, 12
+    addi    4, 4, 4
+    bdnz    .Lmagnitude
+    blr
+    .size psMagnitudeLoop, .-psMagnitudeLoop
+
+# void psNormalizeLoop(const TVec3f *vecs, TVec3f *out, size_t count, const f32 *consts)
+    .globl psNormalizeLoop
+    .p2align 2
+    .type psNormalizeLoop,@function
+psNormalizeLoop:
+    cmplwi  5, 0
+    beqlr
+    mtctr   5
+    lfs     10, 0(6)
+    lfs     11, 4(6)
+    lfs     12, 12(6)
+.Lnormalize:
+    PSQ_L   2, 0, 3, 0, 0
+    PSQ_L   3, 8, 3, 1, 0
+    PS_MUL  4, 2, 2
+    PS_MADD 5, 3, 3, 4
+    PS_SUM0 5, 5, 3, 4
+    frsqrte 6, 5
+    RSQRT_STEP 6, 5, 7, 8, 10, 11
+    RSQRT_STEP 6, 5, 7, 8, 10, 11
+    fneg    9, 5
+    fsel    6, 9, 12, 6
+    PS_MULS0 2, 2, 6
+    PS_MULS0 3, 3, 6
+    PSQ_ST  2, 0, 4, 0, 0
+    PSQ_ST  3, 8, 4, 1, 0
+    addi    3, 3, 12
+    addi    4, 4, 12
+    bdnz    .Lnormalize
+    blr
+    .size psNormalizeLoop, .-psNormalizeLoop
+
+# void psDotLoop(const TVec3f *a, const TVec3f *b, f32 *out, size_t count)
+    .globl psDotLoop
+    .p2align 2
+    .type psDotLoop,@function
+psDotLoop:
+    cmplwi  6, 0
+    beqlr
+    mtctr   6
+.Ldot:
+    PSQ_L   2, 4, 3, 0, 0
+    PSQ_L   3, 4, 4, 0, 0
+    PS_MUL  2, 2, 3
+    PSQ_L   4, 0, 3, 0, 0
+    PSQ_L   5, 0, 4, 0, 0
+    PS_MADD 3, 4, 5, 2
+    PS_SUM0 1, 3, 2, 2
+    stfs    1, 0(5)
+    addi    3, 3, 12
+    addi    4, 4, 12
+    addi    5, 5, 4
+    bdnz    .Ldot
+    blr
+    .size psDotLoop, .-psDotLoop
+
+# void psAngleBetweenLoop(const TVec3f *a, const TVec3f *b, f32 *out, size_t count,
+#                         const f32 *consts)
+    .globl psAngleBetweenLoop
+    .p2align 2
+    .type psAngleBetweenLoop,@function
+psAngleBetweenLoop:
+    cmplwi  6, 0
+    beqlr
+    mtctr   6
+    lfs     10, 0(7)
+    lfs     11, 4(7)
+    lfs     12, 8(7)
+.LangleBetween:
+    PSQ_L   2, 0, 3, 0, 0
+    PSQ_L   3, 8, 3, 1, 0
+    PSQ_L   4, 0, 4, 0, 0
+    PSQ_L   5, 8, 4, 1, 0
+    PS_MUL  6, 2, 2
+    PS_MADD 7, 3, 3, 6
+    PS_SUM0 7, 7, 3, 6
+    PS_MUL  6, 4, 4
+    PS_MADD 8, 5, 5, 6
+    PS_SUM0 8, 8, 5, 6
+    PS_MUL  6, 2, 4
+    PS_MADD 9, 3, 5, 6
+    PS_SUM0 9, 9, 3, 6
+    fmuls   7, 7, 8
+    frsqrte 6, 7
+    RSQRT_STEP 6, 7, 8, 13, 10, 11
+    RSQRT_STEP 6, 7, 8, 13, 10, 11
+    fmuls   6, 9, 6
+    fneg    8, 7
+    fsel    6, 8, 12, 6
+    stfs    6, 0(5)
+    addi    3, 3, 12
+    addi    4, 4, 12
+    addi    5, 5, 4
+    bdnz    .LangleBetween
+    blr
+    .size psAngleBetweenLoop, .-psAngleBetweenLoop
+
+# void psLookAtLoop(const TVec3f *a, const TVec3f *b, f32 *out, size_t count)
+#
+# Writes the planar cross and dot of each pair, the two atan2 arguments of
+# Vector3::lookAtRatio, as out[2 * i] and out[2 * i + 1]
+    .globl psLookAtLoop
+    .p2align 2
+    .type psLookAtLoop,@function
+psLookAtLoop:
+    cmplwi  6, 0
+    beqlr
+    mtctr   6
+.LlookAt:
+    PSQ_L   1, 0, 3, 0, 0
+    lfs     2, 8(3)
+    PSQ_L   3, 0, 4, 0, 0
+    lfs     4, 8(4)
+    PS_MERGE00 5, 1, 2
+    PS_MERGE00 6, 4, 3
+    PS_MUL  7, 5, 6
+    PS_MERGE10 8, 5, 5
+    PS_MUL  8, 8, 6
+    PS_NEG  9, 8
+    PS_MERGE00 0, 7, 8
+    PS_MERGE11 9, 7, 9
+    PS_ADD  0, 0, 9
+    PSQ_ST  0, 0, 5, 0, 0
+    addi    3, 3, 12
+    addi    4, 4, 12
+    addi    5, 5, 8
+    bdnz    .LlookAt
+    blr
+    .size psLookAtLoop, .-psLookAtLoop
+
+# void psNormalToRotationLoop(const TVec3f *norms, const TVec3f *up, Mtx *out, size_t count,
+#                             const f32 *consts)
+#
+# Matrix::normalToRotation for each normal. With up null, each normal picks
+# its own the way normalToRotationU does.
+    .globl psNormalToRotationLoop
+    .p2align 2
+    .type psNormalToRotationLoop,@function
+psNormalToRotationLoop:
+    cmplwi  6, 0
+    beqlr
+    mtctr   6
+    lfs     10, 0(7)
+    lfs     11, 4(7)
+    lfs     12, 8(7)
+    lfs     13, 12(7)
+    cmplwi  4, 0
+    beq     .LnormalToRotation
+    PSQ_L   8, 0, 4, 0, 0
+    PSQ_L   9, 8, 4, 1, 0
+.LnormalToRotation:
+    # forward = normalize(norm), as (f1, f2)
+    PSQ_L   1, 0, 3, 0, 0
+    PSQ_L   2, 8, 3, 1, 0
+    PS_MUL  3, 1, 1
+    PS_MADD 4, 2, 2, 3
+    PS_SUM0 4, 4, 2, 3
+    frsqrte 5, 4
+    RSQRT_STEP 5, 4, 6, 7, 10, 11
+    RSQRT_STEP 5, 4, 6, 7, 10, 11
+    PS_MULS0 1, 1, 5
+    PS_MULS0 2, 2, 5
+    cmplwi  4, 0
+    bne     .LnormalToRotationCross
+    # up = |forward.y| < 0.999 ? (0, 1, 0) : (0, 0, 1), as (f8, f9)
+    PS_MERGE11 3, 1, 1
+    fabs    3, 3
+    lfs     4, 16(7)
+    fsubs   3, 3, 4
+    fsel    4, 3, 12, 13
+    fsel    5, 3, 13, 12
+    PS_MERGE00 8, 12, 4
+    PS_MERGE00 9, 5, 12
+.LnormalToRotationCross:
+    # right = normalize(up x forward), as (f3, f4)
+    PS_MERGE10 3, 8, 9
+    PS_MERGE00 4, 2, 1
+    PS_MUL  3, 3, 4
+    PS_MERGE00 4, 9, 8
+    PS_MERGE10 5, 1, 2
+    PS_NMSUB 3, 4, 5, 3
+    PS_MERGE10 4, 1, 1
+    PS_MUL  4, 8, 4
+    PS_MERGE10 5, 4, 4
+    fsubs   4, 4, 5
+    PS_MUL  5, 3, 3
+    PS_SUM0 5, 5, 5, 5
+    fmadds  5, 4, 4, 5
+    frsqrte 6, 5
+    RSQRT_STEP 6, 5, 7, 0, 10, 11
+    RSQRT_STEP 6, 5, 7, 0, 10, 11
+    PS_MULS0 3, 3, 6
+    fmuls   4, 4, 6
+    # localup = forward x right, as (f5, f6)
+    PS_MERGE10 5, 1, 2
+    PS_MERGE00 6, 4, 3
+    PS_MUL  5, 5, 6
+    PS_MERGE00 6, 2, 1
+    PS_MERGE10 7, 3, 4
+    PS_NMSUB 5, 6, 7, 5
+    PS_MERGE10 6, 3, 3
+    PS_MUL  6, 1, 6
+    PS_MERGE10 7, 6, 6
+    fsubs   6, 6, 7
+    # Rows right, localup and forward, each with a zero translation
+    PSQ_ST  3, 0, 5, 0, 0
+    PS_MERGE00 4, 4, 12
+    PSQ_ST  4, 8, 5, 0, 0
+    PSQ_ST  5, 16, 5, 0, 0
+    PS_MERGE00 6, 6, 12
+    PSQ_ST  6, 24, 5, 0, 0
+    PSQ_ST  1, 32, 5, 0, 0
+    PS_MERGE00 2, 2, 12
+    PSQ_ST  2, 40, 5, 0, 0
+    addi    3, 3, 12
+    addi    5, 5, 48
+    bdnz    .LnormalToRotation
+    blr
+    .size psNormalToRotationLoop, .-psNormalToRotationLoop
+
+# void psDecomposeLoop(const Mtx *mtx, TVec3f *translation, TVec3f *scale, f32 *terms,
+#                      size_t count, const f32 *consts)
+#
+# The part of Matrix::decompose before the trig. Scales are signed by the
+# determinant and zero for a zero column. terms gets six unscaled rotation
+# entries per matrix: r10, r11, r20, r21, r00, r22.
+    .globl psDecomposeLoop
+    .p2align 2
+    .type psDecomposeLoop,@function
+psDecomposeLoop:
+    cmplwi  7, 0
+    beqlr
+    mtctr   7
+    lfs     10, 0(8)
+    lfs     11, 4(8)
+    lfs     12, 8(8)
+    lfs     13, 12(8)
+    PS_MERGE00 10, 10, 10
+    PS_MERGE00 11, 11, 11
+    PS_MERGE00 12, 12, 12
+.Ldecompose:
+    lfs     0, 12(3)
+    stfs    0, 0(4)
+    lfs     0, 28(3)
+    stfs    0, 4(4)
+    lfs     0, 44(3)
+    stfs    0, 8(4)
+    # Rows as (m00, m01), (m10, m11), (m20, m21)
+    PSQ_L   1, 0, 3, 0, 0
+    PSQ_L   2, 16, 3, 0, 0
+    PSQ_L   3, 32, 3, 0, 0
+    lfs     5, 24(3)
+    lfs     6, 40(3)
+    # (m10 * m22 - m20 * m12, m11 * m22 - m21 * m12), the cofactors of m01 and m00
+    PS_MULS0 4, 2, 6
+    fneg    7, 5
+    PS_MADDS0 4, 3, 7, 4
+    PS_MERGE10 4, 4, 4
+    PS_MUL  4, 1, 4
+    PS_MERGE10 7, 4, 4
+    fsubs   4, 4, 7
+    # m10 * m21 - m11 * m20
+    PS_MERGE10 7, 3, 3
+    PS_MUL  7, 2, 7
+    PS_MERGE10 8, 7, 7
+    fsubs   7, 7, 8
+    lfs     8, 8(3)
+    fmadds  4, 8, 7, 4
+    # f9 = det < 0 ? -1 : 1
+    fneg    9, 13
+    fsel    9, 4, 13, 9
+    # Squared column lengths, (x, y) in f4 and z in f7
+    PS_MUL  4, 1, 1
+    PS_MADD 4, 2, 2, 4
+    PS_MADD 4, 3, 3, 4
+    fmuls   7, 8, 8
+    fmadds  7, 5, 5, 7
+    fmadds  7, 6, 6, 7
+    # Signed inverse lengths, (x, y) in f5 and z in f8, zero for a zero column
+    PS_RSQRTE 5, 4
+    PS_RSQRT_STEP 5, 4, 0, 8, 10, 11
+    PS_RSQRT_STEP 5, 4, 0, 8, 10, 11
+    PS_NEG  0, 4
+    PS_SEL  5, 0, 12, 5
+    PS_MULS0 5, 5, 9
+    frsqrte 8, 7
+    RSQRT_STEP 8, 7, 0, 13, 10, 11
+    RSQRT_STEP 8, 7, 0, 13, 10, 11
+    lfs     13, 12(8)
+    fneg    0, 7
+    fsel    8, 0, 12, 8
+    fmuls   8, 8, 9
+    PS_MUL  4, 4, 5
+    PSQ_ST  4, 0, 5, 0, 0
+    fmuls   7, 7, 8
+    stfs    7, 8(5)
+    # Rotation terms
+    PS_MUL  2, 2, 5
+    PSQ_ST  2, 0, 6, 0, 0
+    PS_MUL  3, 3, 5
+    PSQ_ST  3, 8, 6, 0, 0
+    PS_MUL  1, 1, 5
+    fmuls   6, 6, 8
+    PS_MERGE00 1, 1, 6
+    PSQ_ST  1, 16, 6, 0, 0
+    addi    3, 3, 48
+    addi    4, 4, 12
+    addi    5, 5, 12
+    addi    6, 6, 24
+    bdnz    .Ldecompose
+    blr
+    .size psDecomposeLoop, .-psDecomposeLoop
@@ -1,36 +1,241 @@
 #include <Dolphin/CARD.h>
 
+#include "logging.hxx"
 #include "module.hxx"
 #include "p_autosave.hxx"
+#include "p_quadbatch.hxx"
 #include "p_settings.hxx"
 
 extern SavePromptsSetting gSavePromptSetting;
 
+// Saves are handled by one persistent worker. The game thread only posts a
+// request to the mailbox; the worker folds every request that arrived while
+// it was busy into a single write, and retries on a timer while the card is
+// busy. Requests are either one of the kinds below or a settings group.
+
+enum AutoSaveRequest {
+    AUTOSAVE_REQUEST_RETRY,  // Wakes the worker to retry what is pending
+    AUTOSAVE_REQUEST_GAME,   // Game progress, options and every settings group
+    AUTOSAVE_REQUEST_MENU,   // Options and every settings group, result goes to the menu
+};
+
+constexpr size_t AutoSaveMailboxSize   = 16;
+constexpr size_t AutoSaveMaxDirty      = 32;
+constexpr OSPriority AutoSavePriority  = OSPriority(24);
+constexpr OSTime AutoSaveRetryInterval = 500;  // 500ms
+
 static bool gIsAutoSaveActive = false;
 
 static u8 SMS_ALIGN(32) gSaveThreadStack[0x4000];
 static OSThread gSaveThread;
+static OSMessageQueue sSaveMailbox;
+static OSMessage sSaveMessages[AutoSaveMailboxSize];
+static OSAlarm sRetryAlarm;
+static bool sIsWorkerRunning = false;
+
+// Set when a request could not be posted, so it is never dropped
+static volatile bool sIsGameOverflowed   = false;
+static volatile bool sIsGroupsOverflowed = false;
+static volatile bool sIsMenuOverflowed   = false;
+
+// Written by the worker, taken by the settings menu
+static volatile s32 sMenuSaveStatus = CARD_ERROR_READY;
+static volatile bool sIsMenuSaveDone = false;
+
+// Worker thread only
+static bool sIsGamePending = false;
+static bool sIsMenuPending = false;
+static Settings::SettingsGroup *sDirtyGroups[AutoSaveMaxDirty];
+static size_t sDirtyGroupCount = 0;
+static bool sIsAllGroupsDirty  = false;
+
+static void markGroupDirty(Settings::SettingsGroup *group) {
+    for (size_t i = 0; i < sDirtyGroupCount; ++i) {
+        if (sDirtyGroups[i] == group)
+            return;
+    }
+
+    if (sDirtyGroupCount == AutoSaveMaxDirty) {
+        sIsAllGroupsDirty = true;
+        return;
+    }
+
+    sDirtyGroups[sDirtyGroupCount++] = group;
+}
+
+static void collectRequest(OSMessage msg) {
+    const u32 request = reinterpret_cast<u32>(msg);
+    if (request == AUTOSAVE_REQUEST_GAME)
+        sIsGamePending = true;
+    else if (request == AUTOSAVE_REQUEST_MENU)
+        sIsMenuPending = true;
+    else if (request != AUTOSAVE_REQUEST_RETRY)
+        markGroupDirty(reinterpret_cast<Settings::SettingsGroup *>(msg));
+}
+
+static bool hasPendingSave() {
+    return sIsGamePending || sIsMenuPending || sIsAllGroupsDirty || sDirtyGroupCount > 0;
+}
+
+static void clearPendingSave() {
+    if (sIsMenuPending) {
+        sIsMenuPending  = false;
+        sIsMenuSaveDone = true;
+    }
+    sIsGamePending    = false;
+    sIsAllGroupsDirty = false;
+    sDirtyGroupCount  = 0;
+}
+
+static void cbForRetryAlarm(OSAlarm *alarm, OSContext *context) {
+    OSSendMessage(&sSaveMailbox, reinterpret_cast<OSMessage>(AUTOSAVE_REQUEST_RETRY),
+                  OS_MESSAGE_NOBLOCK);
+}
+
+static s32 saveDirtyGroups() {
+    gpCardManager->unmount();
+
+    s32 status = Settings::mountCard();
+    if (status >= CARD_ERROR_READY) {
+        if (sIsAllGroupsDirty) {
+            status = Settings::saveAllSettings() ? CARD_ERROR_READY : CARD_ERROR_IOERROR;
+        } else {
+            for (size_t i = 0; i < sDirtyGroupCount && status >= CARD_ERROR_READY; ++i) {
+                status = Settings::saveSettingsGroup(*sDirtyGroups[i]);
+            }
+        }
+        Settings::unmountCard();
+    }
+
+    gpCardManager->mount_(true);
+    return status;
+}
+
+static void writePendingSave() {
+    // The settings menu unmounts the game's card on entry
+    if (sIsMenuPending)
+        gpCardManager->mount_(true);
+
+    s32 status = CARDCheck(gpCardManager->mChannel);
+    if (status == CARD_ERROR_BUSY) {
+        // Someone else owns the card right now, keep everything pending. A
+        // retry may still be armed from a burst that arrived meanwhile.
+        OSCancelAlarm(&sRetryAlarm);
+        OSSetAlarm(&sRetryAlarm, OSMillisecondsToTicks(AutoSaveRetryInterval), cbForRetryAlarm);
+        return;
+    }
+
+    if (status != CARD_ERROR_READY && status != CARD_ERROR_NOCARD) {
+        // Fall back to the regular prompts so the player can still save by hand
+        if (sIsGamePending)
+            gSavePromptSetting.setInt(SavePromptsSetting::ALL);
+        sMenuSaveStatus = status;
+        clearPendingSave();
+        return;
+    }
+
+    gIsAutoSaveActive = true;
+
+    if (sIsGamePending) {
+        // Writes the options and every settings group as well
+        status = SaveAllSettings();
+        if (status != CARD_ERROR_READY) {
+            gSavePromptSetting.setInt(SavePromptsSetting::ALL);
+        }
+    } else {
+        if (sIsMenuPending) {
+            SaveOptionBlock();
+            sIsAllGroupsDirty = true;
+        }
 
-static void *saveAllThread(void *arg) {
-    if (SaveAllSettings() != CARD_ERROR_READY) {
-        gSavePromptSetting.setInt(SavePromptsSetting::ALL);
+        status = saveDirtyGroups();
+        if (status < CARD_ERROR_READY) {
+            Console::record(Console::LEVEL_ERROR, Console::CATEGORY_SETTINGS,
+                            "Autosave failed! (Status: %d)\n", status);
+        }
     }
+
+    sMenuSaveStatus = status;
+    clearPendingSave();
     gIsAutoSaveActive = false;
+}
+
+static void *saveWorkerMain(void *arg) {
+    OSMessage msg;
+    while (true) {
+        OSReceiveMessage(&sSaveMailbox, &msg, OS_MESSAGE_BLOCK);
+        collectRequest(msg);
+
+        // Fold the rest of the burst into this write
+        while (OSReceiveMessage(&sSaveMailbox, &msg, OS_MESSAGE_NOBLOCK)) {
+            collectRequest(msg);
+        }
+
+        if (sIsGameOverflowed) {
+            sIsGameOverflowed = false;
+            sIsGamePending    = true;
+        }
+
+        if (sIsGroupsOverflowed) {
+            sIsGroupsOverflowed = false;
+            sIsAllGroupsDirty   = true;
+        }
+
+        if (sIsMenuOverflowed) {
+            sIsMenuOverflowed = false;
+            sIsMenuPending    = true;
+        }
+
+        if (hasPendingSave())
+            writePendingSave();
+    }
     return nullptr;
 }
 
+BETTER_SMS_FOR_CALLBACK void initAutoSaveWorker(TApplication *app) {
+    OSInitMessageQueue(&sSaveMailbox, sSaveMessages, AutoSaveMailboxSize);
+    OSCreateAlarm(&sRetryAlarm);
+    OSCreateThread(&gSaveThread, saveWorkerMain, nullptr,
+                   gSaveThreadStack + sizeof(gSaveThreadStack), sizeof(gSaveThreadStack),
+                   AutoSavePriority, OS_THREAD_ATTR_DETACH);
+    OSResumeThread(&gSaveThread);
+    sIsWorkerRunning = true;
+
+    // Pick up anything requested before the worker existed
+    if (sIsGameOverflowed || sIsGroupsOverflowed || sIsMenuOverflowed)
+        OSSendMessage(&sSaveMailbox, reinterpret_cast<OSMessage>(AUTOSAVE_REQUEST_RETRY),
+                      OS_MESSAGE_NOBLOCK);
+}
+
+static bool postSaveRequest(OSMessage msg) {
+    return sIsWorkerRunning && OSSendMessage(&sSaveMailbox, msg, OS_MESSAGE_NOBLOCK);
+}
+
 BETTER_SMS_FOR_EXPORT bool BetterSMS::triggerAutoSave() {
-    if (gIsAutoSaveActive || gSavePromptSetting.getInt() != SavePromptsSetting::AUTO_SAVE)
+    if (gSavePromptSetting.getInt() != SavePromptsSetting::AUTO_SAVE)
         return false;
 
-    s32 status = CARDCheck(gpCardManager->mChannel);
-    if (status != CARD_ERROR_READY && status != CARD_ERROR_NOCARD)
-        return false;
+    if (!postSaveRequest(reinterpret_cast<OSMessage>(AUTOSAVE_REQUEST_GAME)))
+        sIsGameOverflowed = true;
+    return true;
+}
 
-    gIsAutoSaveActive = true;
-    OSCreateThread(&gSaveThread, saveAllThread, NULL, gSaveThreadStack + sizeof(gSaveThreadStack),
-                   sizeof(gSaveThreadStack), 17, 0);
-    OSResumeThread(&gSaveThread);
+BETTER_SMS_FOR_EXPORT void BetterSMS::triggerSettingsSave(Settings::SettingsGroup &group) {
+    if (!postSaveRequest(&group))
+        sIsGroupsOverflowed = true;
+}
+
+void requestMenuSave() {
+    sIsMenuSaveDone = false;
+    if (!postSaveRequest(reinterpret_cast<OSMessage>(AUTOSAVE_REQUEST_MENU)))
+        sIsMenuOverflowed = true;
+}
+
+bool takeMenuSaveResult(s32 &status) {
+    if (!sIsMenuSaveDone)
+        return false;
+    sIsMenuSaveDone = false;
+    status          = sMenuSaveStatus;
     return true;
 }
 
@@ -83,29 +288,17 @@ BETTER_SMS_FOR_CALLBACK void updateAutoSaveIcon(TApplication *app) {
         return;
     }
 
-    const int screenAdjustX = BetterSMS::getScreenRatioAdjustX();
-    sAutoSavePicture.mRect  = {400 + screenAdjustX, 420, 432 + screenAdjustX, 452};
-
     if (sAutoSaveAnimator.getCurrentFrame() == 8 || sAutoSaveAnimator.getCurrentFrame() == 15 ||
         sAutoSaveAnimator.getCurrentFrame() == 19) {
         sAutoSaveAnimator.setFrameRate(20.0f / 3.0f);
     } else {
         sAutoSaveAnimator.setFrameRate(20.0f);
     }
-}
-
-BETTER_SMS_FOR_CALLBACK void drawAutoSaveIcon(TApplication *app, const J2DOrthoGraph *ortho) {
-    if (!gIsAutoSaveActive)
-        return;
 
-    if (app->mContext != TApplication::CONTEXT_DIRECT_STAGE)
-        return;
+    // The picture only swaps the current frame into our texture, the quad
+    // itself is drawn with the rest of the overlay layer
+    sAutoSaveAnimator.process(&sAutoSavePicture);
 
     const int screenAdjustX = BetterSMS::getScreenRatioAdjustX();
-
-    ReInitializeGX();
-    const_cast<J2DOrthoGraph *>(ortho)->setup2D();
-
-    sAutoSaveAnimator.process(&sAutoSavePicture);
-    sAutoSavePicture.draw(460 + screenAdjustX, 420, 32, 32, false, false, false);
-}
\ No newline at end of file
+    getQuadBatch(QUAD_LAYER_OVERLAY).pushTexture(&texture, 460 + screenAdjustX, 420, 32, 32);
+}
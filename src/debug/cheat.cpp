@@ -20,6 +20,7 @@
 #include "raw_fn.hxx"
 
 #include "p_debug.hxx"
+#include "p_gptrace.hxx"
 #include <player.hxx>
 
 using namespace BetterSMS;
@@ -135,6 +136,17 @@ BETTER_SMS_FOR_CALLBACK void checkDebugMode(TMario *player, bool isMario) {
         gIsGameUIActive ^= true;
     }
 
+#if SMS_DEBUG
+    const bool shouldCaptureGPFrame =
+        BetterSMS::isDebugMode() && !gIsDebugActive &&
+        ButtonsFramePressed(player->mController, gControlCaptureGPFrame) &&
+        ButtonsPressed(player->mController, gSecondaryMask);
+
+    if (shouldCaptureGPFrame) {
+        requestGPCapture();
+    }
+#endif
+
     if (gIsGameUIActive) {
         PowerPC::writeU32((u32 *)0x80299CF0, 0x3880FFFF);
     } else {
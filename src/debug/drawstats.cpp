@@ -0,0 +1,86 @@
+#include <Dolphin/types.h>
+
+#include <JSystem/J2D/J2DOrthoGraph.hxx>
+#include <JSystem/J2D/J2DTextBox.hxx>
+#include <SMS/System/Application.hxx>
+
+#include "debug.hxx"
+#include "module.hxx"
+#include "objects/p_generic.hxx"
+#include "p_debug.hxx"
+#include "p_gptrace.hxx"
+#include "p_sunscript.hxx"
+
+using namespace BetterSMS;
+
+#if SMS_DEBUG
+static s16 gBaseMonitorX = 10, gBaseMonitorY = 406;
+#else
+static s16 gBaseMonitorX = 10, gBaseMonitorY = 428;
+#endif
+
+static J2DTextBox *gpDrawStatsStringW = nullptr;
+static J2DTextBox *gpDrawStatsStringB = nullptr;
+
+static char sStringBuffer[320];
+static bool sIsInitialized = false;
+
+BETTER_SMS_FOR_CALLBACK void initDrawStatsMonitor(TApplication *app) {
+    gpDrawStatsStringW                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpDrawStatsStringB                  = new J2DTextBox(gpSystemFont->mFont, "");
+    gpDrawStatsStringW->mStrPtr         = sStringBuffer;
+    gpDrawStatsStringB->mStrPtr         = sStringBuffer;
+    gpDrawStatsStringW->mNewlineSize    = 11;
+    gpDrawStatsStringW->mCharSizeX      = 11;
+    gpDrawStatsStringW->mCharSizeY      = 11;
+    gpDrawStatsStringB->mNewlineSize    = 11;
+    gpDrawStatsStringB->mCharSizeX      = 11;
+    gpDrawStatsStringB->mCharSizeY      = 11;
+    gpDrawStatsStringB->mGradientTop    = {0, 0, 0, 255};
+    gpDrawStatsStringB->mGradientBottom = {0, 0, 0, 255};
+    sIsInitialized                      = true;
+}
+
+BETTER_SMS_FOR_CALLBACK void updateDrawStatsMonitor(TApplication *app) {
+    if (!app->mDirector || !sIsInitialized || !BetterSMS::isDebugMode())
+        return;
+
+    const GenericDrawStats &stats = getGenericDrawStats();
+#if SMS_DEBUG
+    size_t length =
+        snprintf(sStringBuffer, sizeof(sStringBuffer),
+                 "Rail Draws: %lu DL / %lu Dyn / %lu Models / %lu Runs", stats.mCachedDraws,
+                 stats.mDynamicDraws, stats.mModels, stats.mRuns);
+
+    // Averaged GP bytes per frame, three zones a line
+    for (int i = 0; i < GP_ZONE_COUNT && length < sizeof(sStringBuffer); ++i) {
+        const GPTraceZone zone = static_cast<GPTraceZone>(i);
+        length += snprintf(sStringBuffer + length, sizeof(sStringBuffer) - length, "%s%s %luB",
+                           (i % 3) == 0 ? "\nGP: " : " / ", getGPZoneName(zone),
+                           getGPZoneStats(zone).mBytes);
+    }
+
+    const SpcBuiltinStats spcStats = getHottestSpcBuiltin();
+    if (spcStats.mName && length < sizeof(sStringBuffer))
+        snprintf(sStringBuffer + length, sizeof(sStringBuffer) - length,
+                 "\nSpc: %s %lu calls / %luus", spcStats.mName, spcStats.mCalls,
+                 spcStats.mMicros);
+#else
+    snprintf(sStringBuffer, 128, "Rail Draws: %lu DL / %lu Dyn / %lu Models / %lu Runs",
+             stats.mCachedDraws, stats.mDynamicDraws, stats.mModels, stats.mRuns);
+#endif
+}
+
+BETTER_SMS_FOR_CALLBACK void drawDrawStatsMonitor(TApplication *app, const J2DOrthoGraph *ortho) {
+    if (!sIsInitialized)
+        return;
+
+    if (gDebugUIPage == 0 || !BetterSMS::isDebugMode())
+        return;
+
+    {
+        auto monitorX = gBaseMonitorX - getScreenRatioAdjustX();
+        gpDrawStatsStringB->draw(monitorX + 1, gBaseMonitorY + 2);
+        gpDrawStatsStringW->draw(monitorX, gBaseMonitorY);
+    }
+}
@@ -3,7 +3,6 @@
 
 #include <JSystem/J2D/J2DOrthoGraph.hxx>
 #include <JSystem/J2D/J2DPane.hxx>
-#include <JSystem/J2D/J2DTextBox.hxx>
 #include <SMS/Enemy/EnemyMario.hxx>
 #include <SMS/MSound/MSound.hxx>
 #include <SMS/MSound/MSoundSESystem.hxx>
@@ -17,6 +16,7 @@
 #include "logging.hxx"
 #include "module.hxx"
 #include "p_debug.hxx"
+#include "p_quadbatch.hxx"
 #include "p_settings.hxx"
 
 using namespace BetterSMS;
@@ -27,26 +27,13 @@ static f32 sFPSTimer       = 0.0f;
 static f32 sFPSCounter     = 0.0f;
 static OSTime sFPSBaseTime = 0;
 
-static J2DTextBox *gpFPSStringW = nullptr;
-static J2DTextBox *gpFPSStringB = nullptr;
+static JUtility::TColor sFPSColor = {50, 220, 20, 255};
 
 static char sStringBuffer[10];
 static bool sIsInitialized = false;
 
 BETTER_SMS_FOR_CALLBACK void initFPSMonitor(TApplication *app) {
-    gpFPSStringW                  = new J2DTextBox(gpSystemFont->mFont, "");
-    gpFPSStringB                  = new J2DTextBox(gpSystemFont->mFont, "");
-    gpFPSStringW->mStrPtr         = sStringBuffer;
-    gpFPSStringB->mStrPtr         = sStringBuffer;
-    gpFPSStringW->mNewlineSize    = 17;
-    gpFPSStringW->mCharSizeX      = 14;
-    gpFPSStringW->mCharSizeY      = 17;
-    gpFPSStringB->mNewlineSize    = 17;
-    gpFPSStringB->mCharSizeX      = 14;
-    gpFPSStringB->mCharSizeY      = 17;
-    gpFPSStringB->mGradientTop    = {0, 0, 0, 255};
-    gpFPSStringB->mGradientBottom = {0, 0, 0, 255};
-    sIsInitialized                = true;
+    sIsInitialized = getSystemQuadFont().isValid();
 }
 
 extern FPSSetting gFPSSetting;
@@ -68,31 +55,28 @@ BETTER_SMS_FOR_CALLBACK void updateFPSMonitor(TApplication *app) {
         int thresholdMultiplier = gFPSSetting.getInt() + 1;
 
         if (fps < 24.0f * thresholdMultiplier) {
-            gpFPSStringW->mGradientTop    = {210, 60, 20, 255};
-            gpFPSStringW->mGradientBottom = {210, 60, 20, 255};
+            sFPSColor = {210, 60, 20, 255};
         } else if (fps < 29.97f * thresholdMultiplier) {
-            gpFPSStringW->mGradientTop    = {130, 170, 10, 255};
-            gpFPSStringW->mGradientBottom = {130, 170, 10, 255};
+            sFPSColor = {130, 170, 10, 255};
         } else {
-            gpFPSStringW->mGradientTop    = {50, 220, 20, 255};
-            gpFPSStringW->mGradientBottom = {50, 220, 20, 255};
+            sFPSColor = {50, 220, 20, 255};
         }
 
         sFPSCounter  = 0.0f;
         sFPSBaseTime = OSGetTime();
     }
-}
-
-BETTER_SMS_FOR_CALLBACK void drawFPSMonitor(TApplication *app, const J2DOrthoGraph *ortho) {
-    if (!sIsInitialized)
-        return;
 
-    if (gDebugUIPage == 0 || !BetterSMS::isDebugMode())
+    if (gDebugUIPage == 0)
         return;
 
+    // The shadow and the text share a glyph page, so both go out as one run
     {
+        const TQuadFont &font = getSystemQuadFont();
+        TQuadBatch &batch     = getQuadBatch(QUAD_LAYER_DEBUG);
+
         auto monitorX = gBaseMonitorX + getScreenRatioAdjustX();
-        gpFPSStringB->draw(monitorX + 1, gBaseMonitorY + 2);
-        gpFPSStringW->draw(monitorX, gBaseMonitorY);
+        batch.pushText(font, monitorX + 1, gBaseMonitorY + 2, 14, 17, sStringBuffer,
+                       {0, 0, 0, 255});
+        batch.pushText(font, monitorX, gBaseMonitorY, 14, 17, sStringBuffer, sFPSColor);
     }
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include "debug.hxx"
 #include "libs/cheathandler.hxx"
 #include "libs/constmath.hxx"
+#include "libs/fastmath.hxx"
 #include "libs/geometry.hxx"
 #include "logging.hxx"
 #include "module.hxx"
@@ -115,11 +116,10 @@ void DebugLookAtCamera(TMario *player, CPolarSubCamera *camera) {
     camera->mTranslation      = gCamPosition;
     camera->mWorldTranslation = gCamPosition;
 
-    gpCamera->mAnglePitch = matan(sqrtf((gpCamera->mTranslation.x - gpMarioPos->x) *
-                                            (gpCamera->mTranslation.x - gpMarioPos->x) +
-                                        (gpCamera->mTranslation.z - gpMarioPos->z) *
-                                            (gpCamera->mTranslation.z - gpMarioPos->z)),
-                                  gpCamera->mTranslation.y - gpMarioPos->y);
+    const f32 toMarioX    = gpCamera->mTranslation.x - gpMarioPos->x;
+    const f32 toMarioZ    = gpCamera->mTranslation.z - gpMarioPos->z;
+    const f32 toMarioDist = BetterSMS::Math::hypot<BetterSMS::Math::Tier::FAST>(toMarioX, toMarioZ);
+    gpCamera->mAnglePitch = matan(toMarioDist, gpCamera->mTranslation.y - gpMarioPos->y);
     gpCamera->mAngleYaw =
         matan(gpCamera->mTranslation.z - gpMarioPos->z, gpCamera->mTranslation.x - gpMarioPos->x);
 
@@ -18,6 +18,7 @@
 #include "module.hxx"
 
 #include "p_debug.hxx"
+#include "p_quadbatch.hxx"
 
 using namespace BetterSMS;
 
@@ -27,17 +28,18 @@ static u16 gMonitorWidth = 210, gMonitorHeight = 6 * 3;
 static f32 gSystemHeapMaxUsage, gCurrentHeapMaxUsage, gRootHeapMaxUsage;
 static JKRHeap *gCurrentHeap = nullptr;
 
-static void drawMonitorBar(f32 currentFill, f32 maxFill, JUtility::TColor color, s16 x, s16 y,
-                           s16 w, s16 h) {
-    J2DFillBox(x, y, w * currentFill, h, color);
-    J2DFillBox(x + (w * maxFill), y, 2, h, {200, 200, 200, 255});
+static void pushMonitorBar(TQuadBatch &batch, f32 currentFill, f32 maxFill,
+                           JUtility::TColor color, s16 x, s16 y, s16 w, s16 h) {
+    batch.pushFill(x, y, w * currentFill, h, color);
+    batch.pushFill(x + (w * maxFill), y, 2, h, {200, 200, 200, 255});
 }
 
 static size_t getHeapSize(JKRHeap *heap) {
     return reinterpret_cast<size_t>(heap->mEnd) - reinterpret_cast<size_t>(heap->mStart);
 }
 
-static void drawHeapUsage(JKRHeap *heap, f32 &maxUsage, JUtility::TColor color, u16 y) {
+static void pushHeapUsage(TQuadBatch &batch, JKRHeap *heap, f32 &maxUsage,
+                          JUtility::TColor color, u16 y) {
     const auto heapSize = getHeapSize(heap);
 
     const f32 currentUsage = static_cast<f32>((heapSize - heap->getTotalFreeSize())) / heapSize;
@@ -46,14 +48,15 @@ static void drawHeapUsage(JKRHeap *heap, f32 &maxUsage, JUtility::TColor color,
 
     {
         s16 adjust = getScreenRatioAdjustX();
-        drawMonitorBar(currentUsage, maxUsage, color, (gBaseMonitorX - adjust) + 2, y,
+        pushMonitorBar(batch, currentUsage, maxUsage, color, (gBaseMonitorX - adjust) + 2, y,
                        (gMonitorWidth + adjust) - 6, 4);
     }
 }
 
 BETTER_SMS_FOR_CALLBACK void resetMonitor(TApplication *app) { gCurrentHeapMaxUsage = 0.0f; }
 
-BETTER_SMS_FOR_CALLBACK void drawMonitor(TApplication *app, const J2DOrthoGraph *graph) {
+// Pushed during the update so the draw handler submits every bar in one batch
+BETTER_SMS_FOR_CALLBACK void updateMonitor(TApplication *app) {
     auto *systemHeap  = JKRHeap::sSystemHeap;
     auto *currentHeap = JKRHeap::sCurrentHeap;
     auto *rootHeap    = JKRHeap::sRootHeap;
@@ -66,13 +69,15 @@ BETTER_SMS_FOR_CALLBACK void drawMonitor(TApplication *app, const J2DOrthoGraph
         gCurrentHeapMaxUsage = 0.0f;
     }
 
+    TQuadBatch &batch = getQuadBatch(QUAD_LAYER_DEBUG);
+
     {
         s16 adjust = getScreenRatioAdjustX();
-        J2DFillBox(gBaseMonitorX - adjust, gMonitorY, gMonitorWidth + adjust, gMonitorHeight,
-                   {0, 0, 0, 170});
+        batch.pushFill(gBaseMonitorX - adjust, gMonitorY, gMonitorWidth + adjust, gMonitorHeight,
+                       {0, 0, 0, 170});
     }
 
-    drawHeapUsage(systemHeap, gSystemHeapMaxUsage, {220, 50, 30, 255}, gMonitorY + 2);
-    drawHeapUsage(currentHeap, gCurrentHeapMaxUsage, {30, 230, 30, 255}, gMonitorY + 7);
-    drawHeapUsage(rootHeap, gRootHeapMaxUsage, {40, 30, 230, 255}, gMonitorY + 12);
+    pushHeapUsage(batch, systemHeap, gSystemHeapMaxUsage, {220, 50, 30, 255}, gMonitorY + 2);
+    pushHeapUsage(batch, currentHeap, gCurrentHeapMaxUsage, {30, 230, 30, 255}, gMonitorY + 7);
+    pushHeapUsage(batch, rootHeap, gRootHeapMaxUsage, {40, 30, 230, 255}, gMonitorY + 12);
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <Dolphin/GX.h>
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/JKernel/JKRHeap.hxx>
+
+#include "logging.hxx"
+#include "memory.hxx"
+#include "module.hxx"
+#include "p_displaylist.hxx"
+
+using namespace BetterSMS;
+
+TDisplayListCache::~TDisplayListCache() { release(); }
+
+void TDisplayListCache::release() {
+    if (mBuffer)
+        Memory::free(mBuffer);
+    mBuffer  = nullptr;
+    mIsValid = false;
+}
+
+bool TDisplayListCache::record(J2DScreen *screen, J2DOrthoGraph *ortho) {
+    // From the system heap, not whichever heap is current on the first draw
+    if (!mBuffer) {
+        mBuffer = Memory::hmalloc(JKRHeap::sSystemHeap, mCapacity, 32);
+        if (!mBuffer) {
+            Console::record(Console::LEVEL_WARNING, Console::CATEGORY_GENERAL,
+                            "Display list: Failed to allocate %lu bytes, drawing immediately!\n",
+                            mCapacity);
+            mIsOverflowed = true;
+            return false;
+        }
+    }
+
+    // The list is written around the cache, drop any stale lines first
+    DCInvalidateRange(mBuffer, mCapacity);
+
+    GXBeginDispList(mBuffer, mCapacity);
+    screen->draw(0, 0, ortho);
+    mSize = GXEndDispList();
+
+    if (mSize == 0) {
+        Console::record(Console::LEVEL_WARNING, Console::CATEGORY_GENERAL,
+                        "Display list: Screen exceeds %lu bytes, drawing immediately!\n",
+                        mCapacity);
+        Memory::free(mBuffer);
+        mBuffer       = nullptr;
+        mIsOverflowed = true;
+        return false;
+    }
+
+    mIsValid = true;
+    return true;
+}
+
+void TDisplayListCache::draw(J2DScreen *screen, J2DOrthoGraph *ortho) {
+    if (mIsOverflowed || (!mIsValid && !record(screen, ortho))) {
+        screen->draw(0, 0, ortho);
+        return;
+    }
+
+    GXCallDispList(mBuffer, mSize);
+
+    // GX restored its own copy of the state when the list was closed, so it
+    // still holds the ortho setup while the registers hold whatever the
+    // screen left. Set the 2D state up again so the two agree for whoever
+    // draws next.
+    ortho->setup2D();
+}
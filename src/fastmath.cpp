@@ -0,0 +1,73 @@
+#include <Dolphin/types.h>
+
+#include "libs/fastmath.hxx"
+#include "module.hxx"
+
+using namespace BetterSMS::Math;
+
+// One turn of sine plus a closing sample so interpolation never wraps. The
+// table is built at compile time and lives in rodata.
+struct TSinTable {
+    f32 mSamples[SinTableSize + 1];
+};
+
+static constexpr f64 sinSeries(f64 x) {
+    // Reduce to [-pi, pi] where the series converges well within double precision
+    if (x > M_PI)
+        x -= 2.0 * M_PI;
+
+    f64 term = x;
+    f64 sum  = x;
+    for (int n = 1; n < 14; ++n) {
+        term *= -(x * x) / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+static constexpr TSinTable buildSinTable() {
+    TSinTable table{};
+    for (size_t i = 0; i <= SinTableSize; ++i) {
+        const f64 x = (2.0 * M_PI * static_cast<f64>(i)) / static_cast<f64>(SinTableSize);
+        table.mSamples[i] = static_cast<f32>(sinSeries(x));
+    }
+    return table;
+}
+
+static constexpr TSinTable sSinTable = buildSinTable();
+
+static constexpr f32 RadiansToIndex = static_cast<f32>(SinTableSize / (2.0 * M_PI));
+static constexpr size_t QuarterTurn = SinTableSize / 4;
+
+static inline f32 lookup(f32 index) {
+    s32 whole = static_cast<s32>(index);
+    if (index < static_cast<f32>(whole))
+        whole -= 1;
+
+    const f32 frac = index - static_cast<f32>(whole);
+    const f32 *s   = &sSinTable.mSamples[static_cast<u32>(whole) & (SinTableSize - 1)];
+    return s[0] + (s[1] - s[0]) * frac;
+}
+
+BETTER_SMS_FOR_EXPORT f32 BetterSMS::Math::sinTable(f32 radians) {
+    return lookup(radians * RadiansToIndex);
+}
+
+BETTER_SMS_FOR_EXPORT f32 BetterSMS::Math::cosTable(f32 radians) {
+    return lookup(radians * RadiansToIndex + static_cast<f32>(QuarterTurn));
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Math::sinCosTable(f32 radians, f32 &sin, f32 &cos) {
+    const f32 index = radians * RadiansToIndex;
+    sin             = lookup(index);
+    cos             = lookup(index + static_cast<f32>(QuarterTurn));
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Math::batchSinCosTable(const f32 *radians, f32 *sins,
+                                                             f32 *coss, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const f32 index = radians[i] * RadiansToIndex;
+        sins[i]         = lookup(index);
+        coss[i]         = lookup(index + static_cast<f32>(QuarterTurn));
+    }
+}
@@ -11,6 +11,8 @@
 
 #include "game.hxx"
 #include "module.hxx"
+#include "p_gptrace.hxx"
+#include "p_quadbatch.hxx"
 
 using namespace BetterSMS;
 
@@ -77,6 +79,7 @@ extern void updateStageCallbacks(TApplication *);
 extern void updateDebugCallbacks(TApplication *);
 extern void drawLoadingScreen(TApplication *, const J2DOrthoGraph *);
 extern void drawDebugCallbacks(TApplication *, const J2DOrthoGraph *);
+extern void syncFrameClockForDraw();
 
 // extern -> custom app proc
 s32 gameLoopCallbackHandler(JDrama::TDirector *director) {
@@ -95,26 +98,43 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x802A616C, 0x8029E07C, 0, 0), gameLoopCallbackHand
 
 void gameDrawCallbackHandler() {
     THPPlayerDrawDone();
+    syncFrameClockForDraw();
     {
         J2DOrthoGraph ortho(0, 0, BetterSMS::getScreenOrthoWidth(), 448);
-        ortho.setup2D();
-
-        GXSetViewport(0, 0, 640, 480, 0, 1);
         {
+            TGPZoneScope zone(GP_ZONE_SETUP);
+            ortho.setup2D();
+
+            GXSetViewport(0, 0, 640, 480, 0, 1);
+
             Mtx44 mtx;
             C_MTXOrtho(mtx, 16, 496, -BetterSMS::getScreenRatioAdjustX(),
                        600.0f + BetterSMS::getScreenRatioAdjustX(), -1, 1);
             GXSetProjection(mtx, GX_ORTHOGRAPHIC);
         }
 
-        drawLoadingScreen(&gpApplication, &ortho);
-        drawDebugCallbacks(&gpApplication, &ortho);
+        {
+            TGPZoneScope zone(GP_ZONE_LOADING);
+            drawLoadingScreen(&gpApplication, &ortho);
+        }
 
         {
+            TGPZoneScope zone(GP_ZONE_DEBUG);
+            flushQuadBatch(QUAD_LAYER_DEBUG, &ortho);
+            drawDebugCallbacks(&gpApplication, &ortho);
+        }
+
+        {
+            TGPZoneScope zone(GP_ZONE_POST_DRAW);
             for (auto &item : sGameDrawCBs) {
                 item(&gpApplication, &ortho);
             }
         }
+
+        {
+            TGPZoneScope zone(GP_ZONE_OVERLAY);
+            flushQuadBatch(QUAD_LAYER_OVERLAY, &ortho);
+        }
     }
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x802a630c, 0, 0, 0), gameDrawCallbackHandler);
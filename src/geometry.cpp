@@ -0,0 +1,93 @@
+#include <Dolphin/types.h>
+
+#include "libs/geometry.hxx"
+#include "module.hxx"
+
+// Wrappers for the paired single loops in src/asm/geometry.s. Other targets
+// use the C loops in geometry.hxx.
+
+#ifdef __powerpc__
+
+using namespace BetterSMS;
+
+extern "C" {
+void psMagnitudeLoop(const TVec3f *vecs, f32 *out, size_t count, const f32 *consts);
+void psNormalizeLoop(const TVec3f *vecs, TVec3f *out, size_t count, const f32 *consts);
+void psDotLoop(const TVec3f *a, const TVec3f *b, f32 *out, size_t count);
+void psAngleBetweenLoop(const TVec3f *a, const TVec3f *b, f32 *out, size_t count,
+                        const f32 *consts);
+void psLookAtLoop(const TVec3f *a, const TVec3f *b, f32 *out, size_t count);
+void psNormalToRotationLoop(const TVec3f *norms, const TVec3f *up, Mtx *out, size_t count,
+                            const f32 *consts);
+void psDecomposeLoop(const Mtx *mtx, TVec3f *translation, TVec3f *scale, f32 *terms,
+                     size_t count, const f32 *consts);
+}
+
+// 0.5 and 3.0 for the Newton step, 0.0 and 1.0 for the selects, then the
+// normalToRotationU threshold
+static const f32 sPsConstants[5] = {0.5f, 3.0f, 0.0f, 1.0f, 0.999f};
+
+// The loops that leave trig to C work through this many entries at a time
+static constexpr size_t PsChunk = 32;
+
+void BetterSMS::Detail::psMagnitudeArray(const TVec3f *vecs, f32 *out, size_t count) {
+    psMagnitudeLoop(vecs, out, count, sPsConstants);
+}
+
+void BetterSMS::Detail::psNormalizeArray(const TVec3f *vecs, TVec3f *out, size_t count) {
+    psNormalizeLoop(vecs, out, count, sPsConstants);
+}
+
+void BetterSMS::Detail::psDotArray(const TVec3f *a, const TVec3f *b, f32 *out, size_t count) {
+    psDotLoop(a, b, out, count);
+}
+
+void BetterSMS::Detail::psAngleBetweenArray(const TVec3f *a, const TVec3f *b, f32 *out,
+                                            size_t count) {
+    psAngleBetweenLoop(a, b, out, count, sPsConstants);
+}
+
+void BetterSMS::Detail::psLookAtRatioArray(const TVec3f *a, const TVec3f *b, f32 *out,
+                                           size_t count) {
+    f32 terms[PsChunk * 2];
+
+    for (size_t i = 0; i < count; i += PsChunk) {
+        const size_t n = count - i < PsChunk ? count - i : PsChunk;
+        psLookAtLoop(a + i, b + i, terms, n);
+        for (size_t j = 0; j < n; ++j)
+            out[i + j] = fabsf(atan2f(terms[j * 2], terms[j * 2 + 1])) / M_PI;
+    }
+}
+
+void BetterSMS::Detail::psNormalToRotationArray(const TVec3f *norms, const TVec3f *up, Mtx *out,
+                                                size_t count) {
+    psNormalToRotationLoop(norms, up, out, count, sPsConstants);
+}
+
+void BetterSMS::Detail::psDecomposeArray(const Mtx *mtx, TVec3f *translation, TVec3f *rotation,
+                                         TVec3f *scale, size_t count) {
+    f32 terms[PsChunk * 6];
+
+    for (size_t i = 0; i < count; i += PsChunk) {
+        const size_t n = count - i < PsChunk ? count - i : PsChunk;
+        psDecomposeLoop(mtx + i, translation + i, scale + i, terms, n, sPsConstants);
+
+        for (size_t j = 0; j < n; ++j) {
+            const TVec3f &s = scale[i + j];
+            const f32 *t    = &terms[j * 6];
+            TVec3f &r       = rotation[i + j];
+
+            // A zero column leaves no rotation to recover, as in the scalar form
+            if (s.x == 0.0f || s.y == 0.0f || s.z == 0.0f) {
+                r.x = 0.0f;
+                r.y = 0.0f;
+                r.z = 0.0f;
+                continue;
+            }
+
+            Matrix::rotationFromTerms(t[4], t[0], t[1], t[2], t[3], t[5], r);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,188 @@
+#include <Dolphin/GX.h>
+#include <Dolphin/OS.h>
+#include <Dolphin/string.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/JKernel/JKRHeap.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/macros.h>
+
+#include "logging.hxx"
+#include "memory.hxx"
+#include "module.hxx"
+#include "p_gptrace.hxx"
+
+using namespace BetterSMS;
+
+static const char *sZoneNames[GP_ZONE_COUNT] = {
+    "Setup", "Loading", "Debug", "Post Draw", "Overlay", "Fog", "Copy Filter", "Scissor"};
+
+static GPZoneStats sStats[GP_ZONE_COUNT] = {};
+
+#if SMS_DEBUG
+
+// Processor interface registers describing the CPU FIFO
+static vu32 *const sPIRegs = (u32 *)0xCC003000;
+
+constexpr u32 PIFifoBase     = 3;
+constexpr u32 PIFifoEnd      = 4;
+constexpr u32 PIFifoWritePtr = 5;
+constexpr u32 PIFifoWrapBit  = 0x04000000;
+
+static u32 sWindowBytes[GP_ZONE_COUNT][GPTraceWindow] = {};
+static u32 sFrameBytes[GP_ZONE_COUNT]                 = {};
+static u32 sFrameEntries[GP_ZONE_COUNT]               = {};
+static u32 sWindowIndex                               = 0;
+
+static u8 *sCaptureBuffer    = nullptr;
+static size_t sCaptureUsed   = 0;
+static bool sIsCaptureQueued = false;
+static bool sIsCaptureActive = false;
+static u32 sZoneDepth        = 0;
+
+static u32 readFifoWritePtr() { return sPIRegs[PIFifoWritePtr] & ~PIFifoWrapBit; }
+
+// Bytes written between two samples of the write pointer, unwrapping once
+static u32 fifoDistance(u32 start, u32 end) {
+    if (end >= start)
+        return end - start;
+    return (sPIRegs[PIFifoEnd] - start) + (end - sPIRegs[PIFifoBase]);
+}
+
+static void copyFromFifo(u8 *dst, u32 start, u32 size) {
+    const u32 base = sPIRegs[PIFifoBase];
+    const u32 end  = sPIRegs[PIFifoEnd];
+
+    // The GP reads the FIFO behind the cache, read it the same way
+    while (size > 0) {
+        const u32 run = Min(size, end - start);
+        memcpy(dst, reinterpret_cast<const void *>(0xC0000000 | start), run);
+        dst += run;
+        size -= run;
+        start = base;
+    }
+}
+
+static void teeZone(GPTraceZone zone, u32 start, u32 size) {
+    GPCaptureHeader *header = reinterpret_cast<GPCaptureHeader *>(sCaptureBuffer);
+
+    const size_t padded = (size + 3) & ~3;
+    if (sCaptureUsed + sizeof(GPCaptureRecord) + padded > GPCaptureSize) {
+        header->mDroppedBytes += size;
+        return;
+    }
+
+    GPCaptureRecord *record = reinterpret_cast<GPCaptureRecord *>(sCaptureBuffer + sCaptureUsed);
+    record->mZone           = zone;
+    record->mSize           = size;
+    sCaptureUsed += sizeof(GPCaptureRecord);
+
+    copyFromFifo(sCaptureBuffer + sCaptureUsed, start, size);
+    sCaptureUsed += padded;
+
+    header->mRecordCount += 1;
+    header->mDataSize = sCaptureUsed - sizeof(GPCaptureHeader);
+}
+
+static void beginCapture() {
+    if (!sCaptureBuffer) {
+        sCaptureBuffer =
+            static_cast<u8 *>(Memory::hmalloc(JKRHeap::sSystemHeap, GPCaptureSize, 32));
+        if (!sCaptureBuffer) {
+            Console::record(Console::LEVEL_ERROR, Console::CATEGORY_GENERAL,
+                            "GP trace: Not enough memory for a %lu byte capture!\n",
+                            GPCaptureSize);
+            return;
+        }
+    }
+
+    GPCaptureHeader *header = reinterpret_cast<GPCaptureHeader *>(sCaptureBuffer);
+    memset(header, 0, sizeof(GPCaptureHeader));
+    header->mMagic     = GPCaptureMagic;
+    header->mVersion   = GPCaptureVersion;
+    header->mZoneCount = GP_ZONE_COUNT;
+    for (size_t i = 0; i < GP_ZONE_COUNT; ++i) {
+        strncpy(header->mZoneNames[i], sZoneNames[i], GPZoneNameSize - 1);
+    }
+
+    sCaptureUsed     = sizeof(GPCaptureHeader);
+    sIsCaptureActive = true;
+}
+
+static void endCapture() {
+    const GPCaptureHeader *header = reinterpret_cast<GPCaptureHeader *>(sCaptureBuffer);
+    Console::record(Console::LEVEL_INFO, Console::CATEGORY_GENERAL,
+                    "GP trace: Captured %lu records (%lu bytes, %lu dropped) at 0x%08lX, dump "
+                    "%lu bytes from there for FifoAnalyzer\n",
+                    header->mRecordCount, header->mDataSize, header->mDroppedBytes,
+                    reinterpret_cast<u32>(sCaptureBuffer), sCaptureUsed);
+    sIsCaptureActive = false;
+}
+
+#endif
+
+TGPZoneScope::TGPZoneScope(GPTraceZone zone) : mZone(zone), mStart(0) {
+#if SMS_DEBUG
+    // Nested zones are charged to the outermost one
+    if (sZoneDepth++ != 0)
+        return;
+
+    if (sIsCaptureActive)
+        GXFlush();
+    mStart = readFifoWritePtr();
+#endif
+}
+
+TGPZoneScope::~TGPZoneScope() {
+#if SMS_DEBUG
+    if (--sZoneDepth != 0)
+        return;
+
+    if (sIsCaptureActive)
+        GXFlush();
+
+    const u32 size = fifoDistance(mStart, readFifoWritePtr());
+    sFrameBytes[mZone] += size;
+    sFrameEntries[mZone] += 1;
+
+    if (sIsCaptureActive)
+        teeZone(mZone, mStart, size);
+#endif
+}
+
+const GPZoneStats &getGPZoneStats(GPTraceZone zone) { return sStats[zone]; }
+
+const char *getGPZoneName(GPTraceZone zone) { return sZoneNames[zone]; }
+
+void requestGPCapture() {
+#if SMS_DEBUG
+    sIsCaptureQueued = true;
+#endif
+}
+
+BETTER_SMS_FOR_CALLBACK void flipGPTrace(TApplication *app) {
+#if SMS_DEBUG
+    if (sIsCaptureActive)
+        endCapture();
+
+    for (size_t i = 0; i < GP_ZONE_COUNT; ++i) {
+        sWindowBytes[i][sWindowIndex] = sFrameBytes[i];
+
+        u32 total = 0;
+        for (size_t j = 0; j < GPTraceWindow; ++j) {
+            total += sWindowBytes[i][j];
+        }
+
+        sStats[i].mBytes   = total / GPTraceWindow;
+        sStats[i].mEntries = sFrameEntries[i];
+        sFrameBytes[i]     = 0;
+        sFrameEntries[i]   = 0;
+    }
+    sWindowIndex = (sWindowIndex + 1) % GPTraceWindow;
+
+    if (sIsCaptureQueued) {
+        sIsCaptureQueued = false;
+        beginCapture();
+    }
+#endif
+}
@@ -3,6 +3,7 @@
 
 #include <SMS/raw_fn.hxx>
 
+#include "p_gptrace.hxx"
 #include "p_settings.hxx"
 #include "module.hxx"
 
@@ -30,6 +31,7 @@ static void injectGraphicsFilterConfigurations(bool useAA, u8 samplePattern[12][
         samplePattern = useAA ? s_samplePattern : nullptr;
     }
 
+    TGPZoneScope zone(GP_ZONE_COPY_FILTER);
     GXSetCopyFilter(useAA, samplePattern, doVertFilt, vFilt);
 }
 SMS_PATCH_BL(0x802F9090, injectGraphicsFilterConfigurations);
@@ -150,13 +150,17 @@ void LevelSelectScreen::perform(u32 flags, JDrama::TGraphics *graphics) {
         J2DOrthoGraph ortho(0, 0, BetterSMS::getScreenOrthoWidth(), SMSGetTitleRenderHeight());
         ortho.setup2D();
 
-        mScreen->draw(0, 0, &ortho);
+        mDisplayList.draw(mScreen, &ortho);
     }
 }
 
 void LevelSelectScreen::processInput() {
     const bool selectingEpisode = mSelectedAreaID != -1;
 
+    const s32 oldScrollAreaID    = mScrollAreaID;
+    const s32 oldScrollEpisodeID = mScrollEpisodeID;
+    const s32 oldSelectedAreaID  = mSelectedAreaID;
+
     // Scroll item
     {
         if ((mController->mButtons.mRapidInput &
@@ -211,7 +215,13 @@ void LevelSelectScreen::processInput() {
     }
 
     // Check for filename select
-    if ((mController->mButtons.mInput & TMarioGamePad::Z)) {
+    const bool showFilenames = (mController->mButtons.mInput & TMarioGamePad::Z);
+    if (showFilenames != mIsShowingFilenames) {
+        mIsShowingFilenames = showFilenames;
+        mDisplayList.invalidate();
+    }
+
+    if (showFilenames) {
         for (auto &areaInfo : mAreaInfos) {
             for (auto &episodeInfo : areaInfo->mEpisodeInfos) {
                 if (episodeInfo->mScenarioTextBox) {
@@ -260,6 +270,12 @@ void LevelSelectScreen::processInput() {
             }
         }
     }
+
+    // Record the screen again only when the selection actually moved
+    if (mScrollAreaID != oldScrollAreaID || mScrollEpisodeID != oldScrollEpisodeID ||
+        mSelectedAreaID != oldSelectedAreaID) {
+        mDisplayList.invalidate();
+    }
 }
 
 bool LevelSelectScreen::genAreaText(s32 flatRow, u8 normalStageID, u8 shineStageID,
@@ -543,15 +559,13 @@ bool LevelSelectScreen::genAreaTextScale(s32 flatRow) {
 
 void LevelSelectScreen::genEpisodeText(AreaMenuInfo &menu, u8 normalStageID, u8 shineStageID,
                                        void *scenarioNameData) {
-    const Stage::ShineAreaInfo *info = Stage::getShineAreaInfos()[shineStageID];
-    if (!info) {
+    const Stage::FrozenShineArea &area = Stage::getFrozenShineArea(shineStageID);
+    if (!area.isValid()) {
         return;
     }
 
-    const TGlobalVector<s32> &scenarioIDs = info->getScenarioIDs();
-
     size_t rows = 0;
-    for (s32 j = 0; j < scenarioIDs.size(); ++j) {
+    for (s32 j = 0; j < area.getScenarioCount(); ++j) {
         if (!sceneExists(normalStageID, j)) {
             continue;
         }
@@ -578,22 +592,24 @@ void LevelSelectScreen::genEpisodeText(AreaMenuInfo &menu, u8 normalStageID, u8
     size_t textBaseHeight = 21;
     size_t textHeight     = rows < 10 ? textBaseHeight : (textBaseHeight - (rows - 10));
 
-    const TGlobalVector<s32> &scenarioNameIDs = info->getScenarioNameIDs();
+    // The frozen table pads missing names with -1, the info still shows the mismatch
+    const Stage::ShineAreaInfo *info = Stage::getShineAreaInfos()[shineStageID];
+    if (info->getScenarioIDs().size() > info->getScenarioNameIDs().size()) {
+        OSReport("[WARNING] Scenario count mismatches name count! %lu / %lu\n",
+                 info->getScenarioIDs().size(), info->getScenarioNameIDs().size());
+    }
 
     s32 en = 0, eny = 0;
-    for (s32 j = 0; j < scenarioIDs.size(); ++j) {
-        if (scenarioIDs.size() > scenarioNameIDs.size()) {
-            OSReport("[WARNING] Scenario count mismatches name count! %lu / %lu\n",
-                     scenarioIDs.size(), scenarioNameIDs.size());
-        }
-
+    for (s32 j = 0; j < area.getScenarioCount(); ++j) {
         char filename[128];
         if (!sceneFilename(filename, 128, normalStageID, j)) {
             continue;
         }
 
-        u8 scenarioID      = scenarioIDs[j];
-        s32 scenarioNameID = j >= scenarioNameIDs.size() ? -1 : scenarioNameIDs[j];
+        const Stage::ScenarioEntry *scenario = area.getScenario(j);
+
+        u8 scenarioID      = scenario->mScenarioID;
+        s32 scenarioNameID = scenario->mScenarioNameID;
 
         J2DTextBox *scenarioText = new J2DTextBox(
             ('e' << 24) | scenarioNameID & 0xFFFFFF,
@@ -671,9 +687,9 @@ void LevelSelectScreen::genEpisodeText(AreaMenuInfo &menu, u8 normalStageID, u8
             continue;
         }
 
-        const TGlobalVector<s32> &exScenarioNameIDs = info->getExScenarioNameIDs();
+        const Stage::ScenarioEntry *exScenario = area.getExScenario(exrow);
 
-        s32 exareaNameID = exScenarioNameIDs[exrow];
+        s32 exareaNameID = exScenario ? exScenario->mScenarioNameID : -1;
 
         J2DTextBox *episodeText = new J2DTextBox(
             ('e' << 24) | j,
@@ -731,7 +747,7 @@ void LevelSelectScreen::genEpisodeTextDelfinoPlaza(AreaMenuInfo &menu, u8 normal
     auto *areaInfoAry = reinterpret_cast<TNameRefAryT<TScenarioArchiveName> *>(
         gpApplication.mStageArchiveAry->mChildren[1]);
 
-    const Stage::ShineAreaInfo *info = Stage::getShineAreaInfos()[shineStageID];
+    const Stage::FrozenShineArea &area = Stage::getFrozenShineArea(shineStageID);
 
     size_t rows = 0;
     for (s32 i = 0; i < areaInfoAry->mChildren.size(); ++i) {
@@ -833,9 +849,9 @@ void LevelSelectScreen::genEpisodeTextDelfinoPlaza(AreaMenuInfo &menu, u8 normal
             continue;
         }
 
-        const TGlobalVector<s32> &exScenarioNameIDs = info->getExScenarioNameIDs();
+        const Stage::ScenarioEntry *exScenario = area.getExScenario(exrow);
 
-        s32 exareaNameID = exScenarioNameIDs[exrow];
+        s32 exareaNameID = exScenario ? exScenario->mScenarioNameID : -1;
 
         J2DTextBox *episodeText = new J2DTextBox(
             ('e' << 24) | i,
@@ -1146,6 +1162,12 @@ EpisodeMenuInfo *LevelSelectScreen::getEpisodeInfo(u32 index) {
     return info->mEpisodeInfos.at(index);
 }
 
+LevelSelectDirector::~LevelSelectDirector() {
+    // The screen goes with the stage heap without being destroyed
+    if (mSelectScreen)
+        mSelectScreen->mDisplayList.release();
+}
+
 void *LevelSelectDirector::setupThreadFunc(void *param) {
     auto *director = reinterpret_cast<LevelSelectDirector *>(param);
     director->initialize();
@@ -15,6 +15,7 @@
 
 #include "module.hxx"
 #include "p_area.hxx"
+#include "p_displaylist.hxx"
 #include <GC2D/SelectGrad.hxx>
 
 using namespace BetterSMS;
@@ -38,10 +39,13 @@ class LevelSelectScreen : public JDrama::TViewObj {
 public:
     friend class LevelSelectDirector;
 
+    static constexpr size_t DisplayListSize = 0x20000;
+
     LevelSelectScreen(TMarioGamePad *controller)
         : TViewObj("<LevelSelectScreen>"), mScreen(nullptr), mController(controller),
           mScrollAreaID(0), mScrollEpisodeID(0), mSelectedAreaID(-1), mSelectedEpisodeID(-1),
-          mAreaInfos(), mShouldExit(false) {}
+          mAreaInfos(), mShouldExit(false), mIsShowingFilenames(false),
+          mDisplayList(DisplayListSize) {}
 
     ~LevelSelectScreen() override {}
 
@@ -65,6 +69,7 @@ protected:
 
 private:
     bool mShouldExit;
+    bool mIsShowingFilenames;
     s32 mColumnSize;
     s32 mColumnCount;
     s32 mScrollAreaID;
@@ -74,14 +79,17 @@ private:
     TMarioGamePad *mController;
     J2DScreen *mScreen;
     JGadget::TVector<AreaMenuInfo *> mAreaInfos;
+    TDisplayListCache mDisplayList;
 };
 
 class LevelSelectDirector : public JDrama::TDirector {
     enum class State { INIT, CONTROL, EXIT };
 
 public:
-    LevelSelectDirector()           = default;
-    ~LevelSelectDirector() override = default;
+    LevelSelectDirector()
+        : TDirector(), mState(State::INIT), mDisplay(nullptr), mController(nullptr),
+          mSelectScreen(nullptr) {}
+    ~LevelSelectDirector() override;
 
     void setup(JDrama::TDisplay *, TMarioGamePad *);
 
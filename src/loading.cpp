@@ -1,6 +1,8 @@
+#include <Dolphin/DVD.h>
 #include <Dolphin/GX.h>
 #include <Dolphin/OS.h>
 #include <Dolphin/types.h>
+#include <JSystem/J2D/J2DTextBox.hxx>
 #include <JSystem/JGeometry/JGMVec.hxx>
 #include <JSystem/JUtility/JUTTexture.hxx>
 
@@ -9,9 +11,11 @@
 #include <SMS/raw_fn.hxx>
 
 #include "libs/anim2d.hxx"
+#include "libs/global_vector.hxx"
 #include "loading.hxx"
 #include "module.hxx"
 #include "p_icons.hxx"
+#include "p_quadbatch.hxx"
 #include "p_settings.hxx"
 
 // clang-format off
@@ -35,14 +39,131 @@ static bool sIsLoading = false;
 
 static SimpleTexAnimator sLoadingIconAnimator(sLoadingIconTIMGs, 16);
 static J2DScreen *sLoadingScreen;
+static J2DScreen *sDefaultLoadingScreen;
 static JUTTexture sLoadingIconTexture;
 
+static TGlobalVector<Loading::PreloadCallback> sPreloadCBs;
+
+// Written by the loading thread, read by the render thread
+static volatile Loading::Phase sPhase = Loading::PHASE_IDLE;
+static volatile u32 sArchivesExpected = 0;
+static volatile u32 sArchivesLoaded   = 0;
+static volatile u32 sBytesExpected    = 0;
+static volatile u32 sBytesRead        = 0;
+
+static OSTime sLoadStartTime  = 0;
+static OSTime sPhaseStartTime = 0;
+static OSTime sPhaseTicks[Loading::PHASE_COUNT];
+
+static char sProgressBuffer[64];
+
+static const char *sPhaseNames[Loading::PHASE_COUNT] = {"Idle", "Reading archives", "Preloading",
+                                                        "Setting up"};
+
+void beginLoadingPhase(Loading::Phase phase) {
+    const OSTime now = OSGetTime();
+    sPhaseTicks[sPhase] += now - sPhaseStartTime;
+    sPhaseStartTime = now;
+    sPhase          = phase;
+}
+
+static void resetLoadingProgress() {
+    sPhase            = Loading::PHASE_IDLE;
+    sArchivesExpected = 0;
+    sArchivesLoaded   = 0;
+    sBytesExpected    = 0;
+    sBytesRead        = 0;
+
+    for (size_t i = 0; i < Loading::PHASE_COUNT; ++i) {
+        sPhaseTicks[i] = 0;
+    }
+
+    sLoadStartTime  = OSGetTime();
+    sPhaseStartTime = sLoadStartTime;
+}
+
+static void reportLoadingTimes() {
+    OSReport("[LOADING] Transition took %lu ms (archives %lu ms, preload %lu ms, setup %lu ms), "
+             "%lu KB read\n",
+             static_cast<u32>(OSTicksToMilliseconds(OSGetTime() - sLoadStartTime)),
+             static_cast<u32>(OSTicksToMilliseconds(sPhaseTicks[Loading::PHASE_ARCHIVES])),
+             static_cast<u32>(OSTicksToMilliseconds(sPhaseTicks[Loading::PHASE_PRELOAD])),
+             static_cast<u32>(OSTicksToMilliseconds(sPhaseTicks[Loading::PHASE_OBJECTS])),
+             sBytesRead / 1024);
+}
+
 void Loading::setLoading(bool isLoading) {
-    if (!sIsLoading && isLoading)
+    if (!sIsLoading && isLoading) {
         sLoadingIconAnimator.resetAnimation();
+        resetLoadingProgress();
+    } else if (sIsLoading && !isLoading) {
+        beginLoadingPhase(PHASE_IDLE);
+        reportLoadingTimes();
+    }
     sIsLoading = isLoading;
 }
 
+bool Loading::addPreloadCallback(PreloadCallback cb) {
+    sPreloadCBs.push_back(cb);
+    return true;
+}
+
+Loading::Phase Loading::getPhase() { return sPhase; }
+
+void Loading::addArchivesExpected(u32 count, u32 bytes) {
+    sArchivesExpected += count;
+    sBytesExpected += bytes;
+}
+
+// Bytes are counted as they come off the disc, see readDVDCountingBytes
+void Loading::reportArchiveLoaded(u32 bytes) { sArchivesLoaded += 1; }
+
+// Zero filled, which is all OSInitThreadQueue does, so it is ready for the
+// first read at boot
+static OSThreadQueue sDVDReadQueue;
+
+static void wakeDVDRead(u32 result, DVDFileInfo *fileInfo) { OSWakeupThread(&sDVDReadQueue); }
+
+// Replaces DVDReadPrio, which every JKRDvdRipper chunk goes through, so bytes
+// reach the loading screen while an archive streams in rather than once the
+// whole archive is mounted. Otherwise waits the same way the SDK does.
+static s32 readDVDCountingBytes(DVDFileInfo *fileInfo, void *addr, s32 length, s32 offset,
+                                s32 prio) {
+    if (!DVDReadAsyncPrio(fileInfo, addr, length, offset, wakeDVDRead, prio))
+        return -1;
+
+    DVDCommandBlock *cmdblock = reinterpret_cast<DVDCommandBlock *>(fileInfo);
+
+    u32 _atomic_state = OSDisableInterrupts();
+
+    while (cmdblock->mCurState != DVD_STATE_END && cmdblock->mCurState != DVD_STATE_CANCELED &&
+           cmdblock->mCurState != DVD_STATE_FATAL_ERROR) {
+        OSSleepThread(&sDVDReadQueue);
+    }
+
+    s32 result;
+    if (cmdblock->mCurState == DVD_STATE_END) {
+        result = cmdblock->mCommandResult;
+        if (sIsLoading)
+            sBytesRead += result;
+    } else {
+        result = cmdblock->mCurState == DVD_STATE_CANCELED ? -3 : -1;
+    }
+
+    OSRestoreInterrupts(_atomic_state);
+
+    return result;
+}
+SMS_PATCH_B(SMS_PORT_REGION(0x8034BD74, 0, 0, 0), readDVDCountingBytes);
+
+// Called on the stage loading thread after the scene archive is mounted
+void runStagePreload(TMarDirector *director) {
+    beginLoadingPhase(Loading::PHASE_PRELOAD);
+    for (auto &item : sPreloadCBs) {
+        item(director);
+    }
+}
+
 void Loading::setLoadingIcon(const ResTIMG **textures, size_t texCount) {
     sLoadingIconAnimator.setTextures(textures, texCount);
 }
@@ -58,6 +179,7 @@ void initLoadingScreen() {
         JSUMemoryInputStream stream(sLoadingScreenBlo, sizeof(sLoadingScreenBlo));
         sLoadingScreen = new J2DScreen();
         sLoadingScreen->makeHiearachyPanes(sLoadingScreen, &stream, false, true, false, nullptr);
+        sDefaultLoadingScreen = sLoadingScreen;
     }
 
     sLoadingIconTexture.mTexObj2.val[2] = 0;
@@ -78,21 +200,67 @@ void initLoadingScreen() {
 
 extern AspectRatioSetting gAspectRatioSetting;
 
+// Drawn apart from the layout so it survives Loading::setLayout
+static void pushLoadingProgress(TQuadBatch &batch, int screenAdjustX) {
+    const Loading::Phase phase = sPhase;
+    if (phase == Loading::PHASE_IDLE)
+        return;
+
+    const u32 bytesRead        = sBytesRead;
+    const u32 bytesExpected    = sBytesExpected;
+    const u32 archivesLoaded   = sArchivesLoaded;
+    const u32 archivesExpected = sArchivesExpected;
+
+    if (archivesExpected > 1) {
+        snprintf(sProgressBuffer, 64, "%s - %lu/%lu KB, %lu of %lu archives", sPhaseNames[phase],
+                 bytesRead / 1024, bytesExpected / 1024, archivesLoaded, archivesExpected);
+    } else if (bytesExpected > 0) {
+        snprintf(sProgressBuffer, 64, "%s - %lu/%lu KB", sPhaseNames[phase], bytesRead / 1024,
+                 bytesExpected / 1024);
+    } else {
+        snprintf(sProgressBuffer, 64, "%s", sPhaseNames[phase]);
+    }
+
+    const f32 barX = 360 + screenAdjustX;
+    if (bytesExpected > 0) {
+        const f32 progress = Min(static_cast<f32>(bytesRead) / bytesExpected, 1.0f);
+        batch.pushFill(barX, 454, 212, 4, {0, 0, 0, 170});
+        batch.pushFill(barX, 454, 212 * progress, 4, {255, 255, 255, 255});
+    }
+
+    batch.pushText(getSystemQuadFont(), barX, 440, 11, 11, sProgressBuffer,
+                   {255, 255, 255, 255});
+}
+
 void drawLoadingScreen(TApplication *app, const J2DOrthoGraph *ortho) {
     if (!sIsLoading || !sLoadingScreen)
         return;
 
     const int screenAdjustX = BetterSMS::getScreenRatioAdjustX();
 
+    TQuadBatch &batch = getQuadBatch(QUAD_LAYER_LOADING);
+    batch.clear();
+
     J2DScreen *screen = sLoadingScreen;
 
-    auto loadingIcon = screen->search('icon');
-    if (loadingIcon) {
-        loadingIcon->mRect = {540 + screenAdjustX, 400, 572 + screenAdjustX, 432};
-        sLoadingIconAnimator.process(reinterpret_cast<J2DPicture *>(loadingIcon));
+    // The built in layout is only the icon, so it goes out with the progress
+    // text instead of through the screen. A module's own layout is drawn as is.
+    if (screen == sDefaultLoadingScreen) {
+        const ResTIMG *frame = sLoadingIconAnimator.advance();
+        if (frame)
+            sLoadingIconTexture.storeTIMG(frame);
+        batch.pushTexture(&sLoadingIconTexture, 540 + screenAdjustX, 400, 32, 32);
+    } else {
+        auto loadingIcon = screen->search('icon');
+        if (loadingIcon) {
+            loadingIcon->mRect = {540 + screenAdjustX, 400, 572 + screenAdjustX, 432};
+            sLoadingIconAnimator.process(reinterpret_cast<J2DPicture *>(loadingIcon));
+        }
+        screen->draw(0, 0, ortho);
     }
 
-    screen->draw(0, 0, ortho);
+    pushLoadingProgress(batch, screenAdjustX);
+    flushQuadBatch(QUAD_LAYER_LOADING, ortho);
 }
 
 #pragma endregion
\ No newline at end of file
@@ -1,44 +1,494 @@
 #include <Dolphin/OS.h>
 #include <Dolphin/printf.h>
 #include <Dolphin/stdarg.h>
+#include <Dolphin/string.h>
 #include <SMS/macros.h>
 
+#include "libs/lock.hxx"
+#include "libs/mutex.hxx"
 #include "logging.hxx"
 #include "module.hxx"
 
+using namespace BetterSMS;
+
+// Records are a multiple of two words so timestamps stay 8 byte aligned
+constexpr size_t LogRingWords          = 0x1000;
+constexpr size_t LogMaxPayloadWords    = 64;
+constexpr size_t LogLineSize           = 512;
+constexpr size_t LogSpecSize           = 32;
+constexpr OSPriority LogThreadPriority = OSPriority(31);  // Idle
+
+enum LogFlags : u8 {
+    LOG_FLAG_COMMITTED = 1 << 0,
+    LOG_FLAG_PADDING   = 1 << 1,
+    LOG_FLAG_PLAIN     = 1 << 2,  // Legacy calls, printed without a prefix
+};
+
+struct LogRecord {
+    u16 mWords;  // Record size including this header
+    vu8 mFlags;
+    u8 mLevel;
+    u8 mCategory;
+    u8 _05[3];
+    const char *mFormat;
+    u32 _0C;
+    OSTime mTime;
+};
+
+constexpr size_t LogHeaderWords = sizeof(LogRecord) / sizeof(u32);
+
+static u32 SMS_ALIGN(32) sLogRing[LogRingWords];
+static u32 sRingHead       = 0;  // Free running, in words
+static u32 sRingTail       = 0;
+static u32 sDroppedRecords = 0;
+static u32 sCategoryMask   = 0xFFFFFFFF;
+
+static TMutex sFlushMutex;
+static char sLineBuffer[LogLineSize];
+
+static u8 SMS_ALIGN(32) sFlushThreadStack[0x2000];
+static OSThread sFlushThread;
+static OSMessageQueue sFlushQueue;
+static OSMessage sFlushMessages[1];
+static bool sIsFlushThreadRunning = false;
+
+// Timestamps count from module init, OSGetTime counts from the year 2000
+static OSTime sLogBaseTime = 0;
+
+static const char *sLevelNames[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+static const char *sCategoryNames[Console::CATEGORY_USER] = {
+    "GENERAL", "SETTINGS", "AUDIO", "STAGE", "PLAYER", "OBJECT", "SUNSCRIPT", "MISC"};
+
+#pragma region FormatParsing
+
+struct FormatSpec {
+    const char *mStart;  // The '%'
+    const char *mEnd;    // One past the conversion
+    u8 mStars;           // '*' fields, each consumes an int before the value
+    bool mIsLongLong;
+    char mConversion;
+};
+
+enum ArgKind { ARG_NONE, ARG_WORD, ARG_DWORD, ARG_DOUBLE, ARG_STRING, ARG_INVALID };
+
+static bool isFlagChar(char c) {
+    return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0';
+}
+
+static bool isDigitChar(char c) { return c >= '0' && c <= '9'; }
+
+// Parses the specification at spec.mStart, both the capture and the formatter
+// walk the string through here so they always agree on the arguments
+static void parseSpec(const char *p, FormatSpec &spec) {
+    spec.mStart      = p++;
+    spec.mStars      = 0;
+    spec.mIsLongLong = false;
+
+    while (isFlagChar(*p))
+        ++p;
+
+    if (*p == '*') {
+        spec.mStars += 1;
+        ++p;
+    }
+    while (isDigitChar(*p))
+        ++p;
+
+    if (*p == '.') {
+        ++p;
+        if (*p == '*') {
+            spec.mStars += 1;
+            ++p;
+        }
+        while (isDigitChar(*p))
+            ++p;
+    }
+
+    while (*p == 'h' || *p == 'l' || *p == 'L' || *p == 'z' || *p == 't' || *p == 'j') {
+        if (p[0] == 'l' && p[1] == 'l')
+            spec.mIsLongLong = true;
+        ++p;
+    }
+
+    spec.mConversion = *p;
+    spec.mEnd        = *p ? p + 1 : p;
+}
+
+static ArgKind getArgKind(const FormatSpec &spec) {
+    switch (spec.mConversion) {
+    case '%':
+        return ARG_NONE;
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        return spec.mIsLongLong ? ARG_DWORD : ARG_WORD;
+    case 'c':
+    case 'p':
+    case 'n':
+        return ARG_WORD;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        return ARG_DOUBLE;
+    case 's':
+        return ARG_STRING;
+    default:
+        return ARG_INVALID;
+    }
+}
+
+#pragma endregion
+
+#pragma region Capture
+
+static size_t captureArgs(const char *msg, va_list vargs, u32 *payload) {
+    size_t words = 0;
+
+    for (const char *p = msg; *p; ++p) {
+        if (*p != '%')
+            continue;
+
+        FormatSpec spec;
+        parseSpec(p, spec);
+
+        const ArgKind kind = getArgKind(spec);
+        if (kind == ARG_INVALID)
+            break;
+
+        // Reserve the worst case so a value is never split
+        if (words + spec.mStars + 2 > LogMaxPayloadWords)
+            break;
+
+        for (u8 i = 0; i < spec.mStars; ++i) {
+            payload[words++] = va_arg(vargs, s32);
+        }
+
+        switch (kind) {
+        case ARG_WORD:
+            payload[words++] = va_arg(vargs, u32);
+            break;
+        case ARG_DWORD: {
+            const u64 value = va_arg(vargs, u64);
+            memcpy(&payload[words], &value, sizeof(value));
+            words += 2;
+            break;
+        }
+        case ARG_DOUBLE: {
+            const f64 value = va_arg(vargs, f64);
+            memcpy(&payload[words], &value, sizeof(value));
+            words += 2;
+            break;
+        }
+        case ARG_STRING: {
+            const char *str = va_arg(vargs, const char *);
+            if (!str)
+                str = "(null)";
+
+            const size_t room = (LogMaxPayloadWords - words - 1) * sizeof(u32) - 1;
+            const size_t len  = Min(strlen(str), room);
+
+            payload[words++] = len;
+            char *dst        = reinterpret_cast<char *>(&payload[words]);
+            memcpy(dst, str, len);
+            dst[len] = '\0';
+            words += (len + sizeof(u32)) / sizeof(u32);
+            break;
+        }
+        default:
+            break;
+        }
+
+        p = spec.mEnd - 1;
+    }
+
+    return words;
+}
+
+static LogRecord *reserveRecord(size_t words) {
+    TAtomicGuard guard;
+
+    size_t offset = sRingHead % LogRingWords;
+    size_t pad    = offset + words > LogRingWords ? LogRingWords - offset : 0;
+
+    if ((sRingHead + pad + words) - sRingTail > LogRingWords) {
+        sDroppedRecords += 1;
+        return nullptr;
+    }
+
+    // Records never wrap, the rest of the ring is skipped instead
+    if (pad > 0) {
+        LogRecord *padding = reinterpret_cast<LogRecord *>(&sLogRing[offset]);
+        padding->mWords    = pad;
+        padding->mFlags    = LOG_FLAG_PADDING | LOG_FLAG_COMMITTED;
+        sRingHead += pad;
+        offset = 0;
+    }
+
+    LogRecord *record = reinterpret_cast<LogRecord *>(&sLogRing[offset]);
+    record->mWords    = words;
+    record->mFlags    = 0;
+    sRingHead += words;
+    return record;
+}
+
+static void pushRecord(Console::Level level, Console::Category category, u8 flags,
+                       const char *msg, va_list vargs) {
+    u32 payload[LogMaxPayloadWords];
+    const size_t payloadWords = captureArgs(msg, vargs, payload);
+    const size_t words        = (LogHeaderWords + payloadWords + 1) & ~1;
+
+    LogRecord *record = reserveRecord(words);
+    if (record) {
+        record->mLevel    = level;
+        record->mCategory = category;
+        record->mFormat   = msg;
+        record->mTime     = OSGetTime();
+        memcpy(record + 1, payload, payloadWords * sizeof(u32));
+
+        // Publish last, the flusher stops at the first uncommitted record
+        record->mFlags = flags | LOG_FLAG_COMMITTED;
+    }
+
+    if (sIsFlushThreadRunning)
+        OSSendMessage(&sFlushQueue, nullptr, OS_MESSAGE_NOBLOCK);
+    else
+        Console::flush();
+}
+
+#pragma endregion
+
+#pragma region Formatting
+
+template <typename T>
+static int formatArg(char *dst, size_t size, const char *spec, const s32 *stars, u8 starCount,
+                     T value) {
+    switch (starCount) {
+    case 0:
+        return snprintf(dst, size, spec, value);
+    case 1:
+        return snprintf(dst, size, spec, stars[0], value);
+    default:
+        return snprintf(dst, size, spec, stars[0], stars[1], value);
+    }
+}
+
+static size_t formatRecord(const LogRecord *record, char *dst, size_t size) {
+    const u32 *payload = reinterpret_cast<const u32 *>(record + 1);
+    size_t length      = 0;
+
+    auto append = [&](int written) {
+        if (written > 0)
+            length = Min(length + written, size - 1);
+    };
+
+    if (!(record->mFlags & LOG_FLAG_PLAIN)) {
+        const OSTime elapsed = record->mTime > sLogBaseTime ? record->mTime - sLogBaseTime : 0;
+        const u32 ms         = static_cast<u32>(OSTicksToMilliseconds(elapsed));
+
+        char categoryName[8];
+        const char *category = sCategoryNames[Console::CATEGORY_USER - 1];
+        if (record->mCategory < Console::CATEGORY_USER) {
+            category = sCategoryNames[record->mCategory];
+        } else {
+            snprintf(categoryName, sizeof(categoryName), "USER%u",
+                     record->mCategory - Console::CATEGORY_USER);
+            category = categoryName;
+        }
+
+        append(snprintf(dst, size, "[%lu.%03lu][%s][%s] ", ms / 1000, ms % 1000, category,
+                        sLevelNames[record->mLevel]));
+    }
+
+    const char *p = record->mFormat;
+    while (*p && length < size - 1) {
+        if (*p != '%') {
+            dst[length++] = *p++;
+            continue;
+        }
+
+        FormatSpec spec;
+        parseSpec(p, spec);
+
+        const ArgKind kind    = getArgKind(spec);
+        const size_t specSize = spec.mEnd - spec.mStart;
+        if (kind == ARG_INVALID || specSize >= LogSpecSize)
+            break;
+
+        if (kind == ARG_NONE) {
+            dst[length++] = '%';
+            p             = spec.mEnd;
+            continue;
+        }
+
+        char specBuf[LogSpecSize];
+        memcpy(specBuf, spec.mStart, specSize);
+        specBuf[specSize] = '\0';
+
+        const s32 *stars = reinterpret_cast<const s32 *>(payload);
+        payload += spec.mStars;
+
+        char *out         = dst + length;
+        const size_t room = size - length;
+
+        switch (kind) {
+        case ARG_WORD:
+            // %n would write through a pointer that is long gone
+            if (spec.mConversion != 'n')
+                append(formatArg(out, room, specBuf, stars, spec.mStars, *payload));
+            payload += 1;
+            break;
+        case ARG_DWORD: {
+            u64 value;
+            memcpy(&value, payload, sizeof(value));
+            append(formatArg(out, room, specBuf, stars, spec.mStars, value));
+            payload += 2;
+            break;
+        }
+        case ARG_DOUBLE: {
+            f64 value;
+            memcpy(&value, payload, sizeof(value));
+            append(formatArg(out, room, specBuf, stars, spec.mStars, value));
+            payload += 2;
+            break;
+        }
+        case ARG_STRING: {
+            const u32 len   = *payload++;
+            const char *str = reinterpret_cast<const char *>(payload);
+            append(formatArg(out, room, specBuf, stars, spec.mStars, str));
+            payload += (len + sizeof(u32)) / sizeof(u32);
+            break;
+        }
+        default:
+            break;
+        }
+
+        p = spec.mEnd;
+    }
+
+    dst[length] = '\0';
+    return length;
+}
+
+#pragma endregion
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Console::flush() {
+    TLock<TMutex> lock(sFlushMutex);
+
+    u32 dropped;
+    {
+        TAtomicGuard guard;
+        dropped         = sDroppedRecords;
+        sDroppedRecords = 0;
+    }
+
+    if (dropped > 0)
+        OSReport("[LOG] Ring full, %lu records dropped!\n", dropped);
+
+    while (sRingTail != sRingHead) {
+        const LogRecord *record =
+            reinterpret_cast<const LogRecord *>(&sLogRing[sRingTail % LogRingWords]);
+        if (!(record->mFlags & LOG_FLAG_COMMITTED))
+            break;
+
+        if (!(record->mFlags & LOG_FLAG_PADDING)) {
+            formatRecord(record, sLineBuffer, LogLineSize);
+            OSReport("%s", sLineBuffer);
+        }
+
+        // Producers only compare against the tail, a single store frees the space
+        sRingTail += record->mWords;
+    }
+}
+
+static void *flushThreadMain(void *arg) {
+    OSMessage msg;
+    while (true) {
+        OSReceiveMessage(&sFlushQueue, &msg, OS_MESSAGE_BLOCK);
+        Console::flush();
+    }
+    return nullptr;
+}
+
+void initLogFlushThread() {
+    sLogBaseTime = OSGetTime();
+    OSInitMessageQueue(&sFlushQueue, sFlushMessages, 1);
+    OSCreateThread(&sFlushThread, flushThreadMain, nullptr,
+                   sFlushThreadStack + sizeof(sFlushThreadStack), sizeof(sFlushThreadStack),
+                   LogThreadPriority, OS_THREAD_ATTR_DETACH);
+    OSResumeThread(&sFlushThread);
+    sIsFlushThreadRunning = true;
+}
+
+BETTER_SMS_FOR_EXPORT bool BetterSMS::Console::isCategoryEnabled(Category category) {
+    return (sCategoryMask & (1U << category)) != 0;
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Console::setCategoryEnabled(Category category,
+                                                                 bool enabled) {
+    if (enabled)
+        sCategoryMask |= (1U << category);
+    else
+        sCategoryMask &= ~(1U << category);
+}
+
+BETTER_SMS_FOR_EXPORT void BetterSMS::Console::record(Level level, Category category,
+                                                     const char *msg, ...) {
+    if (!isCategoryEnabled(category))
+        return;
+
+    if (level == LEVEL_DEBUG && !BetterSMS::isDebugMode())
+        return;
+
+    va_list vargs;
+    va_start(vargs, msg);
+    pushRecord(level, category, 0, msg, vargs);
+    va_end(vargs);
+}
+
 BETTER_SMS_FOR_EXPORT void BetterSMS::Console::log(const char *msg, ...) {
+    if (!isCategoryEnabled(CATEGORY_GENERAL))
+        return;
+
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    pushRecord(LEVEL_INFO, CATEGORY_GENERAL, LOG_FLAG_PLAIN, msg, vargs);
     va_end(vargs);
 }
 
 BETTER_SMS_FOR_EXPORT void BetterSMS::Console::hardwareLog(const char *msg, ...) {
-    if (BetterSMS::isGameEmulated())
+    if (BetterSMS::isGameEmulated() || !isCategoryEnabled(CATEGORY_GENERAL))
         return;
 
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    pushRecord(LEVEL_INFO, CATEGORY_GENERAL, LOG_FLAG_PLAIN, msg, vargs);
     va_end(vargs);
 }
 
 BETTER_SMS_FOR_EXPORT void BetterSMS::Console::emulatorLog(const char *msg, ...) {
-    if (!BetterSMS::isGameEmulated())
+    if (!BetterSMS::isGameEmulated() || !isCategoryEnabled(CATEGORY_GENERAL))
         return;
 
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    pushRecord(LEVEL_INFO, CATEGORY_GENERAL, LOG_FLAG_PLAIN, msg, vargs);
     va_end(vargs);
 }
 
 BETTER_SMS_FOR_EXPORT void BetterSMS::Console::debugLog(const char *msg, ...) {
-    if (!BetterSMS::isDebugMode())
+    if (!BetterSMS::isDebugMode() || !isCategoryEnabled(CATEGORY_GENERAL))
         return;
 
     va_list vargs;
     va_start(vargs, msg);
-    OSReport(msg, vargs);
+    pushRecord(LEVEL_DEBUG, CATEGORY_GENERAL, LOG_FLAG_PLAIN, msg, vargs);
     va_end(vargs);
-}
\ No newline at end of file
+}
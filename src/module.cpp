@@ -14,6 +14,7 @@
 #include "cstd/stdlib.h"
 #include "debug.hxx"
 #include "game.hxx"
+#include "libs/fastmath.hxx"
 #include "libs/optional.hxx"
 #include "loading.hxx"
 #include "logging.hxx"
@@ -95,6 +96,14 @@ using namespace BetterSMS;
 
 // OBJECT
 extern void makeExtendedObjDataTable();
+extern void freezeObjectFactoryTable(TApplication *app);
+extern void processEmitterQueue(TMarDirector *director);
+extern void resetEmitterQueue(TApplication *app);
+extern void resetGenericModelCache(TApplication *app);
+extern void flipGenericDrawStats(TMarDirector *director);
+
+// SUNSCRIPT
+extern void reportSpcBuiltinProfile(TApplication *app);
 
 extern bool BetterAppContextGameBoot(TApplication *app);
 extern bool BetterAppContextGameBootLogo(TApplication *app);
@@ -114,12 +123,11 @@ extern void checkDebugMode(TMario *, bool);
 extern bool updateDebugMode(TMario *);
 extern void updateFluddNozzle(TApplication *);
 
-extern void drawMonitor(TApplication *, const J2DOrthoGraph *);
+extern void updateMonitor(TApplication *);
 extern void resetMonitor(TApplication *);
 
 extern void initFPSMonitor(TApplication *);
 extern void updateFPSMonitor(TApplication *);
-extern void drawFPSMonitor(TApplication *, const J2DOrthoGraph *);
 
 extern void initDebugStateMonitor(TApplication *);
 extern void updateDebugStateMonitor(TApplication *);
@@ -129,6 +137,10 @@ extern void initGameStateMonitor(TApplication *);
 extern void updateGameStateMonitor(TApplication *);
 extern void drawGameStateMonitor(TApplication *, const J2DOrthoGraph *);
 
+extern void initDrawStatsMonitor(TApplication *);
+extern void updateDrawStatsMonitor(TApplication *);
+extern void drawDrawStatsMonitor(TApplication *, const J2DOrthoGraph *);
+
 // GAME
 extern void extendLightEffectToShineCount(TApplication *app);
 
@@ -185,6 +197,9 @@ extern void printStreamInfo(TApplication *app, const J2DOrthoGraph *graph);
 // GRAPHICS
 extern void updateFPS(TMarDirector *);
 extern void updateGammaSetting(TApplication *);
+extern void flipGPTrace(TApplication *);
+extern void clearQuadBatches(TApplication *);
+extern void updateFrameClock(TApplication *);
 
 // LOADING SCREEN
 extern void initLoadingScreen();
@@ -197,15 +212,24 @@ extern void drawUnlockedSettings(TApplication *, const J2DOrthoGraph *);
 extern void resetPlayerDatas(TMarDirector *application);
 
 // SAVE FILE
+extern void initAutoSaveWorker(TApplication *);
 extern void initAutoSaveIcon(TApplication *);
 extern void updateAutoSaveIcon(TApplication *);
-extern void drawAutoSaveIcon(TApplication *, const J2DOrthoGraph *);
 
 // STAGES
 extern void initAreaInfo();
 extern void initializeMapObjWave(TMarDirector *director);
 
 extern void patches_staticResetter(TMarDirector *);
+extern void resetMoveCheckData(TApplication *app);
+extern void reportStaticGridLoad(TMarDirector *director);
+extern void resetBakedCheckData(TApplication *app);
+extern void buildCubeIndices(TMarDirector *director);
+extern void resetCubeIndices(TApplication *app);
+
+// LOGGING
+
+extern void initLogFlushThread();
 
 // TOOLBOX
 
@@ -226,6 +250,7 @@ void __cvt_ull_dbl();
 
 static void initLib() {
     makeExtendedObjDataTable();
+    initLogFlushThread();
     initLoadingScreen();
     initExtendedPlayerAnims();
     initAreaInfo();
@@ -233,6 +258,10 @@ static void initLib() {
 
     initializeTaskBuffers();
 
+    // Frame clock and quad batches are refreshed each loop, before any consumers run
+    Game::addLoopCallback(updateFrameClock);
+    Game::addLoopCallback(clearQuadBatches);
+
     // Toolbox Listener
     Game::addLoopCallback(processCurrentTask);
 
@@ -286,9 +315,9 @@ static void initLib() {
                                          BetterAppContextDirectSettingsMenu);
 
     //// AUTO SAVE
+    Game::addBootCallback(initAutoSaveWorker);
     Game::addBootCallback(initAutoSaveIcon);
     Game::addLoopCallback(updateAutoSaveIcon);
-    Game::addPostDrawCallback(drawAutoSaveIcon);
 
     //// GAME
     Game::addBootCallback(extendLightEffectToShineCount);
@@ -337,12 +366,11 @@ static void initLib() {
 
     Debug::addUpdateCallback(updateFluddNozzle);
 
-    Debug::addDrawCallback(drawMonitor);
+    Debug::addUpdateCallback(updateMonitor);
     Stage::addExitCallback(resetMonitor);
 
     Debug::addInitCallback(initFPSMonitor);
     Debug::addUpdateCallback(updateFPSMonitor);
-    Debug::addDrawCallback(drawFPSMonitor);
 
     Debug::addInitCallback(initGameStateMonitor);
     Debug::addUpdateCallback(updateGameStateMonitor);
@@ -352,6 +380,10 @@ static void initLib() {
     Debug::addUpdateCallback(updateDebugStateMonitor);
     Debug::addDrawCallback(drawDebugStateMonitor);
 
+    Debug::addInitCallback(initDrawStatsMonitor);
+    Debug::addUpdateCallback(updateDrawStatsMonitor);
+    Debug::addDrawCallback(drawDrawStatsMonitor);
+
     Stage::addInitCallback(resetDebugState);
 
     // Music
@@ -365,6 +397,16 @@ static void initLib() {
     Objects::registerObjectAsMisc("ParticleBox", TParticleBox::instantiate);
     Objects::registerObjectAsMisc("SoundBox", TSoundBox::instantiate);
 
+    Stage::addUpdateCallback(processEmitterQueue);
+    Stage::addExitCallback(resetEmitterQueue);
+    Stage::addExitCallback(resetGenericModelCache);
+    Stage::addUpdateCallback(flipGenericDrawStats);
+    Stage::addExitCallback(reportSpcBuiltinProfile);
+
+#if BETTER_SMS_EXTRA_OBJECTS
+    Game::addBootCallback(freezeObjectFactoryTable);
+#endif
+
     Game::addBootCallback(initDebugCallbacks);
 
     Stage::addInitCallback(resetPlayerDatas);
@@ -372,6 +414,7 @@ static void initLib() {
 
     Stage::addInitCallback(updateFPS);
     Stage::addUpdateCallback(updateFPS);
+    Game::addLoopCallback(flipGPTrace);
     Game::addLoopCallback(updateGammaSetting);
 
     // SETTINGS
@@ -381,6 +424,11 @@ static void initLib() {
 
     // PATCHES
     Stage::addInitCallback(patches_staticResetter);
+    Stage::addExitCallback(resetMoveCheckData);
+    Stage::addInitCallback(reportStaticGridLoad);
+    Stage::addExitCallback(resetBakedCheckData);
+    Stage::addInitCallback(buildCubeIndices);
+    Stage::addExitCallback(resetCubeIndices);
 }
 
 static void destroyLib() {}
@@ -417,6 +465,8 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::getCollisionFixesSetting,
                          "getCollisionFixesSetting__9BetterSMSFv");
         KURIBO_EXPORT_AS(BetterSMS::triggerAutoSave, "triggerAutoSave__9BetterSMSFv");
+        KURIBO_EXPORT_AS(BetterSMS::triggerSettingsSave,
+                         "triggerSettingsSave__9BetterSMSFRQ39BetterSMS8Settings13SettingsGroup");
 
         /* SETTINGS */
         KURIBO_EXPORT_AS(BetterSMS::areBugsPatched, "areBugsPatched__9BetterSMSFv");
@@ -439,6 +489,11 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
             "saveSettingsGroup__Q29BetterSMS8SettingsFRQ39BetterSMS8Settings13SettingsGroup");
         KURIBO_EXPORT_AS(BetterSMS::Settings::loadAllSettings,
                          "loadAllSettings__Q29BetterSMS8SettingsFv");
+        KURIBO_EXPORT_AS(
+            BetterSMS::Settings::waitForSettingsGroup,
+            "waitForSettingsGroup__Q29BetterSMS8SettingsFRCQ39BetterSMS8Settings13SettingsGroup");
+        KURIBO_EXPORT_AS(BetterSMS::Settings::waitForAllSettings,
+                         "waitForAllSettings__Q29BetterSMS8SettingsFv");
         KURIBO_EXPORT_AS(BetterSMS::Settings::saveAllSettings,
                          "saveAllSettings__Q29BetterSMS8SettingsFv");
 
@@ -463,6 +518,14 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::Console::emulatorLog, "emulatorLog__Q29BetterSMS7ConsoleFPCce");
         KURIBO_EXPORT_AS(BetterSMS::Console::hardwareLog, "hardwareLog__Q29BetterSMS7ConsoleFPCce");
         KURIBO_EXPORT_AS(BetterSMS::Console::debugLog, "debugLog__Q29BetterSMS7ConsoleFPCce");
+        KURIBO_EXPORT_AS(BetterSMS::Console::record,
+                         "record__Q29BetterSMS7ConsoleFQ39BetterSMS7Console5Level"
+                         "Q39BetterSMS7Console8CategoryPCce");
+        KURIBO_EXPORT_AS(BetterSMS::Console::isCategoryEnabled,
+                         "isCategoryEnabled__Q29BetterSMS7ConsoleFQ39BetterSMS7Console8Category");
+        KURIBO_EXPORT_AS(BetterSMS::Console::setCategoryEnabled,
+                         "setCategoryEnabled__Q29BetterSMS7ConsoleFQ39BetterSMS7Console8Categoryb");
+        KURIBO_EXPORT_AS(BetterSMS::Console::flush, "flush__Q29BetterSMS7ConsoleFv");
 
         /* DEBUG */
         KURIBO_EXPORT_AS(BetterSMS::Debug::addInitCallback,
@@ -492,6 +555,13 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::Loading::setLayout,
                          "setLayout__Q29BetterSMS7LoadingFP9J2DScreen");
         KURIBO_EXPORT_AS(BetterSMS::Loading::setFrameRate, "setFrameRate__Q29BetterSMS7LoadingFf");
+        KURIBO_EXPORT_AS(BetterSMS::Loading::addPreloadCallback,
+                         "addPreloadCallback__Q29BetterSMS7LoadingFPFP12TMarDirector_v");
+        KURIBO_EXPORT_AS(BetterSMS::Loading::getPhase, "getPhase__Q29BetterSMS7LoadingFv");
+        KURIBO_EXPORT_AS(BetterSMS::Loading::addArchivesExpected,
+                         "addArchivesExpected__Q29BetterSMS7LoadingFUlUl");
+        KURIBO_EXPORT_AS(BetterSMS::Loading::reportArchiveLoaded,
+                         "reportArchiveLoaded__Q29BetterSMS7LoadingFUl");
 
         /* PLAYER */
         KURIBO_EXPORT_AS(BetterSMS::Player::getRegisteredData,
@@ -622,6 +692,15 @@ KURIBO_MODULE_BEGIN(BETTER_SMS_MODULE_NAME, BETTER_SMS_AUTHOR_NAME, BETTER_SMS_V
         KURIBO_EXPORT_AS(BetterSMS::Time::calendarToTime,
                          "calendarToTime__Q29BetterSMS4TimeFPcRC14OSCalendarTime");
         KURIBO_EXPORT_AS(BetterSMS::Time::ostime, "ostime__Q29BetterSMS4TimeFv");
+        KURIBO_EXPORT_AS(BetterSMS::Time::frameSeconds, "frameSeconds__Q29BetterSMS4TimeFv");
+        KURIBO_EXPORT_AS(BetterSMS::Time::frameDelta, "frameDelta__Q29BetterSMS4TimeFv");
+
+        /* MATH */
+        KURIBO_EXPORT_AS(BetterSMS::Math::sinTable, "sinTable__Q29BetterSMS4MathFf");
+        KURIBO_EXPORT_AS(BetterSMS::Math::cosTable, "cosTable__Q29BetterSMS4MathFf");
+        KURIBO_EXPORT_AS(BetterSMS::Math::sinCosTable, "sinCosTable__Q29BetterSMS4MathFfRfRf");
+        KURIBO_EXPORT_AS(BetterSMS::Math::batchSinCosTable,
+                         "batchSinCosTable__Q29BetterSMS4MathFPCfPfPfUl");
 
         /* CTYPE */
         KURIBO_EXPORT(isxdigit);
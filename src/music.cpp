@@ -253,7 +253,7 @@ bool AudioStreamer::queueAudio(const AudioPacket &packet) {
         }
     }
 
-    OSReport("[AUDIO_STREAM] Queue is full!\n");
+    Console::record(Console::LEVEL_WARNING, Console::CATEGORY_AUDIO, "Queue is full!\n");
     return false;
 }
 
@@ -482,7 +482,7 @@ SMS_NO_INLINE bool AudioStreamer::seek_() {
 }
 
 void BetterSMS::Music::AudioStreamer::clear_() {
-    OSReport("[AUDIO_STREAM] Clearing audio queue...\n");
+    Console::record(Console::LEVEL_INFO, Console::CATEGORY_AUDIO, "Clearing audio queue...\n");
     mRequestedClear = true;
 }
 
@@ -560,10 +560,12 @@ SMS_NO_INLINE void AudioStreamer::update_() {
         if (mRequestedPlay) {
             mRequestedPlay = false;
             if (!startLowStream()) {
-                OSReport("[AUDIO_STREAM] Failed to start next track!\n");
+                Console::record(Console::LEVEL_WARNING, Console::CATEGORY_AUDIO,
+                                "Failed to start next track!\n");
                 _mIsPlaying = false;
             } else {
-                OSReport("[AUDIO_STREAM] Started next track!\n");
+                Console::record(Console::LEVEL_INFO, Console::CATEGORY_AUDIO,
+                                "Started next track!\n");
                 resetVolumeToFull();
             }
         }
@@ -615,7 +617,7 @@ SMS_NO_INLINE bool AudioStreamer::startLowStream() {
 }
 
 SMS_NO_INLINE void AudioStreamer::pauseLowStream() {
-    OSReport("[AUDIO_STREAM] Pausing stream...\n");
+    Console::record(Console::LEVEL_INFO, Console::CATEGORY_AUDIO, "Pausing stream...\n");
     AISetStreamPlayState(false);
     DVDStopStreamAtEndAsync(&mPauseBlock, nullptr);
     // DVDCancelStreamAsync(&mStopBlock, cbForCancelStreamOnPauseAsync_);
@@ -628,13 +630,13 @@ SMS_NO_INLINE bool AudioStreamer::seekLowStream(s32 streamPos) {
 
     mStreamPos = streamPos;
 
-    OSReport("[AUDIO_STREAM] Seeking to %d\n", streamPos);
+    Console::record(Console::LEVEL_INFO, Console::CATEGORY_AUDIO, "Seeking to %d\n", streamPos);
 
     return DVDCancelStreamAsync(&mSeekBlock, AudioStreamer::cbForCancelStreamOnSeekAsync_);
 }
 
 SMS_NO_INLINE bool AudioStreamer::stopLowStream() {
-    OSReport("[AUDIO_STREAM] Stopping stream...\n");
+    Console::record(Console::LEVEL_INFO, Console::CATEGORY_AUDIO, "Stopping stream...\n");
     AISetStreamVolLeft(0);
     AISetStreamVolRight(0);
     AISetStreamPlayState(false);
@@ -747,7 +749,8 @@ SMS_NO_INLINE void AudioStreamer::cbForCancelStreamOnSeekAsync_(u32 result,
 
 SMS_NO_INLINE void AudioStreamer::cbForStopStreamAtEndAsync_(u32 result,
                                                              DVDCommandBlock *cmdblock) {
-    OSReport("[AUDIO_STREAM] Result: %d, cmdBlockState: %d\n", result, cmdblock->mCurState);
+    Console::record(Console::LEVEL_INFO, Console::CATEGORY_AUDIO,
+                    "Result: %d, cmdBlockState: %d\n", result, cmdblock->mCurState);
 }
 
 #pragma endregion
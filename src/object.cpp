@@ -2,6 +2,7 @@
 #include <JSystem/JGadget/List.hxx>
 #include <SMS/Player/Mario.hxx>
 #include <SMS/Strategic/HitActor.hxx>
+#include <SMS/System/Application.hxx>
 #include <SMS/System/MarNameRefGen.hxx>
 #include <SMS/macros.h>
 #include <SMS/raw_fn.hxx>
@@ -23,10 +24,6 @@ using namespace BetterSMS;
 
 static constexpr size_t sLoadAddrTableSize = 2;
 
-static constexpr size_t sObjExpansionSize = 100;  // Allows up to 100 extra objects
-static constexpr size_t sObjMaxCount      = ObjDataTableSize + sObjExpansionSize;
-static size_t sOBJNewCount                = 0;
-
 // Locates instructions to patch, pointing to our table
 static u16 *sObjLoadAddrTable[sLoadAddrTableSize][2]{
     {(u16 *)SMS_PORT_REGION(0x801B1772, 0x801a962A, 0, 0),
@@ -35,41 +32,159 @@ static u16 *sObjLoadAddrTable[sLoadAddrTableSize][2]{
      (u16 *)SMS_PORT_REGION(0x801B1AFA, 0x801A99B2, 0, 0)}
 };
 
-static ObjData *sObjDataTableNew[ObjDataTableSize + sObjMaxCount];
+// The base table is copied to the heap during library init with room for
+// custom objects after it. Registrations fill that room in place and the
+// table only moves, repointing the game's loads, when it has to grow.
+static constexpr size_t sObjExpansionSize = 100;
+
+static ObjData **sObjDataTableNew = nullptr;
+static size_t sObjDataCustomCount = 0;
+static size_t sObjDataCapacity    = 0;  // Custom entries the current table has room for
+
+static void relocateObjDataTable(size_t capacity) {
+    // Base table minus its default end entry, then our objects, then the default end
+    const size_t baseCount = ObjDataTableSize - 1;
+
+    ObjData **table = static_cast<ObjData **>(
+        Memory::hmalloc(JKRHeap::sRootHeap, sizeof(ObjData *) * (ObjDataTableSize + capacity), 4));
+
+    memcpy(table, sObjDataTable, sizeof(ObjData *) * baseCount);
+    if (sObjDataTableNew) {
+        memcpy(table + baseCount, sObjDataTableNew + baseCount,
+               sizeof(ObjData *) * sObjDataCustomCount);
+    }
+    table[baseCount + sObjDataCustomCount] = sObjDataTable[baseCount];
+
+    {
+        u32 addr = reinterpret_cast<u32>(table);
+        u16 lo   = addr;
+        u16 hi   = (addr >> 16) + (lo >> 15);
+        for (u32 i = 0; i < sLoadAddrTableSize; ++i) {  // Edit instructions to point to our table
+            PowerPC::writeU16(sObjLoadAddrTable[i][0], hi);
+            PowerPC::writeU16(sObjLoadAddrTable[i][1], lo);
+        }
+    }
+
+    if (sObjDataTableNew) {
+        Memory::free(sObjDataTableNew);
+    }
+
+    sObjDataTableNew = table;
+    sObjDataCapacity = capacity;
+}
+
+static void addObjectData(ObjData *data) {
+    if (sObjDataCustomCount == sObjDataCapacity) {
+        relocateObjDataTable(Max(sObjDataCapacity * 2, sObjExpansionSize));
+    }
+
+    // Shift the default end entry down, then fill the slot it left
+    const size_t slot          = ObjDataTableSize - 1 + sObjDataCustomCount;
+    sObjDataTableNew[slot + 1] = sObjDataTableNew[slot];
+    sObjDataTableNew[slot]     = data;
+    sObjDataCustomCount += 1;
+}
 
 template <typename _I, typename _C> struct ObjectCallbackMeta {
     _I mID;
     _C mCallback;
 };
 
-static TGlobalVector<ObjectCallbackMeta<const char *, Objects::NameRefInitializer>> sCustomMapObjList;
-static TGlobalVector<ObjectCallbackMeta<const char *, Objects::NameRefInitializer>>
-    sCustomEnemyObjList;
-static TGlobalVector<ObjectCallbackMeta<const char *, Objects::NameRefInitializer>>
-    sCustomMiscObjList;
+enum class ObjectFactoryKind : u8 { MAP_OBJ, ENEMY, MISC };
+
+struct ObjectFactoryEntry {
+    const char *mName;
+    Objects::NameRefInitializer mCallback;
+    u16 mKeyCode;
+    ObjectFactoryKind mKind;
+};
+
+static TGlobalVector<ObjectFactoryEntry> sCustomObjFactoryList;
 static TGlobalVector<ObjectCallbackMeta<u32, Objects::ObjectInteractor>> sCustomObjInteractionList;
 static TGlobalVector<ObjectCallbackMeta<u32, Objects::ObjectInteractor>> sCustomObjGrabList;
 
+// Open addressed table of indices into sCustomObjFactoryList, keyed by
+// the JDrama key code so scene loads resolve names without a full scan
+static constexpr u16 sObjFactorySlotEmpty = 0xFFFF;
+
+static u16 *sObjFactoryTable    = nullptr;
+static size_t sObjFactoryMask   = 0;
+static bool sIsObjFactoryFrozen = false;
+
+static void freezeObjectFactories() {
+    size_t capacity = 8;
+    while (capacity < sCustomObjFactoryList.size() * 2) {
+        capacity <<= 1;
+    }
+
+    if (sObjFactoryTable) {
+        Memory::free(sObjFactoryTable);
+    }
+
+    sObjFactoryTable =
+        static_cast<u16 *>(Memory::hmalloc(JKRHeap::sRootHeap, sizeof(u16) * capacity, 4));
+    sObjFactoryMask = capacity - 1;
+    memset(sObjFactoryTable, 0xFF, sizeof(u16) * capacity);
+
+    for (size_t i = 0; i < sCustomObjFactoryList.size(); ++i) {
+        size_t slot = sCustomObjFactoryList[i].mKeyCode & sObjFactoryMask;
+        while (sObjFactoryTable[slot] != sObjFactorySlotEmpty) {
+            slot = (slot + 1) & sObjFactoryMask;
+        }
+        sObjFactoryTable[slot] = i;
+    }
+
+    sIsObjFactoryFrozen = true;
+}
+
+static const ObjectFactoryEntry *findObjectFactory(const char *name, ObjectFactoryKind kind) {
+    // Late registrations thaw the table, so rebuild on demand
+    if (!sIsObjFactoryFrozen) {
+        freezeObjectFactories();
+    }
+
+    u16 keyCode = JDrama::TNameRef::calcKeyCode(name);
+
+    size_t slot = keyCode & sObjFactoryMask;
+    while (sObjFactoryTable[slot] != sObjFactorySlotEmpty) {
+        const ObjectFactoryEntry &entry = sCustomObjFactoryList[sObjFactoryTable[slot]];
+        if (entry.mKeyCode == keyCode && entry.mKind == kind && strcmp(entry.mName, name) == 0) {
+            return &entry;
+        }
+        slot = (slot + 1) & sObjFactoryMask;
+    }
+
+    return nullptr;
+}
+
+static bool addObjectFactory(const char *name, Objects::NameRefInitializer initFn,
+                             ObjectFactoryKind kind) {
+    u16 keyCode = JDrama::TNameRef::calcKeyCode(name);
+
+    for (auto &item : sCustomObjFactoryList) {
+        if (item.mKeyCode == keyCode && item.mKind == kind && strcmp(item.mName, name) == 0) {
+            return false;
+        }
+    }
+
+    sCustomObjFactoryList.push_back({name, initFn, keyCode, kind});
+    sIsObjFactoryFrozen = false;
+    return true;
+}
+
 BETTER_SMS_FOR_EXPORT size_t BetterSMS::Objects::getRemainingCapacity() {
-    return sObjExpansionSize - sOBJNewCount;
+    return static_cast<size_t>(-1) - sObjDataCustomCount;
 }
 
 // Map objects (coins, blocks, etc)
 BETTER_SMS_FOR_EXPORT bool
 BetterSMS::Objects::registerObjectAsMapObj(const char *name, ObjData *data,
                                            Objects::NameRefInitializer initFn) {
-    for (auto &item : sCustomMapObjList) {
-        if (strcmp(item.mID, name) == 0) {
-            Console::log("Object '%s' is already registered!\n", name);
-            return false;
-        }
+    if (!addObjectFactory(name, initFn, ObjectFactoryKind::MAP_OBJ)) {
+        Console::log("Object '%s' is already registered!\n", name);
+        return false;
     }
-    sCustomMapObjList.push_back({name, initFn});
-    sObjDataTableNew[ObjDataTableSize + sOBJNewCount] =
-        sObjDataTableNew[ObjDataTableSize + sOBJNewCount -
-                         1];  // Copy the default end to the next position
-    sObjDataTableNew[ObjDataTableSize + sOBJNewCount - 1] = data;
-    sOBJNewCount += 1;
+    addObjectData(data);
     return true;
 }
 
@@ -77,31 +192,21 @@ BetterSMS::Objects::registerObjectAsMapObj(const char *name, ObjData *data,
 BETTER_SMS_FOR_EXPORT bool
 BetterSMS::Objects::registerObjectAsEnemy(const char *name, ObjData *data,
                                           Objects::NameRefInitializer initFn) {
-    for (auto &item : sCustomEnemyObjList) {
-        if (strcmp(item.mID, name) == 0) {
-            Console::log("Enemy '%s' is already registered!\n", name);
-            return false;
-        }
+    if (!addObjectFactory(name, initFn, ObjectFactoryKind::ENEMY)) {
+        Console::log("Enemy '%s' is already registered!\n", name);
+        return false;
     }
-    sCustomEnemyObjList.push_back({name, initFn});
-    sObjDataTableNew[ObjDataTableSize + sOBJNewCount] =
-        sObjDataTableNew[ObjDataTableSize + sOBJNewCount -
-                         1];  // Copy the default end to the next position
-    sObjDataTableNew[ObjDataTableSize + sOBJNewCount - 1] = data;
-    sOBJNewCount += 1;
+    addObjectData(data);
     return true;
 }
 
 // Misc (Managers, tables, etc)
 BETTER_SMS_FOR_EXPORT bool
 BetterSMS::Objects::registerObjectAsMisc(const char *name, Objects::NameRefInitializer initFn) {
-    for (auto &item : sCustomMiscObjList) {
-        if (strcmp(item.mID, name) == 0) {
-            Console::log("Misc object '%s' is already registered!\n", name);
-            return false;
-        }
+    if (!addObjectFactory(name, initFn, ObjectFactoryKind::MISC)) {
+        Console::log("Misc object '%s' is already registered!\n", name);
+        return false;
     }
-    sCustomMiscObjList.push_back({name, initFn});
     return true;
 }
 
@@ -133,33 +238,21 @@ BetterSMS::Objects::registerObjectGrabInteractor(u32 objectID,
 
 // ---------------------------------------- //
 
-// extern -> SME.cpp
-void makeExtendedObjDataTable() {
-    memcpy(sObjDataTableNew, sObjDataTable,
-           sizeof(u32) * ObjDataTableSize);  // last entry is default null
-    {
-        u32 addr = reinterpret_cast<u32>(&sObjDataTableNew);
-        u16 lo   = addr;
-        u16 hi   = (addr >> 16) + (lo >> 15);
-        for (u32 i = 0; i < sLoadAddrTableSize; ++i) {  // Edit instructions to point to our table
-            PowerPC::writeU16(sObjLoadAddrTable[i][0], hi);
-            PowerPC::writeU16(sObjLoadAddrTable[i][1], lo);
-        }
-    }
+// extern -> module.cpp
+BETTER_SMS_FOR_CALLBACK void freezeObjectFactoryTable(TApplication *app) {
+    freezeObjectFactories();
 }
 
+// extern -> module.cpp
+void makeExtendedObjDataTable() { relocateObjDataTable(sObjExpansionSize); }
+
 static JDrama::TNameRef *makeExtendedMapObjFromRef(TMarNameRefGen *nameGen, const char *name) {
     JDrama::TNameRef *obj = nameGen->getNameRef_MapObj(name);
     if (obj)
         return obj;
 
-    for (auto &item : sCustomMapObjList) {
-        if (strcmp(item.mID, name) == 0) {
-            return item.mCallback();
-        }
-    }
-
-    return nullptr;
+    const ObjectFactoryEntry *factory = findObjectFactory(name, ObjectFactoryKind::MAP_OBJ);
+    return factory ? factory->mCallback() : nullptr;
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x8029E120, 0x80295FFC, 0, 0), makeExtendedMapObjFromRef);
 
@@ -168,14 +261,8 @@ static JDrama::TNameRef *makeExtendedBossEnemyFromRef(TMarNameRefGen *nameGen, c
     if (obj)
         return obj;
 
-    for (auto &item : sCustomMiscObjList) {
-        auto &dictItem = item;
-        if (strcmp(item.mID, name) == 0) {
-            return item.mCallback();
-        }
-    }
-
-    return nullptr;
+    const ObjectFactoryEntry *factory = findObjectFactory(name, ObjectFactoryKind::MISC);
+    return factory ? factory->mCallback() : nullptr;
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x8029D2F4, 0x802951D0, 0, 0), makeExtendedBossEnemyFromRef);
 
@@ -186,14 +273,8 @@ static JDrama::TNameRef *makeExtendedGenericFromRef(TMarNameRefGen *nameGen, con
     if (obj)
         return obj;
 
-    for (auto &item : sCustomEnemyObjList) {
-        auto &dictItem = item;
-        if (strcmp(item.mID, name) == 0) {
-            return item.mCallback();
-        }
-    }
-
-    return nullptr;
+    const ObjectFactoryEntry *factory = findObjectFactory(name, ObjectFactoryKind::ENEMY);
+    return factory ? factory->mCallback() : nullptr;
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x8029EDD8, 0, 0, 0), makeExtendedGenericFromRef);
 
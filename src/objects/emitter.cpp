@@ -0,0 +1,66 @@
+#include <Dolphin/types.h>
+#include <SMS/rand.h>
+
+#include "module.hxx"
+#include "p_emitter.hxx"
+
+static constexpr size_t sEmitterQueueCapacity = 256;
+static constexpr size_t sEmitterKindCount     = 2;
+
+struct EmitterRequest {
+    JDrama::TActor *mOwner;
+    EmitterSpawnFn mSpawnFn;
+};
+
+struct EmitterQueue {
+    EmitterRequest mRequests[sEmitterQueueCapacity];
+    size_t mHead;
+    size_t mCount;
+};
+
+// Max spawns drained per frame, indexed by EmitterKind
+static constexpr size_t sEmitterBudget[sEmitterKindCount] = {8, 4};
+
+static EmitterQueue sEmitterQueues[sEmitterKindCount];
+
+bool queueEmitterSpawn(JDrama::TActor *owner, EmitterSpawnFn spawnFn, EmitterKind kind) {
+    EmitterQueue &queue = sEmitterQueues[static_cast<u8>(kind)];
+    if (queue.mCount >= sEmitterQueueCapacity) {
+        return false;
+    }
+
+    size_t tail           = (queue.mHead + queue.mCount) % sEmitterQueueCapacity;
+    queue.mRequests[tail] = {owner, spawnFn};
+    queue.mCount += 1;
+    return true;
+}
+
+s32 getEmitterSpawnPhase(s32 spawnRate) {
+    if (spawnRate <= 0) {
+        return 0;
+    }
+    return rand() % (spawnRate + 1);
+}
+
+BETTER_SMS_FOR_CALLBACK void processEmitterQueue(TMarDirector *director) {
+    for (size_t i = 0; i < sEmitterKindCount; ++i) {
+        EmitterQueue &queue = sEmitterQueues[i];
+
+        size_t spawns = Min(queue.mCount, sEmitterBudget[i]);
+        for (size_t j = 0; j < spawns; ++j) {
+            const EmitterRequest &request = queue.mRequests[queue.mHead];
+            request.mSpawnFn(request.mOwner);
+
+            queue.mHead = (queue.mHead + 1) % sEmitterQueueCapacity;
+            queue.mCount -= 1;
+        }
+    }
+}
+
+// Owners die with the stage, so anything still queued is stale
+BETTER_SMS_FOR_CALLBACK void resetEmitterQueue(TApplication *app) {
+    for (size_t i = 0; i < sEmitterKindCount; ++i) {
+        sEmitterQueues[i].mHead  = 0;
+        sEmitterQueues[i].mCount = 0;
+    }
+}
@@ -19,6 +19,7 @@
 
 #include "libs/constmath.hxx"
 #include "objects/fog.hxx"
+#include "p_gptrace.hxx"
 
 void TSimpleFog::load(JSUMemoryInputStream &in) {
     JDrama::TActor::load(in);
@@ -32,5 +33,7 @@ void TSimpleFog::load(JSUMemoryInputStream &in) {
 }
 
 void TSimpleFog::perform(u32 flags, JDrama::TGraphics *graphics) {
+    TGPZoneScope zone(GP_ZONE_FOG);
+    // Not shadowed, J3D material passes write fog between our performs
     GXSetFog(mType, mStartZ, mEndZ, mNearZ, mFarZ, mColor);
 }
\ No newline at end of file
@@ -3,7 +3,6 @@
 #include <Dolphin/types.h>
 
 #include <JSystem/J3D/J3DModel.hxx>
-#include <JSystem/J3D/J3DModelLoaderDataBase.hxx>
 #include <SMS/Camera/PolarSubCamera.hxx>
 #include <SMS/Enemy/Conductor.hxx>
 #include <SMS/M3DUtil/MActor.hxx>
@@ -20,7 +19,153 @@
 #include <SMS/raw_fn.hxx>
 
 #include "libs/constmath.hxx"
+#include "libs/global_vector.hxx"
+#include "module.hxx"
 #include "objects/generic.hxx"
+#include "p_generic.hxx"
+
+using namespace BetterSMS;
+
+// Every GenericRailObj placed with the same model name and load flags shares
+// one TMActorKeeper. The first instance loads the model and animation data
+// through it, the rest build their J3DModel and MActor on top of that data.
+// The .col header is parsed once per model; the TMapCollisionManager stays
+// per instance since each one transforms its own copy of the triangles.
+//
+// The instances are also kept on their entry so that the first one to reach
+// the draw pass enters all of them back to back, and identical models reach
+// the draw buffers together instead of interleaved with the rest of the
+// manager.
+struct GenericModelCacheEntry {
+    const char *mModelName;
+    u16 mKeyCode;
+    u32 mModelFlags;
+    u32 mRefCount;
+    TMActorKeeper *mKeeper;
+    J3DModelData *mModelData;
+    MActorAnmData *mAnmData;
+    u32 mCollisionTriangles;
+    u32 mLastDrawFrame;
+    TGlobalVector<TGenericRailObj *> mInstances;
+};
+
+static TGlobalVector<GenericModelCacheEntry *> sGenericModelCache;
+
+static GenericDrawStats sDrawStats              = {};
+static GenericDrawStats sLastDrawStats          = {};
+static u32 sDrawFrame                           = 2;
+static const GenericModelCacheEntry *sLastEntry = nullptr;
+
+static u32 countCollisionTriangles(const char *modelName) {
+    char path[128];
+    snprintf(path, 128, "/scene/mapObj/%s.col", modelName);
+
+    const u8 *col = static_cast<const u8 *>(JKRFileLoader::getGlbResource(path));
+    if (!col)
+        return 0;
+
+    const u32 groupCount  = *reinterpret_cast<const u32 *>(col + 0x8);
+    const u32 groupOffset = *reinterpret_cast<const u32 *>(col + 0xC);
+
+    u32 triangles = 0;
+    for (u32 i = 0; i < groupCount; ++i) {
+        triangles += *reinterpret_cast<const u16 *>(col + groupOffset + (i * 0x18) + 0x2);
+    }
+    return triangles;
+}
+
+static GenericModelCacheEntry *acquireGenericModel(TLiveManager *manager, const char *modelName,
+                                                   u32 modelFlags) {
+    u16 keyCode = JDrama::TNameRef::calcKeyCode(modelName);
+
+    for (auto *entry : sGenericModelCache) {
+        if (entry->mKeyCode == keyCode && entry->mModelFlags == modelFlags &&
+            strcmp(entry->mModelName, modelName) == 0) {
+            entry->mRefCount += 1;
+            return entry;
+        }
+    }
+
+    // The entry itself is ours, the keeper and model data belong to the stage heap
+    auto *entry                = new (JKRHeap::sSystemHeap, 4) GenericModelCacheEntry();
+    entry->mModelName          = modelName;
+    entry->mKeyCode            = keyCode;
+    entry->mModelFlags         = modelFlags;
+    entry->mRefCount           = 1;
+    entry->mKeeper             = new TMActorKeeper(manager, 1);
+    entry->mModelData          = nullptr;
+    entry->mAnmData            = nullptr;
+    entry->mCollisionTriangles = countCollisionTriangles(modelName);
+    entry->mLastDrawFrame      = 0;
+
+    entry->mKeeper->mModelFlags = modelFlags;
+
+    sGenericModelCache.push_back(entry);
+    return entry;
+}
+
+static MActor *createGenericActor(GenericModelCacheEntry *entry, u32 sdlFlags) {
+    if (!entry->mModelData) {
+        char modelPath[128];
+        snprintf(modelPath, 128, "%s.bmd", entry->mModelName);
+
+        // Loaded from wherever the keeper resolves its resources, anims included
+        MActor *actor = entry->mKeeper->createMActor(modelPath, sdlFlags);
+        if (actor) {
+            entry->mModelData = actor->mModel->mModelData;
+            entry->mAnmData   = actor->mAnmData;
+        }
+        return actor;
+    }
+
+    MActor *actor = new MActor(entry->mAnmData);
+    actor->setModel(new J3DModel(entry->mModelData, sdlFlags, 1), 0);
+    return actor;
+}
+
+static void releaseGenericModel(GenericModelCacheEntry *entry, TGenericRailObj *instance) {
+    for (auto it = entry->mInstances.begin(); it != entry->mInstances.end(); ++it) {
+        if (*it == instance) {
+            entry->mInstances.erase(it);
+            break;
+        }
+    }
+
+    for (auto it = sGenericModelCache.begin(); it != sGenericModelCache.end(); ++it) {
+        if (*it != entry) {
+            continue;
+        }
+
+        // Other placements may still draw from the keeper's data, and the
+        // stage heap reclaims it either way
+        entry->mRefCount -= 1;
+        if (entry->mRefCount == 0) {
+            sGenericModelCache.erase(it);
+            delete entry;
+        }
+        return;
+    }
+}
+
+// The keepers go with the stage heap, only the entries need freeing here
+BETTER_SMS_FOR_CALLBACK void resetGenericModelCache(TApplication *app) {
+    for (auto *entry : sGenericModelCache) {
+        delete entry;
+    }
+    sGenericModelCache.clear();
+    sDrawStats     = {};
+    sLastDrawStats = {};
+    sLastEntry     = nullptr;
+}
+
+const GenericDrawStats &getGenericDrawStats() { return sLastDrawStats; }
+
+BETTER_SMS_FOR_CALLBACK void flipGenericDrawStats(TMarDirector *director) {
+    sLastDrawStats = sDrawStats;
+    sDrawStats     = {};
+    sLastEntry     = nullptr;
+    sDrawFrame += 1;
+}
 
 static void clampRotation(TVec3f &rotation) {
     auto clampPreserve = [](f32 degrees) {
@@ -37,13 +182,62 @@ static void clampRotation(TVec3f &rotation) {
 }
 
 void TGenericRailObj::perform(u32 flags, JDrama::TGraphics *graphics) {
-    if ((flags & 0x200)) {
-        mActorData->mUseDisplayList = true;
+    if (!(flags & 0x200)) {
+        TRailMapObj::perform(flags, graphics);
+        return;
+    }
+
+    mLastPerformFrame = sDrawFrame;
+
+    // Already entered by the first instance of this model to reach the draw pass
+    if (mLastEntryFrame != sDrawFrame) {
+        if (mModelCache && mModelCache->mLastDrawFrame != sDrawFrame) {
+            // Only siblings that drew themselves last frame are known to be in
+            // the draw pass, the rest keep entering on their own
+            for (auto *instance : mModelCache->mInstances) {
+                if (instance->mLastPerformFrame + 1 >= sDrawFrame)
+                    instance->entryModel(graphics);
+            }
+        }
+        if (mLastEntryFrame != sDrawFrame)
+            entryModel(graphics);
+    }
+
+    if (flags & ~0x200)
+        TRailMapObj::perform(flags & ~0x200, graphics);
+}
+
+void TGenericRailObj::entryModel(JDrama::TGraphics *graphics) {
+    mLastEntryFrame             = sDrawFrame;
+    mActorData->mUseDisplayList = true;
+
+    // Static models build their display list on the first draw and replay it
+    // from then on; anything animated or moving rebuilds it every frame
+    if (mIsStaticModel && mIsDisplayListBuilt) {
+        if (!mIsDisplayListLocked) {
+            mActorData->lockDLIfNeed();
+            mIsDisplayListLocked = true;
+        }
+        sDrawStats.mCachedDraws += 1;
+    } else {
         mActorData->unlockDLIfNeed();
         mActorData->offMakeDL();
+        mIsDisplayListBuilt = true;
+        sDrawStats.mDynamicDraws += 1;
+    }
+
+    if (!mModelCache) {
+        sDrawStats.mModels += 1;
+    } else if (mModelCache->mLastDrawFrame != sDrawFrame) {
+        mModelCache->mLastDrawFrame = sDrawFrame;
+        sDrawStats.mModels += 1;
     }
 
-    TRailMapObj::perform(flags, graphics);
+    if (!mModelCache || mModelCache != sLastEntry)
+        sDrawStats.mRuns += 1;
+    sLastEntry = mModelCache;
+
+    TRailMapObj::perform(0x200, graphics);
 }
 
 void TGenericRailObj::load(JSUMemoryInputStream &in) {
@@ -82,16 +276,12 @@ void TGenericRailObj::load(JSUMemoryInputStream &in) {
 }
 
 void TGenericRailObj::makeMActors() {
-    mActorKeeper = new TMActorKeeper(mLiveManager, 1);
-    if (mModelLoadFlags & 0x8000)
-        mActorKeeper->mModelFlags = 0x112F0000;
-    else
-        mActorKeeper->mModelFlags = 0x102F0000;
+    u32 modelFlags = (mModelLoadFlags & 0x8000) ? 0x112F0000 : 0x102F0000;
 
-    char modelPath[128];
-    snprintf(modelPath, 128, "%s.bmd", mModelName);
-
-    mActorData = mActorKeeper->createMActor(modelPath, getSDLModelFlag());
+    mModelCache  = acquireGenericModel(mLiveManager, mModelName, modelFlags);
+    mActorKeeper = mModelCache->mKeeper;
+    mModelCache->mInstances.push_back(this);
+    mActorData   = createGenericActor(mModelCache, getSDLModelFlag());
 
     if (mModelLoadFlags & 0x4000) {
         mActorData->setLightID(0);
@@ -103,11 +293,14 @@ void TGenericRailObj::makeMActors() {
     mActorData->viewCalc();
 }
 
-void TGenericRailObj::initMapCollisionData() {
-    char colPath[128];
-    snprintf(colPath, 128, "/scene/MapObj/%s.col", mModelName);
+TGenericRailObj::~TGenericRailObj() {
+    if (mModelCache) {
+        releaseGenericModel(mModelCache, this);
+    }
+}
 
-    if (!JKRArchive::getGlbResource(colPath))
+void TGenericRailObj::initMapCollisionData() {
+    if (!mModelCache || mModelCache->mCollisionTriangles == 0)
         return;
 
     mCollisionManager = new TMapCollisionManager(1, "mapObj", this);
@@ -124,6 +317,32 @@ void TGenericRailObj::initMapObj() {
     }
 
     playAnimations(J3DFrameCtrl::LOOP);
+
+    mIsStaticModel       = checkStaticModel();
+    mIsDisplayListBuilt  = false;
+    mIsDisplayListLocked = false;
+}
+
+bool TGenericRailObj::checkStaticModel() const {
+    if (mContactAnim > 0)
+        return false;
+
+    if (mBaseRotation.x != 0.0f || mBaseRotation.y != 0.0f || mBaseRotation.z != 0.0f)
+        return false;
+
+    TGraphWeb *graph = mGraphTracer->mGraph;
+    if (graph && !graph->isDummy())
+        return false;
+
+    const int anmTypes[] = {MActor::BCK, MActor::BLK, MActor::BRK,
+                            MActor::BPK, MActor::BTP, MActor::BTK};
+    for (auto type : anmTypes) {
+        auto *frameCtrl = mActorData->getFrameCtrl(type);
+        if (frameCtrl && frameCtrl->mFrameRate != 0.0f)
+            return false;
+    }
+
+    return true;
 }
 
 void TGenericRailObj::control() {
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Dolphin/types.h>
+#include <JSystem/JDrama/JDRActor.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/MarDirector.hxx>
+
+// Spawns from volumetric emitters (TParticleBox, TSoundBox) are queued here
+// and drained under a per-frame budget so many boxes firing on the same
+// frame are spread across the following frames instead.
+
+enum class EmitterKind : u8 {
+    Particle,
+    Sound,
+};
+
+typedef void (*EmitterSpawnFn)(JDrama::TActor *owner);
+
+// Returns false if the queue for this kind is full; the caller should retry next frame
+bool queueEmitterSpawn(JDrama::TActor *owner, EmitterSpawnFn spawnFn, EmitterKind kind);
+
+// Random starting timer in [0, spawnRate] so boxes loaded together fire out of phase
+s32 getEmitterSpawnPhase(s32 spawnRate);
+
+void processEmitterQueue(TMarDirector *director);
+void resetEmitterQueue(TApplication *app);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Dolphin/types.h>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/MarDirector.hxx>
+
+// Per frame draw submissions of TGenericRailObj, split by whether the model
+// replayed its locked display list or rebuilt it. Models counts the distinct
+// shared models those draws came from, and Runs how often consecutive entries
+// switched model. With the instances grouped the two are equal.
+struct GenericDrawStats {
+    u32 mCachedDraws;
+    u32 mDynamicDraws;
+    u32 mModels;
+    u32 mRuns;
+};
+
+// Stats for the last completed frame
+const GenericDrawStats &getGenericDrawStats();
+
+void flipGenericDrawStats(TMarDirector *director);
@@ -11,6 +11,7 @@
 #include "libs/boundbox.hxx"
 #include "libs/constmath.hxx"
 #include "objects/particle.hxx"
+#include "p_emitter.hxx"
 
 constexpr float BinEditorScale = 130.0f;
 
@@ -24,6 +25,8 @@ void TParticleBox::load(JSUMemoryInputStream &in) {
     in.readData(&mShape, 1);
     in.readData(&mIsStrict, 1);
 
+    mSpawnTimer = getEmitterSpawnPhase(mSpawnRate);
+
     if (strcmp(mParticleName, "(null)") == 0) {
         mParticleName = nullptr;
         return;
@@ -65,31 +68,55 @@ void TParticleBox::load(JSUMemoryInputStream &in) {
 
 void TParticleBox::loadAfter() {}
 
-void TParticleBox::perform(u32 flags, JDrama::TGraphics *) {
+void TParticleBox::perform(u32 flags, JDrama::TGraphics *graphics) {
     if ((flags & 1)) {
         control();
     }
 
     if ((flags & 2)) {
-        if (mID != -1) {
-            auto bb = BoundingBox(mTranslation, mScale, mRotation);
-            if (mIsStrict && !bb.contains(gpCamera->mTranslation, BinEditorScale, mShape)) {
+        if (mID == -1 || mIsSpawnQueued) {
+            return;
+        }
+
+        if (mSpawnTimer < mSpawnRate) {
+            mSpawnTimer += 1;
+            return;
+        }
+
+        // Cheap sphere reject before building the box for the strict test
+        f32 radius = PSVECMag(reinterpret_cast<Vec *>(&mScale)) * BinEditorScale * 0.5f;
+        if (!ViewFrustumClipCheck__FPQ26JDrama9TGraphicsP3Vecf(
+                graphics, reinterpret_cast<Vec *>(&mTranslation), radius)) {
+            return;
+        }
+
+        if (mIsStrict) {
+            mBounds.set(mTranslation, mScale, mRotation);
+            if (!mBounds.contains(gpCamera->mTranslation, BinEditorScale, mShape)) {
                 return;
             }
-            if (mSpawnTimer++ >= mSpawnRate) {
-                TVec3f position = getRandomParticlePosition(bb);
-                auto *particle  = gpMarioParticleManager->emit(mID, &position, 1, this);
-                if (particle) {
-                    f32 scale        = mSpawnScale * mCurScale;
-                    particle->mSize1 = {scale, scale, scale};
-                    particle->mSize3 = {scale, scale, scale};
-                }
-                mSpawnTimer = 0;
-            }
         }
+
+        mIsSpawnQueued = queueEmitterSpawn(this, emitQueued, EmitterKind::Particle);
     }
 }
 
+void TParticleBox::emitQueued(JDrama::TActor *owner) {
+    auto *box = static_cast<TParticleBox *>(owner);
+
+    box->mBounds.set(box->mTranslation, box->mScale, box->mRotation);
+    TVec3f position = box->getRandomParticlePosition(box->mBounds);
+    auto *particle  = gpMarioParticleManager->emit(box->mID, &position, 1, box);
+    if (particle) {
+        f32 scale        = box->mSpawnScale * box->mCurScale;
+        particle->mSize1 = {scale, scale, scale};
+        particle->mSize3 = {scale, scale, scale};
+    }
+
+    box->mSpawnTimer    = 0;
+    box->mIsSpawnQueued = false;
+}
+
 void TParticleBox::control() {
     TGraphWeb *graph = mGraphTracer->mGraph;
     if (!graph || graph->isDummy() || !mIsMoving) {
@@ -203,7 +230,7 @@ void TParticleBox::readRailFlag() {
     }
 }
 
-TVec3f TParticleBox::getRandomParticlePosition(const BoundingBox &bb) const {
+TVec3f TParticleBox::getRandomParticlePosition(const CachedBoundingBox &bb) const {
     // Get random sample
     f32 sampleX = rand() / 32768.0f;
     f32 sampleY = rand() / 32768.0f;
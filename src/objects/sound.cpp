@@ -11,6 +11,7 @@
 #include "libs/boundbox.hxx"
 #include "libs/constmath.hxx"
 #include "objects/sound.hxx"
+#include "p_emitter.hxx"
 
 constexpr float BinEditorScale = 130.0f;
 
@@ -22,28 +23,44 @@ void TSoundBox::load(JSUMemoryInputStream &in) {
     in.readData(&mPitch, 4);
     in.readData(&mSpawnRate, 4);
     in.readData(&mShape, 1);
+
+    mSpawnTimer = getEmitterSpawnPhase(mSpawnRate);
 }
 
 void TSoundBox::perform(u32 flags, JDrama::TGraphics *) {
     if ((flags & 2)) {
-        if (mID != -1) {
-            auto bb = BoundingBox(mTranslation, mScale, mRotation);
-            if (mSpawnTimer++ >= mSpawnRate) {
-                mSoundPos = getRandomParticlePosition(bb);
-                if (gpMSound->gateCheck(mID)) {
-                    auto *sound = MSoundSE::startSoundActor(mID, mSoundPos, 0, nullptr, 0, 4);
-                    if (sound) {
-                        sound->setVolume(mVolume, 0, 0);
-                        sound->setPitch(mPitch, 0, 0);
-                    }
-                }
-                mSpawnTimer = 0;
-            }
+        if (mID == -1 || mIsSpawnQueued) {
+            return;
+        }
+
+        if (mSpawnTimer < mSpawnRate) {
+            mSpawnTimer += 1;
+            return;
+        }
+
+        // Sounds are audible off screen, so these are never frustum culled
+        mIsSpawnQueued = queueEmitterSpawn(this, emitQueued, EmitterKind::Sound);
+    }
+}
+
+void TSoundBox::emitQueued(JDrama::TActor *owner) {
+    auto *box = static_cast<TSoundBox *>(owner);
+
+    box->mBounds.set(box->mTranslation, box->mScale, box->mRotation);
+    box->mSoundPos = box->getRandomParticlePosition(box->mBounds);
+    if (gpMSound->gateCheck(box->mID)) {
+        auto *sound = MSoundSE::startSoundActor(box->mID, box->mSoundPos, 0, nullptr, 0, 4);
+        if (sound) {
+            sound->setVolume(box->mVolume, 0, 0);
+            sound->setPitch(box->mPitch, 0, 0);
         }
     }
+
+    box->mSpawnTimer    = 0;
+    box->mIsSpawnQueued = false;
 }
 
-TVec3f TSoundBox::getRandomParticlePosition(const BoundingBox &bb) const {
+TVec3f TSoundBox::getRandomParticlePosition(const CachedBoundingBox &bb) const {
     // Get random sample
     f32 sampleX = rand() / 32768.0f;
     f32 sampleY = rand() / 32768.0f;
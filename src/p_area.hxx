@@ -15,10 +15,40 @@ namespace BetterSMS {
             s32 mShineID;
         };
 
+        struct ScenarioEntry {
+            s32 mScenarioID;
+            s32 mScenarioNameID;
+        };
+
+        // Frozen view of a ShineAreaInfo, indexing into one contiguous scenario table
+        // (normal scenarios first, ex scenarios immediately after)
+        struct FrozenShineArea {
+            [[nodiscard]] bool isValid() const { return mScenarios != nullptr; }
+
+            [[nodiscard]] size_t getScenarioCount() const { return mScenarioCount; }
+            [[nodiscard]] size_t getExScenarioCount() const { return mExScenarioCount; }
+
+            [[nodiscard]] const ScenarioEntry *getScenario(u32 index) const {
+                return index < mScenarioCount ? &mScenarios[index] : nullptr;
+            }
+
+            [[nodiscard]] const ScenarioEntry *getExScenario(u32 index) const {
+                return index < mExScenarioCount ? &mScenarios[mScenarioCount + index] : nullptr;
+            }
+
+            const ScenarioEntry *mScenarios;
+            u32 mShineSelectPaneID;
+            u16 mScenarioCount;
+            u16 mExScenarioCount;
+        };
+
         ShineAreaInfo **getShineAreaInfos();
         NormalAreaInfo *getNormalAreaInfos();
         ExAreaInfo *getExAreaInfos();
 
+        void freezeShineAreaInfos();
+        const FrozenShineArea &getFrozenShineArea(u32 shineStageID);
+
     }  // namespace Stage
 
-}  // namespace BetterSMS
\ No newline at end of file
+}  // namespace BetterSMS
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Dolphin/CARD.h>
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+
+// Milliseconds slept between attempts while the card is busy
+constexpr u32 CardRetryInterval = 2;
+
+struct CardRetrySleep {
+    OSAlarm mAlarm;  // First, so the alarm handler can find the queue
+    OSMessageQueue mQueue;
+    OSMessage mMessage;
+};
+
+inline void cbForCardRetryAlarm(OSAlarm *alarm, OSContext *context) {
+    auto *sleep = reinterpret_cast<CardRetrySleep *>(alarm);
+    OSSendMessage(&sleep->mQueue, nullptr, OS_MESSAGE_NOBLOCK);
+}
+
+// Issues a synchronous CARD call again for as long as the card is busy with
+// someone else's operation, a busy result means the call never started.
+// OSYieldThread only gives way to threads of equal or higher priority, so
+// the caller sleeps between attempts instead and whoever holds the card
+// gets to finish at any priority.
+template <typename T> s32 retryWhileBusy(T cardOp) {
+    s32 result = cardOp();
+    if (result != CARD_ERROR_BUSY)
+        return result;
+
+    CardRetrySleep sleep;
+    OSInitMessageQueue(&sleep.mQueue, &sleep.mMessage, 1);
+    OSCreateAlarm(&sleep.mAlarm);
+
+    do {
+        OSSetAlarm(&sleep.mAlarm, OSMillisecondsToTicks(CardRetryInterval), cbForCardRetryAlarm);
+        OSReceiveMessage(&sleep.mQueue, nullptr, OS_MESSAGE_BLOCK);
+    } while ((result = cardOp()) == CARD_ERROR_BUSY);
+
+    return result;
+}
+
+#define CARD_RETRY(call) retryWhileBusy([&]() -> s32 { return call; })
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+#include <JSystem/J2D/J2DOrthoGraph.hxx>
+#include <JSystem/J2D/J2DScreen.hxx>
+
+// Records a J2D screen into a GX display list and replays it until the owner
+// invalidates it, so menus only walk their pane tree when something changed.
+// The ortho setup stays outside of the list and must be done before draw(),
+// which issues it again after the list so GX's copy of the state stays true.
+// Screens that outgrow the buffer are drawn immediately instead. The buffer
+// is on the system heap, so the owning director must release() it on exit;
+// its screens are reclaimed with the stage heap and never destroyed.
+
+class TDisplayListCache {
+public:
+    TDisplayListCache(size_t capacity)
+        : mBuffer(nullptr), mCapacity(capacity), mSize(0), mIsValid(false),
+          mIsOverflowed(false) {}
+    ~TDisplayListCache();
+
+    bool isValid() const { return mIsValid; }
+    void invalidate() { mIsValid = false; }
+    void release();
+
+    void draw(J2DScreen *screen, J2DOrthoGraph *ortho);
+
+private:
+    bool record(J2DScreen *screen, J2DOrthoGraph *ortho);
+
+    void *mBuffer;
+    size_t mCapacity;
+    u32 mSize;
+    bool mIsValid;
+    bool mIsOverflowed;
+};
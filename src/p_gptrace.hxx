@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Dolphin/types.h>
+#include <SMS/System/Application.hxx>
+
+// Attributes the GP FIFO traffic BetterSMS generates to the render feature
+// that generated it. Every zone brackets a piece of our own drawing; the
+// CPU FIFO write pointer is sampled on entry and exit and the difference is
+// charged to the zone. The write pointer moves in 32 byte bursts, so single
+// frame numbers are rounded to a burst, but the rounding cancels out over the
+// averaging window. Debug builds only.
+//
+// A capture request additionally flushes the write gather pipe at every zone
+// boundary for one frame and tees the exact command bytes into a buffer for
+// tools/FifoAnalyzer. The buffer layout below must match that tool.
+
+enum GPTraceZone {
+    GP_ZONE_SETUP,        // 2D ortho and viewport setup of the draw handler
+    GP_ZONE_LOADING,      // Loading screen and progress bars
+    GP_ZONE_DEBUG,        // Debug quads and debug page callbacks
+    GP_ZONE_POST_DRAW,    // Module post draw callbacks (HUD)
+    GP_ZONE_OVERLAY,      // Overlay quads such as the autosave icon
+    GP_ZONE_FOG,          // SimpleFog
+    GP_ZONE_COPY_FILTER,  // AA and copy filter injection
+    GP_ZONE_SCISSOR,      // Widescreen scissor fixes
+    GP_ZONE_COUNT
+};
+
+struct GPZoneStats {
+    u32 mBytes;    // Averaged over the last GPTraceWindow frames
+    u32 mEntries;  // Times the zone was entered last frame
+};
+
+constexpr u32 GPTraceWindow = 32;
+
+constexpr u32 GPCaptureMagic    = 0x47505452;  // 'GPTR'
+constexpr u32 GPCaptureVersion  = 1;
+constexpr size_t GPCaptureSize  = 0x20000;
+constexpr size_t GPZoneNameSize = 16;
+
+// All fields big endian, records follow the header back to back
+struct GPCaptureHeader {
+    u32 mMagic;
+    u32 mVersion;
+    u32 mZoneCount;
+    u32 mRecordCount;
+    u32 mDataSize;  // Bytes of records following the header
+    u32 mDroppedBytes;
+    char mZoneNames[GP_ZONE_COUNT][GPZoneNameSize];
+};
+
+// Size is padded to 4 bytes after the command bytes
+struct GPCaptureRecord {
+    u8 mZone;
+    u8 _01[3];
+    u32 mSize;
+};
+
+class TGPZoneScope {
+public:
+    TGPZoneScope(GPTraceZone zone);
+    ~TGPZoneScope();
+
+private:
+    GPTraceZone mZone;
+    u32 mStart;
+};
+
+const GPZoneStats &getGPZoneStats(GPTraceZone zone);
+const char *getGPZoneName(GPTraceZone zone);
+
+// Tees the next frame into the capture buffer
+void requestGPCapture();
+
+void flipGPTrace(TApplication *app);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Dolphin/GX.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/J2D/J2DOrthoGraph.hxx>
+#include <JSystem/JUtility/JUTTexture.hxx>
+#include <JSystem/JUtility/JUTColor.hxx>
+#include <SMS/System/Application.hxx>
+
+// Immediate mode 2D quads collected during the game loop and submitted by the
+// draw handler with a single GX setup per layer. Quads are drawn in the order
+// they were pushed, and each run of consecutive quads sharing a texture or
+// glyph page goes out as one GXBegin, so overlapping quads never reorder.
+// Each flush restores the screen's 2D setup first, since the callbacks drawn
+// before a layer may leave any projection or TEV state behind.
+
+enum QuadLayer {
+    QUAD_LAYER_LOADING,  // Pushed and drawn by the loading screen itself
+    QUAD_LAYER_DEBUG,    // Drawn before the debug draw callbacks
+    QUAD_LAYER_OVERLAY,  // Drawn after the game post draw callbacks
+    QUAD_LAYER_COUNT
+};
+
+// Glyph pages of a ResFONT, so text can be pushed as quads instead of going
+// through J2DTextBox, which loads a page and sets up GX for every character
+class TQuadFont {
+public:
+    static constexpr size_t BlockMax = 4;
+
+    struct Glyph {
+        const GXTexObj *mPage;
+        f32 mU1, mV1, mU2, mV2;
+        u8 mKerning;
+        u8 mWidth;
+        u16 mCellWidth;
+    };
+
+    TQuadFont()
+        : mFont(nullptr), mInfo(nullptr), mPages(nullptr), mWidthCount(0), mGlyphCount(0),
+          mMapCount(0) {}
+
+    bool init(const void *font);
+    bool isValid() const { return mFont != nullptr && mGlyphCount > 0; }
+    bool getGlyph(u8 character, Glyph &out) const;
+
+private:
+    int getFontCode(int character) const;
+
+    const u8 *mFont;
+    const u8 *mInfo;
+    GXTexObj *mPages;  // Every page of every glyph block, in block order
+    const u8 *mWidths[BlockMax];
+    const u8 *mGlyphs[BlockMax];
+    const u8 *mMaps[BlockMax];
+    u16 mFirstPage[BlockMax];
+    size_t mWidthCount;
+    size_t mGlyphCount;
+    size_t mMapCount;
+};
+
+class TQuadBatch {
+public:
+    static constexpr size_t QuadMax = 256;
+
+    struct Quad {
+        JUTTexture *mTexture;     // Loaded as is, or
+        const GXTexObj *mGlyphs;  // a glyph page, coloured by the quad
+        f32 mX, mY, mW, mH;
+        f32 mU1, mV1, mU2, mV2;
+        JUtility::TColor mColor;
+    };
+
+    TQuadBatch() : mQuadCount(0) {}
+
+    size_t size() const { return mQuadCount; }
+
+    void pushFill(f32 x, f32 y, f32 w, f32 h, JUtility::TColor color);
+    void pushTexture(JUTTexture *texture, f32 x, f32 y, f32 w, f32 h,
+                     JUtility::TColor color = {255, 255, 255, 255});
+    void pushText(const TQuadFont &font, f32 x, f32 y, f32 charW, f32 charH, const char *text,
+                  JUtility::TColor color);
+    void clear() { mQuadCount = 0; }
+    void flush(const J2DOrthoGraph *ortho);
+
+private:
+    Quad *pushQuad(f32 x, f32 y, f32 w, f32 h, JUtility::TColor color);
+
+    Quad mQuads[QuadMax];
+    size_t mQuadCount;
+};
+
+TQuadBatch &getQuadBatch(QuadLayer layer);
+const TQuadFont &getSystemQuadFont();
+
+void flushQuadBatch(QuadLayer layer, const J2DOrthoGraph *ortho);
+void clearQuadBatches(TApplication *app);
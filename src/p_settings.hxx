@@ -20,17 +20,29 @@
 #include "libs/global_vector.hxx"
 #include "memory.hxx"
 #include "module.hxx"
+#include "p_displaylist.hxx"
 #include "p_icons.hxx"
 #include "settings.hxx"
 
 using namespace BetterSMS;
 
 void InitCard();
+void NormalizeSettingsPath(const Settings::SettingsSaveInfo &info, char *out);
+s32 UpdateSettingsStatus(CARDFileInfo *finfo, const Settings::SettingsSaveInfo &info,
+                         u32 iconAddr);
 s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, bool canCreate);
 s32 UpdateSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo);
 s32 ReadSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo);
 s32 CloseSavedSettings(const Settings::SettingsGroup &group, CARDFileInfo *finfo);
 s32 SaveAllSettings();
+void SaveOptionBlock();
+void waitForCoreSettings();
+
+// Hands the settings menu's save to the autosave worker, which writes the
+// option block and every settings group. The result is taken once, with
+// the CARD status of the write.
+void requestMenuSave();
+bool takeMenuSaveResult(s32 &status);
 
 const u8 SMS_ALIGN(32) gSaveBnr[] = {
     0x09, 0x00, 0x00, 0x60, 0x00, 0x20, 0x00, 0x00, 0x01, 0x02, 0x00, 0xd0, 0x00, 0x00, 0x0c, 0x20,
@@ -450,7 +462,8 @@ public:
     friend class SaveErrorPanel;
 
     SettingsDirector()
-        : TDirector(), mState(State::INIT), mDisplay(nullptr), mController(nullptr) {}
+        : TDirector(), mState(State::INIT), mDisplay(nullptr), mController(nullptr),
+          mSettingScreen(nullptr) {}
     ~SettingsDirector() override;
 
     s32 direct() override;
@@ -472,11 +485,9 @@ private:
     void initializeErrorLayout();
     void initializeIntSettingLayout();
     void saveSettings();
-    void saveSettings_();
     void failSave(int errorcode);
 
     static const char *getErrorString(int errorcode);
-    static void *saveThreadFunc(void *);
     static void *setupThreadFunc(void *);
 
 private:
@@ -494,9 +505,12 @@ class SettingsScreen : public JDrama::TViewObj {
 public:
     friend class SettingsDirector;
 
+    static constexpr size_t DisplayListSize = 0x20000;
+
     SettingsScreen(TMarioGamePad *controller)
         : TViewObj("<SettingsScreen>"), mScreen(nullptr), mController(controller),
-          mShineIcon(nullptr), mCurrentTextBox(nullptr), mGroupID(0), mSettingID(0), mGroups() {
+          mShineIcon(nullptr), mCurrentTextBox(nullptr), mGroupID(0), mSettingID(0), mGroups(),
+          mDisplayList(DisplayListSize) {
         mShineAnimator = SimpleTexAnimator(sLoadingIconTIMGs, 16);
     }
 
@@ -555,11 +569,12 @@ public:
             J2DOrthoGraph ortho(0, 0, BetterSMS::getScreenOrthoWidth(), SMSGetTitleRenderHeight());
             ortho.setup2D();
 
-            mScreen->draw(0, 0, &ortho);
+            mDisplayList.draw(mScreen, &ortho);
         }
     }
 
     void refreshCurrent() {
+        mDisplayList.invalidate();
         if (mCurrentSettingInfo && mCurrentSettingInfo->mSettingData->isUserEditable()) {
             char valueTextBuf[40];
             mCurrentSettingInfo->mSettingData->getValueName(valueTextBuf);
@@ -575,6 +590,10 @@ private:
             return;
         }
 
+        // Record the screen again only when the selection or a value actually changed
+        const s32 oldGroupID   = mGroupID;
+        const s32 oldSettingID = mSettingID;
+
         if ((mController->mButtons.mFrameInput & TMarioGamePad::A)) {
             mDirector->switchToControl(SettingsDirector::Control::INT_SETTING);
             return;
@@ -611,25 +630,13 @@ private:
             if (mController->mButtons.mRapidInput &
                 (TMarioGamePad::DPAD_RIGHT | TMarioGamePad::MAINSTICK_RIGHT)) {
                 mCurrentSettingInfo->mSettingData->nextValue();
-                {
-                    char valueTextBuf[40];
-                    mCurrentSettingInfo->mSettingData->getValueName(valueTextBuf);
-
-                    snprintf(mCurrentSettingInfo->mSettingTextBox->mStrPtr, 100, "%s: %s",
-                             mCurrentSettingInfo->mSettingData->getName(), valueTextBuf);
-                }
+                updateValueText();
             }
 
             if (mController->mButtons.mRapidInput &
                 (TMarioGamePad::DPAD_LEFT | TMarioGamePad::MAINSTICK_LEFT)) {
                 mCurrentSettingInfo->mSettingData->prevValue();
-                {
-                    char valueTextBuf[40];
-                    mCurrentSettingInfo->mSettingData->getValueName(valueTextBuf);
-
-                    snprintf(mCurrentSettingInfo->mSettingTextBox->mStrPtr, 100, "%s: %s",
-                             mCurrentSettingInfo->mSettingData->getName(), valueTextBuf);
-                }
+                updateValueText();
             }
         }
 
@@ -665,6 +672,27 @@ private:
         if ((mController->mButtons.mFrameInput & TMarioGamePad::B)) {
             mDirector->mState = SettingsDirector::State::SAVE_START;
         }
+
+        if (mGroupID != oldGroupID || mSettingID != oldSettingID) {
+            mDisplayList.invalidate();
+        }
+    }
+
+    // Rewrites the label of the current setting, only dropping the recorded
+    // screen when the text differs
+    void updateValueText() {
+        char valueTextBuf[40];
+        mCurrentSettingInfo->mSettingData->getValueName(valueTextBuf);
+
+        char labelTextBuf[100];
+        snprintf(labelTextBuf, 100, "%s: %s", mCurrentSettingInfo->mSettingData->getName(),
+                 valueTextBuf);
+
+        char *labelText = mCurrentSettingInfo->mSettingTextBox->mStrPtr;
+        if (strcmp(labelText, labelTextBuf) != 0) {
+            strcpy(labelText, labelTextBuf);
+            mDisplayList.invalidate();
+        }
     }
 
     GroupInfo *getGroupInfo(u32 index) {
@@ -692,6 +720,7 @@ private:
     SettingInfo *mCurrentSettingInfo;
     SimpleTexAnimator mShineAnimator;
     TGlobalVector<GroupInfo *> mGroups;
+    TDisplayListCache mDisplayList;
 };
 
 class IntSettingPanel : public JDrama::TViewObj {
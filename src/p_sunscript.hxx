@@ -3,6 +3,7 @@
 #include <Dolphin/types.h>
 #include <SMS/SPC/SpcInterp.hxx>
 #include <SMS/SPC/SpcSlice.hxx>
+#include <SMS/System/Application.hxx>
 #include <SMS/assert.h>
 
 #include "sunscript.hxx"
@@ -30,4 +31,17 @@ namespace BetterSMS {
 
 }  // namespace BetterSMS
 
+// Builtins bound past this many are not profiled
+constexpr size_t BuiltinProfileSlots = 64;
+
+struct SpcBuiltinStats {
+    const char *mName;
+    u32 mCalls;
+    u32 mMicros;  // Total time spent in the builtin since the last report
+};
+
+// Debug builds only, the builtin that took the most time since the last report
+SpcBuiltinStats getHottestSpcBuiltin();
+void reportSpcBuiltinProfile(TApplication *app);
+
 using namespace BetterSMS;
\ No newline at end of file
@@ -0,0 +1,357 @@
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/JKernel/JKRFileLoader.hxx>
+#include <SMS/Map/MapCollisionData.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/MarDirector.hxx>
+
+#include "memory.hxx"
+#include "module.hxx"
+#include "p_baked.hxx"
+
+enum class BakedGridState : u8 {
+    UNTRIED,
+    INSTALLED,
+    REJECTED,
+};
+
+static BakedGridState sBakedGridState = BakedGridState::UNTRIED;
+static BakedGridHeader *sBakedHeader  = nullptr;
+static TBGCheckData *sBakedCheckData  = nullptr;
+static u32 sBakedTriangleCount        = 0;
+static u32 sBakedNodeCount            = 0;
+static s32 sBakedKind                 = 0;
+static OSTime sStaticGridBuildTicks   = 0;
+static u32 sStaticGridInserts         = 0;
+static TBGCheckData *sMapCheckData    = nullptr;  // First static insert of the stage
+static u8 *sGridExport                = nullptr;
+
+// Baked list slots in the order ColGridBaker writes them
+static const s32 sBakedPlaneTypes[] = {TBGCheckListRoot::GROUND, TBGCheckListRoot::ROOF,
+                                       TBGCheckListRoot::WALL};
+
+static u32 hashBytes(u32 hash, const u8 *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+// Hashes the parts of the .col the grid is derived from; must match ColGridBaker
+static u32 hashCollision(const u8 *col) {
+    const u32 vertexCount  = *reinterpret_cast<const u32 *>(col + 0x0);
+    const u32 vertexOffset = *reinterpret_cast<const u32 *>(col + 0x4);
+    const u32 groupCount   = *reinterpret_cast<const u32 *>(col + 0x8);
+    const u32 groupOffset  = *reinterpret_cast<const u32 *>(col + 0xC);
+
+    u32 hash = 2166136261;
+    hash     = hashBytes(hash, col, 0x10);
+    hash     = hashBytes(hash, col + vertexOffset, vertexCount * 12);
+    hash     = hashBytes(hash, col + groupOffset, groupCount * 0x18);
+
+    for (u32 i = 0; i < groupCount; ++i) {
+        const u8 *group     = col + groupOffset + (i * 0x18);
+        const u16 triCount  = *reinterpret_cast<const u16 *>(group + 0x2);
+        const u32 idxOffset = *reinterpret_cast<const u32 *>(group + 0x8);
+        hash                = hashBytes(hash, col + idxOffset, triCount * 6);
+    }
+
+    return hash;
+}
+
+// The first static insert must be triangle 0 of map.col for the baked indices to line up
+static bool isFirstMapTriangle(const u8 *col, const TBGCheckData *data) {
+    const u32 vertexOffset = *reinterpret_cast<const u32 *>(col + 0x4);
+    const u32 groupCount   = *reinterpret_cast<const u32 *>(col + 0x8);
+    const u32 groupOffset  = *reinterpret_cast<const u32 *>(col + 0xC);
+
+    if (groupCount == 0)
+        return false;
+
+    const u32 idxOffset    = *reinterpret_cast<const u32 *>(col + groupOffset + 0x8);
+    const u16 *indices     = reinterpret_cast<const u16 *>(col + idxOffset);
+    const TVec3f *vertices = reinterpret_cast<const TVec3f *>(col + vertexOffset);
+
+    for (int i = 0; i < 3; ++i) {
+        const TVec3f &vertex = vertices[indices[i]];
+        if (vertex.x != data->mVertices[i].x || vertex.y != data->mVertices[i].y ||
+            vertex.z != data->mVertices[i].z)
+            return false;
+    }
+
+    return true;
+}
+
+static bool isBakedGridCurrent(const BakedGridHeader *header, const u8 *col,
+                               const TMapCollisionData *collision, const TBGCheckData *data) {
+    if (header->mMagic != BakedGridMagic || header->mVersion != BakedGridVersion)
+        return false;
+
+    if (header->mBlockXCount != collision->mBlockXCount ||
+        header->mBlockZCount != collision->mBlockZCount)
+        return false;
+
+    if (header->mAreaSizeX != collision->mAreaSizeX || header->mAreaSizeZ != collision->mAreaSizeZ)
+        return false;
+
+    if (header->mColHash != hashCollision(col))
+        return false;
+
+    return isFirstMapTriangle(col, data);
+}
+
+static void linkBakedGrid(const BakedGridHeader *header, TMapCollisionData *collision,
+                          TBGCheckData *data, s32 kind) {
+    const u8 *base     = reinterpret_cast<const u8 *>(header);
+    const u32 *roots   = reinterpret_cast<const u32 *>(base + header->mRootOffset);
+    const auto *source = reinterpret_cast<const BakedGridNode *>(base + header->mNodeOffset);
+
+    // Links are node indices in the blob; resolve them against one contiguous allocation
+    TBGCheckList *nodes = collision->allocCheckList(kind, header->mNodeCount);
+    for (u32 i = 0; i < header->mNodeCount; ++i) {
+        const u32 next         = source[i].mNext;
+        nodes[i].mColTriangle  = &data[source[i].mTriangle];
+        nodes[i].mNextTriangle = next == BakedGridNone ? nullptr : &nodes[next];
+    }
+
+    const u32 cellCount = header->mBlockXCount * header->mBlockZCount;
+    for (u32 cell = 0; cell < cellCount; ++cell) {
+        for (u32 slot = 0; slot < 3; ++slot) {
+            const u32 head = roots[(cell * 3) + slot];
+            if (head == BakedGridNone)
+                continue;
+            TBGCheckListRoot &root = collision->mStaticCollisionRoot[cell];
+            root.mCheckList[sBakedPlaneTypes[slot]].mNextTriangle = &nodes[head];
+        }
+    }
+}
+
+bool installBakedCheckData(TMapCollisionData *collision, TBGCheckData *data, s32 kind) {
+    if (sBakedGridState == BakedGridState::INSTALLED)
+        return data >= sBakedCheckData && data < sBakedCheckData + sBakedTriangleCount;
+
+    if (sBakedGridState == BakedGridState::REJECTED)
+        return false;
+
+    sBakedGridState = BakedGridState::REJECTED;
+    sMapCheckData   = data;
+
+    // Validation is part of the install cost, so time it alongside the linking
+    const OSTime startTime = OSGetTime();
+
+    void *resource = JKRFileLoader::getGlbResource("/scene/map/map.colgrid");
+    auto *header   = reinterpret_cast<BakedGridHeader *>(resource);
+    if (!header)
+        return false;
+
+    auto *col = reinterpret_cast<u8 *>(JKRFileLoader::getGlbResource("/scene/map/map.col"));
+    if (!col || !isBakedGridCurrent(header, col, collision, data)) {
+        OSReport("[WARN] map.colgrid does not match map.col, building collision at runtime\n");
+        return false;
+    }
+
+    linkBakedGrid(header, collision, data, kind);
+    sStaticGridBuildTicks += OSGetTime() - startTime;
+
+    sBakedGridState     = BakedGridState::INSTALLED;
+    sBakedHeader        = header;
+    sBakedCheckData     = data;
+    sBakedTriangleCount = header->mTriangleCount;
+    sBakedNodeCount     = header->mNodeCount;
+    sBakedKind          = kind;
+    return true;
+}
+
+void addStaticGridBuildTime(OSTime ticks) {
+    sStaticGridBuildTicks += ticks;
+    sStaticGridInserts += 1;
+}
+
+#if SMS_DEBUG
+
+static u32 countMapTriangles(const u8 *col) {
+    const u32 groupCount  = *reinterpret_cast<const u32 *>(col + 0x8);
+    const u32 groupOffset = *reinterpret_cast<const u32 *>(col + 0xC);
+
+    u32 count = 0;
+    for (u32 i = 0; i < groupCount; ++i) {
+        count += *reinterpret_cast<const u16 *>(col + groupOffset + (i * 0x18) + 0x2);
+    }
+    return count;
+}
+
+static u8 getBakedSlot(s32 planeType) {
+    for (u8 slot = 0; slot < 3; ++slot) {
+        if (sBakedPlaneTypes[slot] == planeType)
+            return slot;
+    }
+    return 2;
+}
+
+// Serializes the grid the game just built for map.col into the .colgrid layout.
+// The dump is the reference ColGridBaker --verify checks a bake against, and
+// is itself a valid map.colgrid for the stage.
+static void exportRuntimeGrid(TMapCollisionData *collision) {
+    const u8 *col =
+        reinterpret_cast<const u8 *>(JKRFileLoader::getGlbResource("/scene/map/map.col"));
+    if (!col || !sMapCheckData || !isFirstMapTriangle(col, sMapCheckData))
+        return;
+
+    const u32 triangleCount = countMapTriangles(col);
+    const u32 cellCount     = collision->mBlockXCount * collision->mBlockZCount;
+
+    auto isMapNode = [&](const TBGCheckList *node) {
+        return node->mColTriangle >= sMapCheckData &&
+               node->mColTriangle < sMapCheckData + triangleCount;
+    };
+
+    u32 nodeCount = 0;
+    for (u32 cell = 0; cell < cellCount; ++cell) {
+        for (u32 slot = 0; slot < 3; ++slot) {
+            const TBGCheckList *node =
+                collision->mStaticCollisionRoot[cell].mCheckList[sBakedPlaneTypes[slot]]
+                    .mNextTriangle;
+            for (; node; node = node->mNextTriangle) {
+                if (isMapNode(node))
+                    nodeCount += 1;
+            }
+        }
+    }
+
+    const u32 typeOffset = sizeof(BakedGridHeader);
+    const u32 rootOffset = (typeOffset + triangleCount + 3) & ~3;
+    const u32 nodeOffset = rootOffset + (cellCount * 3 * sizeof(u32));
+    const u32 size       = nodeOffset + (nodeCount * sizeof(BakedGridNode));
+
+    if (sGridExport)
+        Memory::free(sGridExport);
+    sGridExport = static_cast<u8 *>(Memory::hmalloc(JKRHeap::sSystemHeap, size, 32));
+    if (!sGridExport) {
+        OSReport("[COLLISION] Not enough memory to export the %lu byte runtime grid\n", size);
+        return;
+    }
+
+    auto *header           = reinterpret_cast<BakedGridHeader *>(sGridExport);
+    header->mMagic         = BakedGridMagic;
+    header->mVersion       = BakedGridVersion;
+    header->mColHash       = hashCollision(col);
+    header->mTriangleCount = triangleCount;
+    header->mBlockXCount   = collision->mBlockXCount;
+    header->mBlockZCount   = collision->mBlockZCount;
+    header->mAreaSizeX     = collision->mAreaSizeX;
+    header->mAreaSizeZ     = collision->mAreaSizeZ;
+    header->mNodeCount     = nodeCount;
+    header->mTypeOffset    = typeOffset;
+    header->mRootOffset    = rootOffset;
+    header->mNodeOffset    = nodeOffset;
+    header->_2C            = 0;
+
+    u8 *types = sGridExport + typeOffset;
+    for (u32 i = 0; i < rootOffset - typeOffset; ++i) {
+        types[i] = i < triangleCount ? getBakedSlot(sMapCheckData[i].getPlaneType()) : 0;
+    }
+
+    u32 *roots           = reinterpret_cast<u32 *>(sGridExport + rootOffset);
+    BakedGridNode *nodes = reinterpret_cast<BakedGridNode *>(sGridExport + nodeOffset);
+
+    u32 next = 0;
+    for (u32 cell = 0; cell < cellCount; ++cell) {
+        for (u32 slot = 0; slot < 3; ++slot) {
+            u32 *link = &roots[(cell * 3) + slot];
+            *link     = BakedGridNone;
+
+            const TBGCheckList *node =
+                collision->mStaticCollisionRoot[cell].mCheckList[sBakedPlaneTypes[slot]]
+                    .mNextTriangle;
+            for (; node; node = node->mNextTriangle) {
+                if (!isMapNode(node))
+                    continue;
+                nodes[next].mNext     = BakedGridNone;
+                nodes[next].mTriangle = node->mColTriangle - sMapCheckData;
+                *link                 = next;
+                link                  = &nodes[next].mNext;
+                next += 1;
+            }
+        }
+    }
+
+    OSReport("[COLLISION] Runtime grid exported to 0x%08lX, dump %lu bytes from there as "
+             "map.colgrid or to check a bake with colgridbaker --verify\n",
+             reinterpret_cast<u32>(sGridExport), size);
+}
+
+#endif
+
+static bool isBakedPlaneTypesCurrent() {
+    const u8 *types = reinterpret_cast<const u8 *>(sBakedHeader) + sBakedHeader->mTypeOffset;
+    for (u32 i = 0; i < sBakedTriangleCount; ++i) {
+        if (types[i] > 2 || sBakedPlaneTypes[types[i]] != sBakedCheckData[i].getPlaneType()) {
+            OSReport("[WARN] map.colgrid triangle %lu disagrees with map.col, building collision "
+                     "at runtime\n",
+                     i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Unlinks the baked nodes from every static list and inserts the map
+// triangles through the runtime build. Triangles inserted after the bake stay
+// where they are. The baked nodes stay in the check list pool until the stage
+// exits.
+static void rejectBakedGrid(TMapCollisionData *collision) {
+    const u32 cellCount = collision->mBlockXCount * collision->mBlockZCount;
+    for (u32 cell = 0; cell < cellCount; ++cell) {
+        for (u32 slot = 0; slot < 3; ++slot) {
+            TBGCheckList *list =
+                &collision->mStaticCollisionRoot[cell].mCheckList[sBakedPlaneTypes[slot]];
+            while (list->mNextTriangle) {
+                const TBGCheckData *data = list->mNextTriangle->mColTriangle;
+                if (data >= sBakedCheckData && data < sBakedCheckData + sBakedTriangleCount)
+                    list->mNextTriangle = list->mNextTriangle->mNextTriangle;
+                else
+                    list = list->mNextTriangle;
+            }
+        }
+    }
+
+    sBakedGridState = BakedGridState::REJECTED;
+    for (u32 i = 0; i < sBakedTriangleCount; ++i) {
+        addCheckDataToGridAll(collision, &sBakedCheckData[i], sBakedKind);
+    }
+}
+
+BETTER_SMS_FOR_CALLBACK void reportStaticGridLoad(TMarDirector *director) {
+    // Plane types are only known once every triangle is set up, so maps whose
+    // triangles are created in a different order than baked are caught here
+    if (sBakedGridState == BakedGridState::INSTALLED && !isBakedPlaneTypesCurrent()) {
+        rejectBakedGrid(gpMapCollisionData);
+    }
+
+    if (sBakedGridState == BakedGridState::INSTALLED) {
+        OSReport("[COLLISION] Static grid installed from map.colgrid in %lu us (%lu triangles, "
+                 "%lu nodes)\n",
+                 u32(OSTicksToMicroseconds(sStaticGridBuildTicks)), sBakedTriangleCount,
+                 sBakedNodeCount);
+    } else if (sStaticGridInserts > 0) {
+        OSReport("[COLLISION] Static grid built at runtime in %lu us (%lu inserts)\n",
+                 u32(OSTicksToMicroseconds(sStaticGridBuildTicks)), sStaticGridInserts);
+#if SMS_DEBUG
+        exportRuntimeGrid(gpMapCollisionData);
+#endif
+    }
+}
+
+BETTER_SMS_FOR_CALLBACK void resetBakedCheckData(TApplication *app) {
+    sBakedGridState       = BakedGridState::UNTRIED;
+    sBakedHeader          = nullptr;
+    sBakedCheckData       = nullptr;
+    sBakedTriangleCount   = 0;
+    sBakedNodeCount       = 0;
+    sBakedKind            = 0;
+    sStaticGridBuildTicks = 0;
+    sStaticGridInserts    = 0;
+    sMapCheckData         = nullptr;
+}
@@ -0,0 +1,229 @@
+#include <Dolphin/types.h>
+#include <SMS/Map/MapCollisionData.hxx>
+
+#include "logging.hxx"
+#include "module.hxx"
+#include "p_column.hxx"
+
+using namespace BetterSMS;
+
+static bool isWaterType(u16 type) { return (type >= 0x100 && type < 0x106) || type == 0x4104; }
+
+static bool isPassThroughType(u16 type, bool isCollisionRepaired) {
+    if (type == 0x401 || type == 0x801 || type == 0x10A || type == 0x8400)
+        return true;
+    return isCollisionRepaired && type == 0x800;
+}
+
+// Same filters, in the same order, as patchedCheckGroundList
+static bool isGroundIgnored(const ColumnSurface &surface, u8 flags, bool isCollisionRepaired) {
+    const u16 type = surface.mType;
+
+    if ((flags & 0b100000) && ((type >= 0x100 && type < 0x104) || type == 0x4104))
+        return true;
+
+    if (isCollisionRepaired && (flags & 0b10000) && surface.mIsMarioThrough)
+        return true;
+
+    if (isCollisionRepaired && (flags & 0b1000) && !isWaterType(type))
+        return true;
+
+    if ((flags & 0b100) && isPassThroughType(type, isCollisionRepaired))
+        return true;
+
+    return (flags & 0b1) && isWaterType(type);
+}
+
+// Same filters, in the same order, as patchedCheckRoofList
+static bool isRoofIgnored(const ColumnSurface &surface, u8 flags, bool isCollisionRepaired) {
+    const u16 type = surface.mType;
+
+    if (isCollisionRepaired && (flags & 8) && !isWaterType(type))
+        return true;
+
+    if ((flags & 4) && isPassThroughType(type, isCollisionRepaired))
+        return true;
+
+    return isCollisionRepaired && (flags & 1) && isWaterType(type);
+}
+
+// Once per cell, a column this dense is queried every frame something stands in it
+static void warnTruncated(int cell) {
+    static int sLastTruncatedCell = -1;
+    if (cell == sLastTruncatedCell)
+        return;
+    sLastTruncatedCell = cell;
+
+    Console::record(Console::LEVEL_WARNING, Console::CATEGORY_STAGE,
+                    "Collision cell %d crosses more than %lu surfaces, the rest are ignored\n",
+                    cell, static_cast<u32>(TCollisionColumn::SurfaceMax));
+}
+
+void TCollisionColumn::query(const TMapCollisionData &data, f32 x, f32 z) {
+    const f32 gridFraction = 1.0f / 1024.0f;
+
+    const f32 boundsX = data.mAreaSizeX;
+    const f32 boundsZ = data.mAreaSizeZ;
+
+    mCount       = 0;
+    mIsInBounds  = false;
+    mIsTruncated = false;
+
+    if (x < -boundsX || x >= boundsX)
+        return;
+
+    if (z < -boundsZ || z >= boundsZ)
+        return;
+
+    mIsInBounds = true;
+
+    const int cellX = gridFraction * (x + boundsX);
+    const int cellZ = gridFraction * (z + boundsZ);
+    const int cell  = cellX + (cellZ * data.mBlockXCount);
+
+    const TBGCheckListRoot *roots[] = {&data.mStaticCollisionRoot[cell],
+                                       &data.mMoveCollisionRoot[cell]};
+    const u8 listTypes[] = {TBGCheckListRoot::GROUND, TBGCheckListRoot::ROOF,
+                            TBGCheckListRoot::WALL};
+
+    for (size_t r = 0; r < 2; ++r) {
+        for (u8 listType : listTypes) {
+            const TBGCheckList *list = roots[r]->mCheckList[listType].mNextTriangle;
+            for (; list; list = list->mNextTriangle) {
+                const TBGCheckData *checkData = list->mColTriangle;
+                if (checkData->mNormal.y == 0.0f)
+                    continue;
+
+                const f32 ax = checkData->mVertices[0].x;
+                const f32 az = checkData->mVertices[0].z;
+                const f32 bx = checkData->mVertices[1].x;
+                const f32 bz = checkData->mVertices[1].z;
+                const f32 cx = checkData->mVertices[2].x;
+                const f32 cz = checkData->mVertices[2].z;
+
+                const f32 ab = (az - z) * (bx - ax) - (ax - x) * (bz - az);
+                const f32 bc = (bz - z) * (cx - bx) - (bx - x) * (cz - bz);
+                const f32 ca = (cz - z) * (ax - cx) - (cx - x) * (az - cz);
+
+                const bool isGroundLike = ab >= -1.0f && bc >= -1.0f && ca >= -1.0f;
+                const bool isRoofLike   = ab <= 1.0f && bc <= 1.0f && ca <= 1.0f;
+                if (!isGroundLike && !isRoofLike)
+                    continue;
+
+                if (mCount == SurfaceMax) {
+                    mIsTruncated = true;
+                    warnTruncated(cell);
+                    return;
+                }
+
+                const f32 height = -(checkData->mProjectionFactor + x * checkData->mNormal.x +
+                                     z * checkData->mNormal.z) /
+                                   checkData->mNormal.y;
+
+                ColumnSurface &surface  = mSurfaces[mCount++];
+                surface.mHeight         = height;
+                surface.mMinHeight      = checkData->mMinHeight;
+                surface.mData           = checkData;
+                surface.mType           = checkData->mType;
+                surface.mListType       = listType;
+                surface.mIsStatic       = r == 0;
+                surface.mIsGroundLike   = isGroundLike;
+                surface.mIsRoofLike     = isRoofLike;
+                surface.mIsMarioThrough = checkData->isMarioThrough();
+            }
+        }
+    }
+}
+
+f32 TCollisionColumn::findGroundBelow(f32 y, u8 ignoreFlags, const TBGCheckData **out,
+                                      bool includeWalls) const {
+    *out = &TMapCollisionData::mIllegalCheckData;
+
+    if (!mIsInBounds)
+        return 0.0f;
+
+    const bool isCollisionRepaired = BetterSMS::isCollisionRepaired();
+
+    // Unsorted, so keep the highest match. Ties go to the surface gathered last
+    const ColumnSurface *best = nullptr;
+    for (size_t i = 0; i < mCount; ++i) {
+        const ColumnSurface &surface = mSurfaces[i];
+
+        if (best && surface.mHeight < best->mHeight)
+            continue;
+
+        if (!surface.mIsGroundLike || surface.mListType == TBGCheckListRoot::ROOF)
+            continue;
+
+        if (!includeWalls && surface.mListType == TBGCheckListRoot::WALL)
+            continue;
+
+        // checkGroundList skips anything that starts above the sample height
+        if (y < surface.mMinHeight)
+            continue;
+
+        if (y - (surface.mHeight - 78.0f) < 0.0f)
+            continue;
+
+        // Only the static ground list was allowed its step, the rest had to be below
+        const bool isStaticGround =
+            surface.mIsStatic && surface.mListType == TBGCheckListRoot::GROUND;
+        if (!isStaticGround && surface.mHeight > y)
+            continue;
+
+        if (isGroundIgnored(surface, ignoreFlags, isCollisionRepaired))
+            continue;
+
+        best = &surface;
+    }
+
+    if (!best)
+        return -32767.0f;
+
+    *out = best->mData;
+    return best->mHeight;
+}
+
+f32 TCollisionColumn::findRoofAbove(f32 y, u8 ignoreFlags, const TBGCheckData **out,
+                                    bool includeWalls) const {
+    *out = &TMapCollisionData::mIllegalCheckData;
+
+    if (!mIsInBounds)
+        return 0.0f;
+
+    const bool isCollisionRepaired = BetterSMS::isCollisionRepaired();
+
+    // Unsorted, so keep the lowest match. Ties go to the surface gathered first
+    const ColumnSurface *best = nullptr;
+    for (size_t i = 0; i < mCount; ++i) {
+        const ColumnSurface &surface = mSurfaces[i];
+
+        if (best && surface.mHeight >= best->mHeight)
+            continue;
+
+        if (!surface.mIsRoofLike || surface.mListType == TBGCheckListRoot::GROUND)
+            continue;
+
+        if (!includeWalls && surface.mListType == TBGCheckListRoot::WALL)
+            continue;
+
+        if (y - (surface.mHeight + 78.0f) > 0.0f)
+            continue;
+
+        // Only the static roof list was allowed its step, the rest had to be above
+        const bool isStaticRoof = surface.mIsStatic && surface.mListType == TBGCheckListRoot::ROOF;
+        if (!isStaticRoof && surface.mHeight <= y)
+            continue;
+
+        if (isRoofIgnored(surface, ignoreFlags, isCollisionRepaired))
+            continue;
+
+        best = &surface;
+    }
+
+    if (!best)
+        return 10000000.0f;
+
+    *out = best->mData;
+    return best->mHeight;
+}
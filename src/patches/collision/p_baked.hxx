@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+#include <SMS/Map/MapCollisionData.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/MarDirector.hxx>
+
+// Pre-binned static collision grid produced by tools/ColGridBaker from a
+// stage's map.col. The blob is big endian like the rest of the archive, so it
+// is used in place and only node links are resolved into TBGCheckList nodes.
+struct BakedGridHeader {
+    u32 mMagic;
+    u32 mVersion;
+    u32 mColHash;
+    u32 mTriangleCount;
+    u16 mBlockXCount;
+    u16 mBlockZCount;
+    f32 mAreaSizeX;
+    f32 mAreaSizeZ;
+    u32 mNodeCount;
+    u32 mTypeOffset;  // u8[mTriangleCount], baked plane type of each triangle
+    u32 mRootOffset;  // u32[cells][3], first node of the ground, roof and wall lists
+    u32 mNodeOffset;  // BakedGridNode[mNodeCount]
+    u32 _2C;
+};
+
+struct BakedGridNode {
+    u32 mNext;
+    u32 mTriangle;
+};
+
+constexpr u32 BakedGridMagic   = 0x42475244;  // 'BGRD'
+constexpr u32 BakedGridVersion = 1;
+constexpr u32 BakedGridNone    = 0xFFFFFFFF;
+
+// Called for each static triangle insert. The first insert of a stage installs
+// the baked grid if one is present and current; returns true for every
+// triangle the baked grid already covers
+bool installBakedCheckData(TMapCollisionData *collision, TBGCheckData *data, s32 kind);
+void addStaticGridBuildTime(OSTime ticks);
+
+// Runtime grid insert in update.cpp, used when a bake is rejected after install
+void addCheckDataToGridAll(TMapCollisionData *collision, TBGCheckData *data, s32 kind);
+
+void reportStaticGridLoad(TMarDirector *director);
+void resetBakedCheckData(TApplication *app);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Dolphin/types.h>
+#include <SMS/Map/MapCollisionData.hxx>
+
+// Every surface crossing a vertical line through the collision grid, gathered
+// from one walk of the cell's static and moving ground, roof and wall lists.
+// Water and cave logic filters this instead of re-entering the grid per query.
+// The fields the filters read are copied in so they never touch the triangle.
+struct ColumnSurface {
+    f32 mHeight;
+    f32 mMinHeight;
+    const TBGCheckData *mData;
+    u16 mType;
+    u8 mListType;          // TBGCheckListRoot list the triangle was found in
+    bool mIsStatic;        // Found in the static grid rather than the move grid
+    bool mIsGroundLike;    // Passes the upward facing test of checkGroundList
+    bool mIsRoofLike;      // Passes the downward facing test of checkRoofList
+    bool mIsMarioThrough;
+};
+
+class TCollisionColumn {
+public:
+    static constexpr size_t SurfaceMax = 64;
+
+    TCollisionColumn() : mCount(0), mIsInBounds(false), mIsTruncated(false) {}
+    TCollisionColumn(const TMapCollisionData &data, f32 x, f32 z) : TCollisionColumn() {
+        query(data, x, z);
+    }
+
+    // Gather the column at (x, z), in list walk order
+    void query(const TMapCollisionData &data, f32 x, f32 z);
+
+    size_t size() const { return mCount; }
+    bool isInBounds() const { return mIsInBounds; }
+    // More than SurfaceMax surfaces crossed the column, the rest were dropped
+    bool isTruncated() const { return mIsTruncated; }
+    const ColumnSurface &operator[](size_t index) const { return mSurfaces[index]; }
+
+    // Highest ground-like surface below y, as checkGroundList over the ground and wall
+    // lists. Only static ground may sit up to a step above y, like the list checks it
+    // replaces. Returns -32767 when none match, 0 out of bounds
+    f32 findGroundBelow(f32 y, u8 ignoreFlags, const TBGCheckData **out,
+                        bool includeWalls = true) const;
+    // Lowest roof-like surface above y, as checkRoofList over the roof and wall lists.
+    // Only static roofs may sit up to a step below y, like the list checks it replaces.
+    // Returns 10000000 when none match, 0 out of bounds
+    f32 findRoofAbove(f32 y, u8 ignoreFlags, const TBGCheckData **out,
+                      bool includeWalls = true) const;
+
+private:
+    ColumnSurface mSurfaces[SurfaceMax];
+    size_t mCount;
+    bool mIsInBounds;
+    bool mIsTruncated;
+};
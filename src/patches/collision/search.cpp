@@ -5,9 +5,11 @@
 #include <SMS/Strategic/Strategy.hxx>
 #include <SMS/macros.h>
 
+#include "libs/fastmath.hxx"
 #include "memory.hxx"
 
 #include "module.hxx"
+#include "p_column.hxx"
 #include "p_settings.hxx"
 
 // Fix intersecting slopes
@@ -16,9 +18,17 @@ static f32 getRoofNoWater(TMap *map, f32 x, f32 y, f32 z, const TBGCheckData **o
         return map->checkRoof(x, y, z, out);
     }
 
-    f32 height = y;
+    // Most roofs aren't water, so only gather the column when the first one is
+    f32 height = map->checkRoof(x, y + 100.0f, z, out);
+    if (!(*out)->isWaterSurface() || (gpMarioAddress->mState & TMario::STATE_WATERBORN) != 0) {
+        return height;
+    }
+
+    // Walk up one gathered column instead of re-entering the grid for each water surface
+    const TCollisionColumn column(*map->mCollisionData, x, z);
+
     while (true) {
-        height = map->checkRoof(x, height + 100.0f, z, out);
+        height = column.findRoofAbove(height + 100.0f, 0, out, false);
         if (!(*out)->isWaterSurface() || (gpMarioAddress->mState & TMario::STATE_WATERBORN) != 0) {
             break;
         }
@@ -32,6 +42,7 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x802573C8, 0, 0, 0), getRoofNoWater);
 constexpr float CornerThreshold = -0.9f;
 
 // Credits to frameperfection
+// Edge push outs feed straight back into the position, so they use the medium sqrt tier
 static size_t checkWallListExotic(const TBGCheckList *list, TBGWallCheckRecord *record) {
     TBGCheckData *checkData;
     f32 offset;
@@ -134,7 +145,7 @@ static size_t checkWallListExotic(const TBGCheckList *list, TBGWallCheckRecord *
                 goto edge_1_3;
             DOOD[0]  = VMatrix[0][0] * v - VMatrix[2][0];
             DOOD[1]  = VMatrix[0][2] * v - VMatrix[2][2];
-            invDenom = sqrtf(DOOD[0] * DOOD[0] + DOOD[1] * DOOD[1]);
+            invDenom = BetterSMS::Math::hypot<BetterSMS::Math::Tier::MEDIUM>(DOOD[0], DOOD[1]);
             offset   = invDenom - margin_radius;
             if (offset > 0.0f)
                 goto edge_1_3;
@@ -157,7 +168,7 @@ static size_t checkWallListExotic(const TBGCheckList *list, TBGWallCheckRecord *
                 goto edge_2_3;
             DOOD[0]  = VMatrix[1][0] * v - VMatrix[2][0];
             DOOD[1]  = VMatrix[1][2] * v - VMatrix[2][2];
-            invDenom = sqrtf(DOOD[0] * DOOD[0] + DOOD[1] * DOOD[1]);
+            invDenom = BetterSMS::Math::hypot<BetterSMS::Math::Tier::MEDIUM>(DOOD[0], DOOD[1]);
             offset   = invDenom - margin_radius;
             if (offset > 0.0f)
                 goto edge_2_3;
@@ -187,7 +198,7 @@ static size_t checkWallListExotic(const TBGCheckList *list, TBGWallCheckRecord *
                 continue;
             DOOD[0]  = VMatrix[1][0] * v - VMatrix[2][0];
             DOOD[1]  = VMatrix[1][2] * v - VMatrix[2][2];
-            invDenom = sqrtf(DOOD[0] * DOOD[0] + DOOD[1] * DOOD[1]);
+            invDenom = BetterSMS::Math::hypot<BetterSMS::Math::Tier::MEDIUM>(DOOD[0], DOOD[1]);
             offset   = invDenom - margin_radius;
             if (offset > 0.0f)
                 continue;
@@ -3,12 +3,16 @@
 #include <SMS/Map/MapMakeList.hxx>
 #include <SMS/Player/Mario.hxx>
 #include <SMS/Strategic/Strategy.hxx>
+#include <SMS/System/Application.hxx>
 #include <SMS/macros.h>
 
 #include "memory.hxx"
 
+#include "libs/global_unordered_map.hxx"
+#include "libs/global_vector.hxx"
 #include "libs/profiler.hxx"
 #include "module.hxx"
+#include "p_baked.hxx"
 #include "p_settings.hxx"
 
 constexpr float cellSize = 1024.0f;
@@ -76,6 +80,18 @@ static TBGCheckList *addRoofNode_(TBGCheckList *list, TBGCheckData *data) {
     } while (true);
 }
 
+static TBGCheckList *findInsertNode_(TBGCheckList *list, TBGCheckData *data, s32 type) {
+    switch (type) {
+    case TBGCheckListRoot::GROUND:
+        return addGroundNode_(list, data);
+    case TBGCheckListRoot::ROOF:
+        return addRoofNode_(list, data);
+    case TBGCheckListRoot::WALL:
+    default:
+        return addWallNode_(list, data);
+    }
+}
+
 static void addAfterPreNode_(int cellx, int cellz, TBGCheckList *addlist, TBGCheckList *newlist,
                              int type) {
     newlist->mNextTriangle = addlist->mNextTriangle;
@@ -126,7 +142,19 @@ static void addAfterPreNode_(int cellx, int cellz, TBGCheckList *addlist, TBGChe
 // SMS_WRITE_32(0x80192A44, 0x60000000);
 // SMS_WRITE_32(0x80192A48, 0x60000000);
 
+void rebinMoveCheckData(TMapCollisionData *collision, TBGCheckData *data);
+
 void addCheckDataToGridAll(TMapCollisionData *collision, TBGCheckData *data, s32 kind) {
+    if (kind == COLLISION_MOVE) {
+        rebinMoveCheckData(collision, data);
+        return;
+    }
+
+    if (installBakedCheckData(collision, data, kind))
+        return;
+
+    const OSTime startTime = OSGetTime();
+
     s32 type = data->getPlaneType();
     int xmin, zmin, xmax, zmax;
 
@@ -140,60 +168,230 @@ void addCheckDataToGridAll(TMapCollisionData *collision, TBGCheckData *data, s32
         for (int cellx = xmin; cellx <= xmax; cellx += 1) {
             float mapx = cellx * cellSize;
 
-            TBGCheckList *list;
-            TBGCheckList *addNode;
-            if (kind == COLLISION_MOVE) {
-                list = &gpMapCollisionData
-                            ->mMoveCollisionRoot[cellx + (cellz * collision->mBlockXCount)]
-                            .mCheckList[type];
-                switch (type) {
-                case TBGCheckListRoot::GROUND:
-                    addNode = addGroundNode_(list, data);
-                    break;
-                case TBGCheckListRoot::ROOF:
-                    addNode = addRoofNode_(list, data);
-                    break;
-                case TBGCheckListRoot::WALL:
-                    addNode = addWallNode_(list, data);
-                    break;
+            f32 baseX = mapx - areaX;
+            f32 baseZ = mapz - areaZ;
+            if (!gpMapCollisionData->polygonIsInGrid(baseX, baseZ, baseX + cellSize + 80.0f,
+                                                     baseZ + cellSize + 80.0f, data)) {
+                continue;
+            }
+
+            TBGCheckList *list =
+                &gpMapCollisionData->mStaticCollisionRoot[cellx + (cellz * collision->mBlockXCount)]
+                     .mCheckList[type];
+            TBGCheckList *addNode = findInsertNode_(list, data, type);
+            TBGCheckList *newlist = gpMapCollisionData->allocCheckList(kind, 1);
+            newlist->mColTriangle = data;
+            addAfterPreNode_(cellx, cellz, addNode, newlist, kind);
+        }
+    }
+
+    addStaticGridBuildTime(OSGetTime() - startTime);
+}
+// TMapCollisionBase::setVertexData, initAllCheckData, updateTrans, setCheckData and
+// TMapCollisionMove::setList, each calling TMapCollisionData::addCheckDataToGrid
+SMS_PATCH_BL(SMS_PORT_REGION(0x8018E210, 0, 0, 0), addCheckDataToGridAll);
+SMS_PATCH_BL(SMS_PORT_REGION(0x80191568, 0, 0, 0), addCheckDataToGridAll);
+SMS_PATCH_BL(SMS_PORT_REGION(0x801917BC, 0, 0, 0), addCheckDataToGridAll);
+SMS_PATCH_BL(SMS_PORT_REGION(0x80191A58, 0, 0, 0), addCheckDataToGridAll);
+SMS_PATCH_BL(SMS_PORT_REGION(0x80191AAC, 0, 0, 0), addCheckDataToGridAll);
+
+// Moving collision is re-binned incrementally instead of clearing the move grid
+// and re-inserting every triangle each frame. Each triangle remembers the grid
+// rect and list nodes it was linked into, so only cells that it entered or left
+// are touched. A triangle that stays in a cell keeps its node there; the height
+// search above only picks an insertion point and does not keep a cell sorted,
+// so the new heights are read from the triangle in place.
+struct MoveCheckNode : public TBGCheckList {
+    TBGCheckList *mPrevNode;  // The cell root or another move node
+};
+
+struct MoveCheckBin {
+    TBGCheckData *mData;
+    s32 mType;
+    int mMinX, mMinZ, mMaxX, mMaxZ;
+    u32 mLastFrame;
+    bool mIsLinked;
+    TGlobalVector<MoveCheckNode *> mNodes;  // One per cell, row major over the rect
+};
+
+static TGlobalUnorderedMap<TBGCheckData *, MoveCheckBin *> sMoveBinMap(256);
+static TGlobalVector<MoveCheckBin *> sMoveBins;
+static TGlobalVector<MoveCheckNode *> sFreeMoveNodes;
+static TGlobalVector<MoveCheckNode *> sScratchMoveNodes;
+static u32 sMoveBinFrame = 1;
+
+static TBGCheckList *getMoveCellList(TMapCollisionData *collision, int cellx, int cellz,
+                                     s32 type) {
+    return &collision->mMoveCollisionRoot[cellx + (cellz * collision->mBlockXCount)]
+                .mCheckList[type];
+}
+
+// Nodes come from the scene heap, which is freed as a whole after the stage exits
+static MoveCheckNode *allocMoveNode(TBGCheckData *data) {
+    MoveCheckNode *node;
+    if (sFreeMoveNodes.size() > 0) {
+        node = sFreeMoveNodes[sFreeMoveNodes.size() - 1];
+        sFreeMoveNodes.erase(sFreeMoveNodes.end() - 1);
+    } else {
+        node = new (gpApplication.mCurrentHeap, 4) MoveCheckNode();
+    }
+    node->mNextTriangle = nullptr;
+    node->mColTriangle  = data;
+    node->mPrevNode     = nullptr;
+    return node;
+}
+
+// Every node past a move cell root is one of ours, so the back links hold
+static void unlinkMoveNode(MoveCheckNode *node) {
+    TBGCheckList *prev = node->mPrevNode;
+    if (!prev)
+        return;
+
+    prev->mNextTriangle = node->mNextTriangle;
+    if (node->mNextTriangle) {
+        static_cast<MoveCheckNode *>(node->mNextTriangle)->mPrevNode = prev;
+    }
+    node->mNextTriangle = nullptr;
+    node->mPrevNode     = nullptr;
+}
+
+static void linkMoveNode(TMapCollisionData *collision, int cellx, int cellz, MoveCheckNode *node,
+                         s32 type) {
+    TBGCheckList *list = getMoveCellList(collision, cellx, cellz, type);
+    TBGCheckList *prev = findInsertNode_(list, node->mColTriangle, type);
+    addAfterPreNode_(cellx, cellz, prev, node, COLLISION_MOVE);
+    node->mPrevNode = prev;
+    if (node->mNextTriangle) {
+        static_cast<MoveCheckNode *>(node->mNextTriangle)->mPrevNode = node;
+    }
+}
+
+static void unlinkMoveBin(TMapCollisionData *collision, MoveCheckBin *bin) {
+    if (!bin->mIsLinked)
+        return;
+
+    for (auto *node : bin->mNodes) {
+        unlinkMoveNode(node);
+        sFreeMoveNodes.push_back(node);
+    }
+
+    bin->mNodes.clear();
+    bin->mIsLinked = false;
+}
+
+void rebinMoveCheckData(TMapCollisionData *collision, TBGCheckData *data) {
+    s32 type = data->getPlaneType();
+
+    MoveCheckBin *&bin = sMoveBinMap[data];
+    if (!bin) {
+        bin             = new (JKRHeap::sSystemHeap, 4) MoveCheckBin();
+        bin->mData      = data;
+        bin->mType      = type;
+        bin->mIsLinked  = false;
+        bin->mLastFrame = 0;
+        sMoveBins.push_back(bin);
+    }
+
+    bin->mLastFrame = sMoveBinFrame;
+
+    int xmin, zmin, xmax, zmax;
+    if (!collision->getGridArea(data, type, &xmin, &zmin, &xmax, &zmax)) {
+        unlinkMoveBin(collision, bin);
+        return;
+    }
+
+    // Plane type flips (ground to wall, etc) change which lists own the triangle
+    if (bin->mIsLinked && bin->mType != type) {
+        unlinkMoveBin(collision, bin);
+    }
+    bin->mType = type;
+
+    // Same rect, so every node stays where it is
+    if (bin->mIsLinked && bin->mMinX == xmin && bin->mMinZ == zmin && bin->mMaxX == xmax &&
+        bin->mMaxZ == zmax) {
+        return;
+    }
+
+    sScratchMoveNodes.clear();
+
+    // Drop cells the triangle left
+    if (bin->mIsLinked) {
+        size_t i = 0;
+        for (int cellz = bin->mMinZ; cellz <= bin->mMaxZ; cellz += 1) {
+            for (int cellx = bin->mMinX; cellx <= bin->mMaxX; cellx += 1) {
+                MoveCheckNode *node = bin->mNodes[i++];
+                if (cellx < xmin || cellx > xmax || cellz < zmin || cellz > zmax) {
+                    unlinkMoveNode(node);
+                    sFreeMoveNodes.push_back(node);
                 }
-                TBGCheckList *newlist = gpMapCollisionData->allocCheckList(COLLISION_MOVE, 1);
-                newlist->mColTriangle = data;
-                addAfterPreNode_(cellx, cellz, addNode, newlist, COLLISION_MOVE);
+            }
+        }
+    }
+
+    // Keep or add each cell of the new rect
+    for (int cellz = zmin; cellz <= zmax; cellz += 1) {
+        for (int cellx = xmin; cellx <= xmax; cellx += 1) {
+            const bool wasInCell = bin->mIsLinked && cellx >= bin->mMinX && cellx <= bin->mMaxX &&
+                                   cellz >= bin->mMinZ && cellz <= bin->mMaxZ;
+            MoveCheckNode *node;
+            if (wasInCell) {
+                const int width = bin->mMaxX - bin->mMinX + 1;
+                node = bin->mNodes[(cellx - bin->mMinX) + ((cellz - bin->mMinZ) * width)];
             } else {
-                f32 baseX = mapx - areaX;
-                f32 baseZ = mapz - areaZ;
-                if (!gpMapCollisionData->polygonIsInGrid(baseX, baseZ, baseX + cellSize + 80.0f,
-                                                         baseZ + cellSize + 80.0f, data)) {
-                    continue;
-                }
+                node = allocMoveNode(data);
+                linkMoveNode(collision, cellx, cellz, node, type);
+            }
+            sScratchMoveNodes.push_back(node);
+        }
+    }
 
-                list = &gpMapCollisionData
-                            ->mStaticCollisionRoot[cellx + (cellz * collision->mBlockXCount)]
-                            .mCheckList[type];
-                switch (type) {
-                case TBGCheckListRoot::GROUND:
-                    addNode = addGroundNode_(list, data);
-                    break;
-                case TBGCheckListRoot::ROOF:
-                    addNode = addRoofNode_(list, data);
-                    break;
-                case TBGCheckListRoot::WALL:
-                    addNode = addWallNode_(list, data);
-                    break;
-                }
-                TBGCheckList *newlist = gpMapCollisionData->allocCheckList(kind, 1);
-                newlist->mColTriangle = data;
-                addAfterPreNode_(cellx, cellz, addNode, newlist, type);
+    bin->mNodes.clear();
+    for (auto *node : sScratchMoveNodes) {
+        bin->mNodes.push_back(node);
+    }
+
+    bin->mMinX     = xmin;
+    bin->mMinZ     = zmin;
+    bin->mMaxX     = xmax;
+    bin->mMaxZ     = zmax;
+    bin->mIsLinked = true;
+}
+
+// Replaces the per frame move grid reset in TMap::perform; only triangles that
+// were not re-added since the last sweep are unlinked. The first sweep of a
+// stage still runs the full reset so the move roots start out empty.
+void sweepMoveCheckData(TMapCollisionData *collision) {
+    if (sMoveBinFrame == 1) {
+        collision->initMoveCollision();
+        for (auto *bin : sMoveBins) {
+            for (auto *node : bin->mNodes) {
+                sFreeMoveNodes.push_back(node);
             }
+            bin->mNodes.clear();
+            bin->mIsLinked = false;
+        }
+    }
+
+    for (auto *bin : sMoveBins) {
+        if (bin->mLastFrame != sMoveBinFrame) {
+            unlinkMoveBin(collision, bin);
         }
     }
+    sMoveBinFrame += 1;
+}
+SMS_PATCH_BL(SMS_PORT_REGION(0x80189758, 0, 0, 0), sweepMoveCheckData);
+
+// Bins are ours and are freed here; their nodes went with the scene heap
+BETTER_SMS_FOR_CALLBACK void resetMoveCheckData(TApplication *app) {
+    for (auto *bin : sMoveBins) {
+        delete bin;
+    }
+    sMoveBinMap.clear();
+    sMoveBins.clear();
+    sFreeMoveNodes.clear();
+    sScratchMoveNodes.clear();
+    sMoveBinFrame = 1;
 }
-// SMS_PATCH_BL(0x8018E210, addCheckDataToGridAll);
-// SMS_PATCH_BL(0x80191568, addCheckDataToGridAll);
-// SMS_PATCH_BL(0x801917BC, addCheckDataToGridAll);
-// SMS_PATCH_BL(0x80191A58, addCheckDataToGridAll);
-// SMS_PATCH_BL(0x80191AAC, addCheckDataToGridAll);
 
 bool isActiveFromGroup(TIdxGroupObj *group, THitActor *target, f32 range) {
     for (auto &obj : group->mViewObjList) {
@@ -273,4 +471,4 @@ static void profileMoveReset(TMapCollisionData *data) {
     profiler.stop();
     profiler.report();
 }
-// SMS_PATCH_BL(0x80189758, profileMoveReset);
\ No newline at end of file
+// SMS_PATCH_BL(0x80189758, profileMoveReset);
@@ -0,0 +1,169 @@
+#include <Dolphin/math.h>
+#include <Dolphin/string.h>
+#include <Dolphin/types.h>
+
+#include <SMS/Camera/CubeManagerBase.hxx>
+#include <SMS/Camera/CubeMapTool.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/MarDirector.hxx>
+
+#include "libs/constmath.hxx"
+#include "libs/fastmath.hxx"
+#include "module.hxx"
+#include "p_cube.hxx"
+
+// Cube scale is in units of this many world units; the bound only has to
+// cover the cube, isInCube still decides containment
+constexpr f32 CubeUnitSize = 1000.0f;
+constexpr int CubeCellsMax = 32;
+
+static TCubeIndex sCameraCubeIndex;
+
+static void getCubeBounds(const TCubeGeneralInfo *cube, f32 &minX, f32 &minZ, f32 &maxX,
+                          f32 &maxZ) {
+    // Sphere around the cube so any rotation stays inside the bound
+    const TVec3f &scale = cube->mScale;
+    const f32 radius =
+        BetterSMS::Math::magnitude<BetterSMS::Math::Tier::FAST>(scale.x, scale.y, scale.z) *
+        CubeUnitSize;
+
+    minX = cube->mTranslation.x - radius;
+    maxX = cube->mTranslation.x + radius;
+    minZ = cube->mTranslation.z - radius;
+    maxZ = cube->mTranslation.z + radius;
+}
+
+void TCubeIndex::build(TCubeManagerBase *manager) {
+    reset();
+
+    TNameRefPtrAryT<TCubeGeneralInfo> *cubes = manager->getCubeInfo<TCubeGeneralInfo>();
+    if (!cubes || cubes->mChildren.size() == 0)
+        return;
+
+    const size_t cubeCount = cubes->mChildren.size();
+
+    f32 minX = 1e30f, minZ = 1e30f, maxX = -1e30f, maxZ = -1e30f;
+    for (size_t i = 0; i < cubeCount; ++i) {
+        f32 cubeMinX, cubeMinZ, cubeMaxX, cubeMaxZ;
+        getCubeBounds(cubes->mChildren[i], cubeMinX, cubeMinZ, cubeMaxX, cubeMaxZ);
+        minX = Min(minX, cubeMinX);
+        minZ = Min(minZ, cubeMinZ);
+        maxX = Max(maxX, cubeMaxX);
+        maxZ = Max(maxZ, cubeMaxZ);
+    }
+
+    // Roughly two cells per cube along each axis keeps most cells to a cube or two
+    int cellsPerAxis = 1;
+    while (cellsPerAxis * cellsPerAxis < cubeCount * 4 && cellsPerAxis < CubeCellsMax)
+        cellsPerAxis += 1;
+
+    mCellsX    = cellsPerAxis;
+    mCellsZ    = cellsPerAxis;
+    mMinX      = minX;
+    mMinZ      = minZ;
+    mCellSizeX = Max((maxX - minX) / mCellsX, 1.0f);
+    mCellSizeZ = Max((maxZ - minZ) / mCellsZ, 1.0f);
+
+    const size_t cellCount = mCellsX * mCellsZ;
+    mCellStarts            = new u32[cellCount + 1];
+    memset(mCellStarts, 0, sizeof(u32) * (cellCount + 1));
+
+    auto getCellRange = [&](size_t i, int &x0, int &z0, int &x1, int &z1) {
+        f32 cubeMinX, cubeMinZ, cubeMaxX, cubeMaxZ;
+        getCubeBounds(cubes->mChildren[i], cubeMinX, cubeMinZ, cubeMaxX, cubeMaxZ);
+        x0 = Clamp(int((cubeMinX - mMinX) / mCellSizeX), 0, mCellsX - 1);
+        z0 = Clamp(int((cubeMinZ - mMinZ) / mCellSizeZ), 0, mCellsZ - 1);
+        x1 = Clamp(int((cubeMaxX - mMinX) / mCellSizeX), 0, mCellsX - 1);
+        z1 = Clamp(int((cubeMaxZ - mMinZ) / mCellSizeZ), 0, mCellsZ - 1);
+    };
+
+    // Count, prefix sum, then fill so each cell's cubes stay in ascending order
+    size_t entryCount = 0;
+    for (size_t i = 0; i < cubeCount; ++i) {
+        int x0, z0, x1, z1;
+        getCellRange(i, x0, z0, x1, z1);
+        for (int z = z0; z <= z1; ++z) {
+            for (int x = x0; x <= x1; ++x) {
+                mCellStarts[x + (z * mCellsX) + 1] += 1;
+                entryCount += 1;
+            }
+        }
+    }
+
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        mCellStarts[cell + 1] += mCellStarts[cell];
+    }
+
+    mCubeIndices = new u16[entryCount];
+
+    u32 *cursors = new u32[cellCount];
+    memcpy(cursors, mCellStarts, sizeof(u32) * cellCount);
+
+    for (size_t i = 0; i < cubeCount; ++i) {
+        int x0, z0, x1, z1;
+        getCellRange(i, x0, z0, x1, z1);
+        for (int z = z0; z <= z1; ++z) {
+            for (int x = x0; x <= x1; ++x) {
+                mCubeIndices[cursors[x + (z * mCellsX)]++] = i;
+            }
+        }
+    }
+
+    delete[] cursors;
+    mManager = manager;
+}
+
+void TCubeIndex::reset() {
+    delete[] mCellStarts;
+    delete[] mCubeIndices;
+    mManager     = nullptr;
+    mCellStarts  = nullptr;
+    mCubeIndices = nullptr;
+    mCellsX      = 0;
+    mCellsZ      = 0;
+}
+
+s32 TCubeIndex::findCubeWithDataNo(const TVec3f &point, s32 dataNo) const {
+    const int cellX = int((point.x - mMinX) / mCellSizeX);
+    const int cellZ = int((point.z - mMinZ) / mCellSizeZ);
+
+    // Outside every cube's bound
+    if (point.x < mMinX || point.z < mMinZ || cellX >= mCellsX || cellZ >= mCellsZ)
+        return -1;
+
+    const int cell = cellX + (cellZ * mCellsX);
+    for (u32 i = mCellStarts[cell]; i < mCellStarts[cell + 1]; ++i) {
+        const s32 cubeNo = mCubeIndices[i];
+        if (mManager->isInCube(point, cubeNo) && mManager->getDataNo(cubeNo) == dataNo)
+            return cubeNo;
+    }
+
+    return -1;
+}
+
+s32 findCubeWithDataNo(TCubeManagerBase *manager, const TVec3f &point, s32 dataNo) {
+    if (sCameraCubeIndex.isBuiltFor(manager))
+        return sCameraCubeIndex.findCubeWithDataNo(point, dataNo);
+
+    TNameRefPtrAryT<TCubeGeneralInfo> *cubes = manager->getCubeInfo<TCubeGeneralInfo>();
+    if (!cubes)
+        return -1;
+
+    for (size_t i = 0; i < cubes->mChildren.size(); ++i) {
+        if (manager->isInCube(point, i) && manager->getDataNo(i) == dataNo)
+            return i;
+    }
+
+    return -1;
+}
+
+BETTER_SMS_FOR_CALLBACK void buildCubeIndices(TMarDirector *director) {
+    if (gpCubeCamera)
+        sCameraCubeIndex.build(gpCubeCamera);
+}
+
+// build() ran while the stage heap was current and that heap is reclaimed
+// whole after exit, so only the pointers into it and the manager are dropped
+BETTER_SMS_FOR_CALLBACK void resetCubeIndices(TApplication *app) {
+    sCameraCubeIndex = TCubeIndex();
+}
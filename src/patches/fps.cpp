@@ -6,6 +6,7 @@
 #include <SMS/System/MarDirector.hxx>
 #include <SMS/raw_fn.hxx>
 
+#include "libs/fastmath.hxx"
 #include "p_settings.hxx"
 
 extern FPSSetting gFPSSetting;
@@ -31,7 +32,8 @@ BETTER_SMS_FOR_CALLBACK void updateFPS(TMarDirector *director) {
 }
 
 static f32 setBoidSpeed(f32 dot) {
-    return sqrtf(dot) * (SMS_PORT_REGION(30.0f, 25.0f, 30.0f, 30.0f) / BetterSMS::getFrameRate());
+    return BetterSMS::Math::sqrt<BetterSMS::Math::Tier::FAST>(dot) *
+           (SMS_PORT_REGION(30.0f, 25.0f, 30.0f, 30.0f) / BetterSMS::getFrameRate());
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x800066E4, 0x800066E4, 0, 0), setBoidSpeed);
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Dolphin/types.h>
+#include <SMS/Camera/CubeManagerBase.hxx>
+#include <SMS/System/Application.hxx>
+#include <SMS/System/MarDirector.hxx>
+
+// Uniform XZ grid over the boxes of a cube manager, rebuilt when a stage starts.
+// Point queries only run the exact isInCube test against cubes binned in the
+// cell under the point instead of every cube the manager owns.
+class TCubeIndex {
+public:
+    TCubeIndex()
+        : mManager(nullptr), mCellStarts(nullptr), mCubeIndices(nullptr), mCellsX(0), mCellsZ(0) {}
+
+    void build(TCubeManagerBase *manager);
+    void reset();
+
+    bool isBuiltFor(const TCubeManagerBase *manager) const {
+        return mManager != nullptr && mManager == manager;
+    }
+
+    // First cube containing the point whose data number is dataNo, or -1
+    s32 findCubeWithDataNo(const TVec3f &point, s32 dataNo) const;
+
+private:
+    TCubeManagerBase *mManager;
+    u32 *mCellStarts;   // mCellsX * mCellsZ + 1 offsets into mCubeIndices
+    u16 *mCubeIndices;  // Cube indices per cell, ascending
+    u16 mCellsX;
+    u16 mCellsZ;
+    f32 mMinX;
+    f32 mMinZ;
+    f32 mCellSizeX;
+    f32 mCellSizeZ;
+};
+
+// Searches the stage index of the manager if one was built, otherwise every cube
+s32 findCubeWithDataNo(TCubeManagerBase *manager, const TVec3f &point, s32 dataNo);
+
+void buildCubeIndices(TMarDirector *director);
+void resetCubeIndices(TApplication *app);
@@ -17,8 +17,11 @@
 #include <SMS/Player/Mario.hxx>
 #include <SMS/raw_fn.hxx>
 
+#include "collision/p_column.hxx"
+#include "libs/fastmath.hxx"
 #include "libs/geometry.hxx"
 #include "module.hxx"
+#include "p_cube.hxx"
 #include "p_settings.hxx"
 #include "player.hxx"
 
@@ -35,12 +38,12 @@ static void normalToRotationMatrix(const TVec3f &normal, Mtx out) {
     TVec3f forward = normal;
 
     TVec3f right;
-    PSVECNormalize(forward, forward);
+    BetterSMS::Math::normalize<BetterSMS::Math::Tier::MEDIUM>(forward);
     PSVECCrossProduct(forward, up, right);
-    PSVECNormalize(right, right);
+    BetterSMS::Math::normalize<BetterSMS::Math::Tier::MEDIUM>(right);
 
     PSVECCrossProduct(forward, right, up);
-    PSVECNormalize(up, up);
+    BetterSMS::Math::normalize<BetterSMS::Math::Tier::MEDIUM>(up);
 
     PSMTXIdentity(out);
 
@@ -113,171 +116,19 @@ SMS_PATCH_BL(SMS_PORT_REGION(0x8024FB54, 0x802478E4, 0, 0), canDiePlane);
 SMS_WRITE_32(SMS_PORT_REGION(0x8024FB58, 0x802478E8, 0, 0), 0x2C030000);
 SMS_WRITE_32(SMS_PORT_REGION(0x8024FB5C, 0x802478EC, 0, 0), 0x41820084);
 
-static f32 findAnyRoofLikePlaneAbove(const TVec3f &position, TMapCollisionData &data,
-                                     u8 ignoreFlags, const TBGCheckData **out) {
-    const f32 gridFraction = 1.0f / 1024.0f;
-
-    const f32 boundsX = data.mAreaSizeX;
-    const f32 boundsZ = data.mAreaSizeZ;
-
-    *out = &TMapCollisionData::mIllegalCheckData;
-
-    if (position.x < -boundsX || position.x >= boundsX)
-        return 0;
-
-    if (position.z < -boundsZ || position.z >= boundsZ)
-        return 0;
-
-    const int cellX = gridFraction * (position.x + boundsX);
-    const int cellZ = gridFraction * (position.z + boundsZ);
-
-    // Static roofs
-    f32 aboveY = data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                                    data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                        .mCheckList[TBGCheckListRoot::ROOF]
-                                        .mNextTriangle,
-                                    out);
-
-    // Dynamic roofs
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                               data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                   .mCheckList[TBGCheckListRoot::ROOF]
-                                   .mNextTriangle,
-                               &potential);
-
-        if (potentialY < aboveY && potentialY > position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
-
-    // Static walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                               data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                   .mCheckList[TBGCheckListRoot::WALL]
-                                   .mNextTriangle,
-                               &potential);
-
-        if (potentialY < aboveY && potentialY > position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
-
-    // Dynamic walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkRoofList(position.x, position.y, position.z, ignoreFlags,
-                               data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                   .mCheckList[TBGCheckListRoot::WALL]
-                                   .mNextTriangle,
-                               &potential);
-
-        if (potentialY < aboveY && potentialY > position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
-
-    return aboveY;
-}
-
-static f32 findAnyGroundLikePlaneBelow(const TVec3f &position, TMapCollisionData &data,
-                                       u8 ignoreFlags, const TBGCheckData **out) {
-    const f32 gridFraction = 1.0f / 1024.0f;
-
-    const f32 boundsX = data.mAreaSizeX;
-    const f32 boundsZ = data.mAreaSizeZ;
-
-    *out = &TMapCollisionData::mIllegalCheckData;
-
-    if (position.x < -boundsX || position.x >= boundsX)
-        return 0;
-
-    if (position.z < -boundsZ || position.z >= boundsZ)
-        return 0;
-
-    const int cellX = gridFraction * (position.x + boundsX);
-    const int cellZ = gridFraction * (position.z + boundsZ);
-
-    // Static ground
-    f32 aboveY = data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                      data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                          .mCheckList[TBGCheckListRoot::GROUND]
-                                          .mNextTriangle,
-                                      out);
-
-    // Dynamic ground
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                 data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                     .mCheckList[TBGCheckListRoot::GROUND]
-                                     .mNextTriangle,
-                                 &potential);
-
-        if (potentialY > aboveY && potentialY <= position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
-
-    // Static walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                 data.mStaticCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                     .mCheckList[TBGCheckListRoot::WALL]
-                                     .mNextTriangle,
-                                 &potential);
-
-        if (potentialY > aboveY && potentialY <= position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
-
-    // Dynamic walls
-    {
-        const TBGCheckData *potential;
-        f32 potentialY =
-            data.checkGroundList(position.x, position.y, position.z, ignoreFlags,
-                                 data.mMoveCollisionRoot[cellX + (cellZ * data.mBlockXCount)]
-                                     .mCheckList[TBGCheckListRoot::WALL]
-                                     .mNextTriangle,
-                                 &potential);
-
-        if (potentialY > aboveY && potentialY <= position.y) {
-            *out   = potential;
-            aboveY = potentialY;
-        }
-    }
-
-    return aboveY;
-}
-
 // IMPORTANT: Does not always set the water pointer due to the nature of the function.
 // PLEASE INITIALIZE TO NULLPTR FIRST
 SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y, f32 z, bool considerCave,
                                                   const TMap *map, const TBGCheckData **water) {
     const TVec3f samplePosition = {x, player->mTranslation.y + 80.0f, z};
+    const TCollisionColumn column(*map->mCollisionData, x, z);
 
     const TBGCheckData *potential;
     f32 roofY, potentialY;
 
     const TBGCheckData *roofPlane;
-    roofY      = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 0, &roofPlane);
-    potentialY = findAnyGroundLikePlaneBelow({samplePosition.x, roofY - 1.0f, samplePosition.z},
-                                             *map->mCollisionData, 8, &potential);
+    roofY      = column.findRoofAbove(samplePosition.y, 0, &roofPlane);
+    potentialY = column.findGroundBelow(roofY - 1.0f, 8, &potential);
 
     if (isColTypeWater(roofPlane->mType)) {
         // If it is ocean water let's just assume the player is in water
@@ -292,9 +143,7 @@ SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y,
     if (potential != &TMapCollisionData::mIllegalCheckData) {
         // Since there is water below the roof, check if there is ground between the player
         // and the water
-        f32 groundY =
-            findAnyGroundLikePlaneBelow({samplePosition.x, potentialY - 10.0f, samplePosition.z},
-                                        *map->mCollisionData, 1, &roofPlane);
+        f32 groundY = column.findGroundBelow(potentialY - 10.0f, 1, &roofPlane);
         if (groundY <= samplePosition.y) {
             // If there is no ground between the player and the new water, we can just
             // return the new water level
@@ -311,8 +160,7 @@ SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y,
     } else if (considerCave) {
         // If there is no water beneath the roof, check if there is water above the player
         // (cave setting)
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
+        potentialY = column.findGroundBelow(10000000.0f, 8, &potential);
         if (potential == &TMapCollisionData::mIllegalCheckData) {
             if (roofPlane == &TMapCollisionData::mIllegalCheckData) {
                 player->mWaterHeight = player->mFloorBelow;
@@ -325,9 +173,8 @@ SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y,
         *water = potential;
         return Min(roofY + 100.0f, potentialY);
     } else {
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
-        roofY = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 1, &roofPlane);
+        potentialY = column.findGroundBelow(10000000.0f, 8, &potential);
+        roofY      = column.findRoofAbove(samplePosition.y, 1, &roofPlane);
         if (roofY > potentialY && potential != &TMapCollisionData::mIllegalCheckData) {
             *water = potential;
             return potentialY;
@@ -343,14 +190,14 @@ SMS_NO_INLINE static f32 enhanceWaterCheckPlayer_(TMario *player, f32 x, f32 y,
 SMS_NO_INLINE f32 enhanceWaterCheckGeneric_(f32 x, f32 y, f32 z, bool considerCave, const TMap *map,
                                             const TBGCheckData **water) {
     const TVec3f samplePosition = {x, y + 80.0f, z};
+    const TCollisionColumn column(*map->mCollisionData, x, z);
 
     const TBGCheckData *potential;
     f32 roofY, potentialY;
 
     const TBGCheckData *roofPlane;
-    roofY      = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 0, &roofPlane);
-    potentialY = findAnyGroundLikePlaneBelow({samplePosition.x, roofY - 1.0f, samplePosition.z},
-                                             *map->mCollisionData, 8, &potential);
+    roofY      = column.findRoofAbove(samplePosition.y, 0, &roofPlane);
+    potentialY = column.findGroundBelow(roofY - 1.0f, 8, &potential);
 
     bool isRoofWater = roofPlane && isColTypeWater(roofPlane->mType);
     if (isRoofWater) {
@@ -366,22 +213,19 @@ SMS_NO_INLINE f32 enhanceWaterCheckGeneric_(f32 x, f32 y, f32 z, bool considerCa
     if (potential != &TMapCollisionData::mIllegalCheckData) {
         // Since there is water below the roof, check if there is ground between the player
         // and the water
-        f32 groundY =
-            findAnyGroundLikePlaneBelow({samplePosition.x, potentialY - 10.0f, samplePosition.z},
-                                        *map->mCollisionData, 1, &roofPlane);
+        f32 groundY = column.findGroundBelow(potentialY - 10.0f, 1, &roofPlane);
         if (groundY <= samplePosition.y) {
             // If there is no ground between the player and the new water, we can just
             // return the new water level
             *water = potential;
             return potentialY;
         } else {
-            return findAnyGroundLikePlaneBelow({x, y, z}, *map->mCollisionData, 8, water);
+            return column.findGroundBelow(y, 8, water);
         }
     } else if (considerCave) {
         // If there is no water beneath the roof, check if there is water above the player
         // (cave setting)
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
+        potentialY = column.findGroundBelow(10000000.0f, 8, &potential);
         if (potential == &TMapCollisionData::mIllegalCheckData) {
             // Prevent potential crash
             if (*water == &TMapCollisionData::mIllegalCheckData) {
@@ -393,14 +237,13 @@ SMS_NO_INLINE f32 enhanceWaterCheckGeneric_(f32 x, f32 y, f32 z, bool considerCa
         *water = potential;
         return Min(roofY, potentialY);
     } else {
-        potentialY =
-            findAnyGroundLikePlaneBelow({x, 10000000.0f, z}, *map->mCollisionData, 8, &potential);
-        roofY = findAnyRoofLikePlaneAbove(samplePosition, *map->mCollisionData, 1, &roofPlane);
+        potentialY = column.findGroundBelow(10000000.0f, 8, &potential);
+        roofY      = column.findRoofAbove(samplePosition.y, 1, &roofPlane);
         if (roofY > potentialY) {
             *water = potential;
             return potentialY;
         }
-        return findAnyGroundLikePlaneBelow({x, y, z}, *map->mCollisionData, 8, water);
+        return column.findGroundBelow(y, 8, water);
     }
 }
 
@@ -534,7 +377,7 @@ static void checkIfObjBallWallCollisionIsWater(TMapObjBall *obj, TVec3f *out,
     TVec3f &sp = obj->mSpeed;
 
     if ((obj->mStateFlags.asU32 & 0x80) == 0 && obj->mObjectID != 0x400000D0) {
-        f32 speedMag = sqrtf(sp.x * sp.x + sp.y * sp.y + sp.z * sp.z);
+        f32 speedMag = BetterSMS::Math::magnitude<BetterSMS::Math::Tier::FAST>(sp.x, sp.y, sp.z);
         sp.y += obj->_184 * speedMag;
     }
 
@@ -565,7 +408,9 @@ static void checkIfObjBallWallCollisionIsWater(TMapObjBall *obj, TVec3f *out,
         sp.z += reflectDot * wall->mNormal.z;
 
         if (obj->mObjectID == 0x400000D0) {
-            f32 speedMag = fabsf(sqrtf(sp.x * sp.x + sp.y * sp.y + sp.z * sp.z));
+            // Only drives the impact sound volume
+            f32 speedMag =
+                BetterSMS::Math::magnitude<BetterSMS::Math::Tier::FAST>(sp.x, sp.y, sp.z);
             if (obj->mScale.y < 5.0f) {
                 if (gpMSound->gateCheck(0x308B)) {
                     MSoundSE::startSoundActorWithInfo(0x308B, obj->mTranslation, nullptr, speedMag,
@@ -612,10 +457,11 @@ SMS_PATCH_B(SMS_PORT_REGION(0x801E5AD4, 0, 0, 0), checkIfObjBallRoofCollisionIsW
 static SMS_NO_INLINE void fixMarioOceanAnimBug_(TMario *player, J3DTransformInfo &info, Mtx out) {
     if (BetterSMS::isCollisionRepaired()) {
         if (gpMapObjWave) {
+            const TCollisionColumn column(*gpMap->mCollisionData, player->mTranslation.x,
+                                          player->mTranslation.z);
+
             const TBGCheckData *water = nullptr;
-            f32 waterY                = findAnyGroundLikePlaneBelow(
-                {player->mTranslation.x, 10000000.0f, player->mTranslation.z},
-                *gpMap->mCollisionData, 8, &water);
+            f32 waterY                = column.findGroundBelow(10000000.0f, 8, &water);
             if (water != &TMapCollisionData::mIllegalCheckData) {
                 f32 waveHeight =
                     gpMapObjWave->getWaveHeight(player->mTranslation.x, player->mTranslation.z);
@@ -679,20 +525,8 @@ static f32 fixWaterFilterHeightCalc(TMapObjWave *objWave, f32 x, f32 y, f32 z) {
     Player::TPlayerData *data = Player::getData(player);
 
     bool considerCave = false;
-
-    TNameRefPtrAryT<TCubeGeneralInfo> *generalCubes = gpCubeCamera->getCubeInfo<TCubeGeneralInfo>();
-
-    if (generalCubes) {
-        for (size_t i = 0; i < generalCubes->mChildren.size(); ++i) {
-            if (!gpCubeCamera->isInCube({x, y, z}, i)) {
-                continue;
-            }
-
-            if (gpCubeCamera->getDataNo(i) == ENABLE_WATER_CAVE_CAMERA_TYPE) {
-                considerCave = data->mIsCameraInWater;
-                break;
-            }
-        }
+    if (findCubeWithDataNo(gpCubeCamera, {x, y, z}, ENABLE_WATER_CAVE_CAMERA_TYPE) >= 0) {
+        considerCave = data->mIsCameraInWater;
     }
 
     const TBGCheckData *water = nullptr;
@@ -19,6 +19,7 @@
 
 #include "libs/constmath.hxx"
 #include "module.hxx"
+#include "p_gptrace.hxx"
 #include "p_settings.hxx"
 
 using namespace BetterSMS;
@@ -455,6 +456,7 @@ static void fixDEBSWideScreenText(s32 x1, s32 y1, s32 width, s32 height) {
     pane->mPane->mRect.mX1 = sPaneRect.mX1 + (180.0f * sDEBSToTimerRatio);
     window->mFillRect.mX2  = sFillRect.mX2 - (180.0f * sDEBSToTimerRatio);
 
+    TGPZoneScope zone(GP_ZONE_SCISSOR);
     switch (gAspectRatioSetting.getInt()) {
     default:
     case AspectRatioSetting::FULL:
@@ -7,6 +7,7 @@
 #include "player.hxx"
 #include "stage.hxx"
 
+#include "p_cube.hxx"
 #include "p_settings.hxx"
 #include <Camera/CubeMapTool.hxx>
 #include <Camera/CubeManagerBase.hxx>
@@ -106,23 +107,8 @@ static void checkForWaterDeath(TYoshi *yoshi, const TBGCheckData *ground, f32 gr
     //if (ground->isWaterSurface())
     //    return;
 
-    bool considerCave = false;
-
-    TNameRefPtrAryT<TCubeCameraInfo> *cameraCubes = gpCubeCamera->getCubeInfo<TCubeCameraInfo>();
-
-    if (cameraCubes) {
-        for (size_t i = 0; i < cameraCubes->mChildren.size(); ++i) {
-            if (!gpCubeCamera->isInCube(
-                    {yoshi->mTranslation.x, yoshi->mTranslation.y, yoshi->mTranslation.z}, i)) {
-                continue;
-            }
-
-            if (gpCubeCamera->getDataNo(i) == ENABLE_WATER_CAVE_CAMERA_TYPE) {
-                considerCave = true;
-                break;
-            }
-        }
-    }
+    bool considerCave =
+        findCubeWithDataNo(gpCubeCamera, yoshi->mTranslation, ENABLE_WATER_CAVE_CAMERA_TYPE) >= 0;
 
     const TBGCheckData *water = nullptr;
     f32 height = enhanceWaterCheckGeneric_(yoshi->mTranslation.x, yoshi->mTranslation.y + 10.0f,
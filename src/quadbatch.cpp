@@ -0,0 +1,469 @@
+#include <Dolphin/GX.h>
+#include <Dolphin/MTX.h>
+#include <Dolphin/string.h>
+#include <Dolphin/types.h>
+
+#include <JSystem/J2D/J2DTextBox.hxx>
+#include <SMS/raw_fn.hxx>
+
+#include "memory.hxx"
+#include "module.hxx"
+#include "p_quadbatch.hxx"
+
+static TQuadBatch sQuadBatches[QUAD_LAYER_COUNT];
+static TQuadFont sSystemQuadFont;
+static bool sIsSystemQuadFontLoaded = false;
+
+#pragma region Font
+
+// ResFONT (FONTbfn1) blocks, as JUTResFont reads them
+struct QuadFontBlock {
+    u32 mMagic;
+    u32 mSize;
+};
+
+struct QuadFontInfo {
+    QuadFontBlock mBlock;
+    u16 mFontType;
+    u16 mAscent;
+    u16 mDescent;
+    u16 mWidth;
+    u16 mLeading;
+    u16 mDefaultCode;
+};
+
+struct QuadFontWidths {
+    QuadFontBlock mBlock;
+    u16 mStartCode;
+    u16 mEndCode;
+    u8 mEntries[];  // Kerning and width per code
+};
+
+struct QuadFontGlyphs {
+    QuadFontBlock mBlock;
+    u16 mStartCode;
+    u16 mEndCode;
+    u16 mCellWidth;
+    u16 mCellHeight;
+    u32 mPageSize;
+    u16 mFormat;
+    u16 mCellsPerRow;
+    u16 mCellRows;
+    u16 mPageWidth;
+    u16 mPageHeight;
+    u16 mPadding;
+    u8 mData[];
+};
+
+struct QuadFontMap {
+    QuadFontBlock mBlock;
+    u16 mMapping;
+    u16 mStartCode;
+    u16 mEndCode;
+    u16 mEntryCount;
+    u16 mEntries[];
+};
+
+enum QuadFontMapping { FONT_MAP_LINEAR, FONT_MAP_KANJI, FONT_MAP_TABLE, FONT_MAP_PAIRS };
+
+static constexpr size_t FontHeaderSize = 0x20;
+
+static size_t getGlyphPageCount(const QuadFontGlyphs *glyphs) {
+    const size_t cellsPerPage = glyphs->mCellsPerRow * glyphs->mCellRows;
+    if (cellsPerPage == 0 || glyphs->mEndCode < glyphs->mStartCode)
+        return 0;
+    return (glyphs->mEndCode - glyphs->mStartCode + cellsPerPage) / cellsPerPage;
+}
+
+bool TQuadFont::init(const void *font) {
+    mFont       = nullptr;
+    mInfo       = nullptr;
+    mWidthCount = 0;
+    mGlyphCount = 0;
+    mMapCount   = 0;
+
+    const u8 *data = static_cast<const u8 *>(font);
+    if (!data || memcmp(data, "FONTbfn1", 8) != 0)
+        return false;
+
+    const u32 blockCount = *reinterpret_cast<const u32 *>(data + 12);
+
+    size_t pageCount = 0;
+
+    const u8 *block = data + FontHeaderSize;
+    for (u32 i = 0; i < blockCount; ++i) {
+        const auto *header = reinterpret_cast<const QuadFontBlock *>(block);
+        switch (header->mMagic) {
+        case 'INF1':
+            mInfo = block;
+            break;
+        case 'WID1':
+            if (mWidthCount < BlockMax)
+                mWidths[mWidthCount++] = block;
+            break;
+        case 'GLY1':
+            if (mGlyphCount < BlockMax) {
+                mFirstPage[mGlyphCount] = pageCount;
+                mGlyphs[mGlyphCount++]  = block;
+                pageCount += getGlyphPageCount(reinterpret_cast<const QuadFontGlyphs *>(block));
+            }
+            break;
+        case 'MAP1':
+            if (mMapCount < BlockMax)
+                mMaps[mMapCount++] = block;
+            break;
+        default:
+            break;
+        }
+        block += header->mSize;
+    }
+
+    if (!mInfo || mGlyphCount == 0 || pageCount == 0)
+        return false;
+
+    mPages = static_cast<GXTexObj *>(
+        BetterSMS::Memory::hmalloc(JKRHeap::sSystemHeap, sizeof(GXTexObj) * pageCount, 32));
+    if (!mPages)
+        return false;
+
+    for (size_t i = 0; i < mGlyphCount; ++i) {
+        const auto *glyphs = reinterpret_cast<const QuadFontGlyphs *>(mGlyphs[i]);
+        const size_t pages = getGlyphPageCount(glyphs);
+        for (size_t page = 0; page < pages; ++page) {
+            GXTexObj *texObj = &mPages[mFirstPage[i] + page];
+            GXInitTexObj(texObj, const_cast<u8 *>(glyphs->mData) + glyphs->mPageSize * page,
+                         glyphs->mPageWidth, glyphs->mPageHeight,
+                         static_cast<GXTexFmt>(glyphs->mFormat), GX_CLAMP, GX_CLAMP, GX_FALSE);
+            GXInitTexObjLOD(texObj, GX_LINEAR, GX_LINEAR, 0.0f, 0.0f, 0.0f, GX_FALSE, GX_FALSE,
+                            GX_ANISO_1);
+        }
+    }
+
+    mFont = data;
+    return true;
+}
+
+// Same lookup as JUTResFont::getFontCode, less the kanji mapping
+int TQuadFont::getFontCode(int character) const {
+    int code = reinterpret_cast<const QuadFontInfo *>(mInfo)->mDefaultCode;
+
+    for (size_t i = 0; i < mMapCount; ++i) {
+        const auto *map = reinterpret_cast<const QuadFontMap *>(mMaps[i]);
+        if (character < map->mStartCode || character > map->mEndCode)
+            continue;
+
+        switch (map->mMapping) {
+        case FONT_MAP_LINEAR:
+            code = character - map->mStartCode;
+            break;
+        case FONT_MAP_TABLE: {
+            const u16 entry = map->mEntries[character - map->mStartCode];
+            if (entry != 0xFFFF)
+                code = entry;
+            break;
+        }
+        case FONT_MAP_PAIRS: {
+            int low = 0, high = static_cast<int>(map->mEntryCount) - 1;
+            while (low <= high) {
+                const int mid   = (low + high) / 2;
+                const u16 entry = map->mEntries[mid * 2];
+                if (entry == character) {
+                    code = map->mEntries[mid * 2 + 1];
+                    break;
+                }
+                if (entry < character)
+                    low = mid + 1;
+                else
+                    high = mid - 1;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+        break;
+    }
+
+    return code;
+}
+
+bool TQuadFont::getGlyph(u8 character, Glyph &out) const {
+    if (!isValid())
+        return false;
+
+    const int code = getFontCode(character);
+
+    for (size_t i = 0; i < mGlyphCount; ++i) {
+        const auto *glyphs = reinterpret_cast<const QuadFontGlyphs *>(mGlyphs[i]);
+        if (code < glyphs->mStartCode || code > glyphs->mEndCode)
+            continue;
+
+        const int cellsPerPage = glyphs->mCellsPerRow * glyphs->mCellRows;
+        const int index        = code - glyphs->mStartCode;
+        const int cell         = index % cellsPerPage;
+
+        const f32 cellX = (cell % glyphs->mCellsPerRow) * glyphs->mCellWidth;
+        const f32 cellY = (cell / glyphs->mCellsPerRow) * glyphs->mCellHeight;
+
+        out.mPage      = &mPages[mFirstPage[i] + index / cellsPerPage];
+        out.mU1        = cellX / glyphs->mPageWidth;
+        out.mV1        = cellY / glyphs->mPageHeight;
+        out.mU2        = (cellX + glyphs->mCellWidth) / glyphs->mPageWidth;
+        out.mV2        = (cellY + glyphs->mCellHeight) / glyphs->mPageHeight;
+        out.mCellWidth = glyphs->mCellWidth;
+        out.mKerning   = 0;
+        out.mWidth     = glyphs->mCellWidth;
+
+        for (size_t j = 0; j < mWidthCount; ++j) {
+            const auto *widths = reinterpret_cast<const QuadFontWidths *>(mWidths[j]);
+            if (code < widths->mStartCode || code > widths->mEndCode)
+                continue;
+            out.mKerning = widths->mEntries[(code - widths->mStartCode) * 2];
+            out.mWidth   = widths->mEntries[(code - widths->mStartCode) * 2 + 1];
+            break;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// Parsed on first use, the system font is only there once the game has booted
+const TQuadFont &getSystemQuadFont() {
+    if (!sIsSystemQuadFontLoaded && gpSystemFont) {
+        sSystemQuadFont.init(gpSystemFont->mFont);
+        sIsSystemQuadFontLoaded = true;
+    }
+    return sSystemQuadFont;
+}
+
+#pragma endregion
+
+TQuadBatch::Quad *TQuadBatch::pushQuad(f32 x, f32 y, f32 w, f32 h, JUtility::TColor color) {
+    if (mQuadCount >= QuadMax) {
+        OSReport("[WARN] Quad batch is full, dropping quad!\n");
+        return nullptr;
+    }
+
+    Quad &quad    = mQuads[mQuadCount++];
+    quad.mTexture = nullptr;
+    quad.mGlyphs  = nullptr;
+    quad.mX       = x;
+    quad.mY       = y;
+    quad.mW       = w;
+    quad.mH       = h;
+    quad.mU1      = 0.0f;
+    quad.mV1      = 0.0f;
+    quad.mU2      = 1.0f;
+    quad.mV2      = 1.0f;
+    quad.mColor   = color;
+    return &quad;
+}
+
+void TQuadBatch::pushFill(f32 x, f32 y, f32 w, f32 h, JUtility::TColor color) {
+    pushQuad(x, y, w, h, color);
+}
+
+void TQuadBatch::pushTexture(JUTTexture *texture, f32 x, f32 y, f32 w, f32 h,
+                             JUtility::TColor color) {
+    Quad *quad = pushQuad(x, y, w, h, color);
+    if (quad)
+        quad->mTexture = texture;
+}
+
+// Laid out like J2DPrint, the top of each cell at y and its left edge pulled
+// back by the glyph's kerning. Newlines step down by the character height.
+void TQuadBatch::pushText(const TQuadFont &font, f32 x, f32 y, f32 charW, f32 charH,
+                          const char *text, JUtility::TColor color) {
+    f32 cursorX = x;
+
+    for (const char *c = text; *c != '\0'; ++c) {
+        if (*c == '\n') {
+            cursorX = x;
+            y += charH;
+            continue;
+        }
+
+        TQuadFont::Glyph glyph;
+        if (!font.getGlyph(static_cast<u8>(*c), glyph))
+            continue;
+
+        const f32 scale = charW / glyph.mCellWidth;
+
+        if (*c != ' ') {
+            Quad *quad = pushQuad(cursorX - glyph.mKerning * scale, y, charW, charH, color);
+            if (!quad)
+                return;
+            quad->mGlyphs = glyph.mPage;
+            quad->mU1     = glyph.mU1;
+            quad->mV1     = glyph.mV1;
+            quad->mU2     = glyph.mU2;
+            quad->mV2     = glyph.mV2;
+        }
+
+        cursorX += glyph.mWidth * scale;
+    }
+}
+
+static void setupFillVtx() {
+    GXClearVtxDesc();
+    GXSetVtxDesc(GX_VA_POS, GX_DIRECT);
+    GXSetVtxDesc(GX_VA_CLR0, GX_DIRECT);
+    GXSetVtxAttrFmt(GX_VTXFMT0, GX_VA_POS, GX_POS_XYZ, GX_F32, 0);
+    GXSetVtxAttrFmt(GX_VTXFMT0, GX_VA_CLR0, GX_CLR_RGBA, GX_RGBA8, 0);
+
+    GXSetNumTexGens(0);
+    GXSetTevOrder(GX_TEVSTAGE0, GX_TEXCOORD_NULL, GX_TEXMAP_NULL, GX_COLOR0A0);
+    GXSetTevOp(GX_TEVSTAGE0, GX_PASSCLR);
+}
+
+static void setupTextureVtx() {
+    GXClearVtxDesc();
+    GXSetVtxDesc(GX_VA_POS, GX_DIRECT);
+    GXSetVtxDesc(GX_VA_CLR0, GX_DIRECT);
+    GXSetVtxDesc(GX_VA_TEX0, GX_DIRECT);
+    GXSetVtxAttrFmt(GX_VTXFMT0, GX_VA_POS, GX_POS_XYZ, GX_F32, 0);
+    GXSetVtxAttrFmt(GX_VTXFMT0, GX_VA_CLR0, GX_CLR_RGBA, GX_RGBA8, 0);
+    GXSetVtxAttrFmt(GX_VTXFMT0, GX_VA_TEX0, GX_TEX_ST, GX_F32, 0);
+
+    GXSetNumTexGens(1);
+    GXSetTexCoordGen(GX_TEXCOORD0, GX_TG_MTX2x4, GX_TG_TEX0, GX_IDENTITY);
+    GXSetTevOrder(GX_TEVSTAGE0, GX_TEXCOORD0, GX_TEXMAP0, GX_COLOR0A0);
+}
+
+enum QuadSetup { QUAD_SETUP_NONE, QUAD_SETUP_FILL, QUAD_SETUP_TEXTURE, QUAD_SETUP_GLYPHS };
+
+static void setupQuadRun(QuadSetup setup, QuadSetup current) {
+    if (setup == current)
+        return;
+
+    if (setup == QUAD_SETUP_FILL) {
+        setupFillVtx();
+        return;
+    }
+
+    if (current != QUAD_SETUP_TEXTURE && current != QUAD_SETUP_GLYPHS)
+        setupTextureVtx();
+
+    if (setup == QUAD_SETUP_TEXTURE) {
+        GXSetTevOp(GX_TEVSTAGE0, GX_MODULATE);
+        return;
+    }
+
+    // Glyph pages are intensity or alpha maps, so only their alpha is used
+    // and the colour comes from the vertex, as JUTResFont::setGX does
+    GXSetTevColorIn(GX_TEVSTAGE0, GX_CC_ZERO, GX_CC_ZERO, GX_CC_ZERO, GX_CC_RASC);
+    GXSetTevAlphaIn(GX_TEVSTAGE0, GX_CA_ZERO, GX_CA_TEXA, GX_CA_RASA, GX_CA_ZERO);
+    GXSetTevColorOp(GX_TEVSTAGE0, GX_TEV_ADD, GX_TB_ZERO, GX_CS_SCALE_1, GX_TRUE, GX_TEVPREV);
+    GXSetTevAlphaOp(GX_TEVSTAGE0, GX_TEV_ADD, GX_TB_ZERO, GX_CS_SCALE_1, GX_TRUE, GX_TEVPREV);
+}
+
+void TQuadBatch::flush(const J2DOrthoGraph *ortho) {
+    if (mQuadCount == 0)
+        return;
+
+    // Same 2D setup as the start of the draw handler
+    const_cast<J2DOrthoGraph *>(ortho)->setup2D();
+    GXSetViewport(0, 0, 640, 480, 0, 1);
+    {
+        Mtx44 mtx;
+        C_MTXOrtho(mtx, 16, 496, -BetterSMS::getScreenRatioAdjustX(),
+                   600.0f + BetterSMS::getScreenRatioAdjustX(), -1, 1);
+        GXSetProjection(mtx, GX_ORTHOGRAPHIC);
+    }
+
+    {
+        Mtx mtx;
+        PSMTXIdentity(mtx);
+        GXLoadPosMtxImm(mtx, GX_PNMTX0);
+        GXSetCurrentMtx(GX_PNMTX0);
+    }
+
+    GXSetNumChans(1);
+    GXSetChanCtrl(GX_COLOR0A0, GX_FALSE, GX_SRC_REG, GX_SRC_VTX, GX_LIGHT_NULL, GX_DF_NONE,
+                  GX_AF_NONE);
+    GXSetNumTevStages(1);
+    GXSetBlendMode(GX_BM_BLEND, GX_BL_SRCALPHA, GX_BL_INVSRCALPHA, GX_LO_SET);
+    GXSetAlphaCompare(GX_ALWAYS, 0, GX_AOP_AND, GX_ALWAYS, 0);
+    GXSetZMode(GX_FALSE, GX_ALWAYS, GX_FALSE);
+    GXSetCullMode(GX_CULL_NONE);
+
+    QuadSetup current = QUAD_SETUP_NONE;
+
+    size_t start = 0;
+    while (start < mQuadCount) {
+        JUTTexture *texture    = mQuads[start].mTexture;
+        const GXTexObj *glyphs = mQuads[start].mGlyphs;
+
+        // Only consecutive quads are merged, so the submission order stands
+        size_t end = start + 1;
+        while (end < mQuadCount && mQuads[end].mTexture == texture &&
+               mQuads[end].mGlyphs == glyphs)
+            ++end;
+
+        const bool isTextured = texture || glyphs;
+
+        if (texture) {
+            setupQuadRun(QUAD_SETUP_TEXTURE, current);
+            current = QUAD_SETUP_TEXTURE;
+            texture->load(GX_TEXMAP0);
+        } else if (glyphs) {
+            setupQuadRun(QUAD_SETUP_GLYPHS, current);
+            current = QUAD_SETUP_GLYPHS;
+            GXLoadTexObj(const_cast<GXTexObj *>(glyphs), GX_TEXMAP0);
+        } else {
+            setupQuadRun(QUAD_SETUP_FILL, current);
+            current = QUAD_SETUP_FILL;
+        }
+
+        GXBegin(GX_QUADS, GX_VTXFMT0, (end - start) * 4);
+        for (size_t i = start; i < end; ++i) {
+            const Quad &quad = mQuads[i];
+
+            const f32 x1 = quad.mX;
+            const f32 y1 = quad.mY;
+            const f32 x2 = quad.mX + quad.mW;
+            const f32 y2 = quad.mY + quad.mH;
+
+            const JUtility::TColor &c = quad.mColor;
+
+            GXPosition3f32(x1, y1, 0.0f);
+            GXColor4u8(c.r, c.g, c.b, c.a);
+            if (isTextured)
+                GXTexCoord2f32(quad.mU1, quad.mV1);
+
+            GXPosition3f32(x2, y1, 0.0f);
+            GXColor4u8(c.r, c.g, c.b, c.a);
+            if (isTextured)
+                GXTexCoord2f32(quad.mU2, quad.mV1);
+
+            GXPosition3f32(x2, y2, 0.0f);
+            GXColor4u8(c.r, c.g, c.b, c.a);
+            if (isTextured)
+                GXTexCoord2f32(quad.mU2, quad.mV2);
+
+            GXPosition3f32(x1, y2, 0.0f);
+            GXColor4u8(c.r, c.g, c.b, c.a);
+            if (isTextured)
+                GXTexCoord2f32(quad.mU1, quad.mV2);
+        }
+
+        start = end;
+    }
+}
+
+TQuadBatch &getQuadBatch(QuadLayer layer) { return sQuadBatches[layer]; }
+
+void flushQuadBatch(QuadLayer layer, const J2DOrthoGraph *ortho) {
+    sQuadBatches[layer].flush(ortho);
+}
+
+// Layers are filled by loop callbacks and replayed by every draw until the
+// next loop, so a skipped or repeated draw never duplicates quads. The
+// loading layer is cleared by the loading screen, which fills it as it draws.
+BETTER_SMS_FOR_CALLBACK void clearQuadBatches(TApplication *app) {
+    for (size_t i = QUAD_LAYER_LOADING + 1; i < QUAD_LAYER_COUNT; ++i) {
+        sQuadBatches[i].clear();
+    }
+}
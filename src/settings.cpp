@@ -32,10 +32,13 @@
 #include "libs/constmath.hxx"
 #include "libs/container.hxx"
 #include "libs/global_vector.hxx"
+#include "libs/lock.hxx"
 #include "libs/string.hxx"
+#include "logging.hxx"
 #include "module.hxx"
 #include "settings.hxx"
 
+#include "p_card.hxx"
 #include "p_icons.hxx"
 #include "p_module.hxx"
 #include "p_settings.hxx"
@@ -102,11 +105,23 @@ BETTER_SMS_FOR_EXPORT s32 Settings::unmountCard() {
     return CARDUnmount(sChannel);
 }
 
-BETTER_SMS_FOR_EXPORT s32 Settings::saveSettingsGroup(Settings::SettingsGroup &group) {
-    if (!group.isIOValid()) {
-        return CARD_ERROR_READY;
+static bool queueBootGroup(Settings::SettingsGroup &group);
+
+static void emitGroupSettings(Settings::SettingsGroup &group) {
+    for (auto &setting : group.getSettings()) {
+        setting->emit();
+        sNewUnlockMap.push_back(
+            {setting->getName(), setting->isUnlocked() && setting->isUserEditable()});
     }
+}
 
+// Groups read by the boot loader are emitted later on the game thread
+static void emitLoadedGroup(Settings::SettingsGroup &group) {
+    if (!queueBootGroup(group))
+        emitGroupSettings(group);
+}
+
+static s32 saveSettingsGroupFile(Settings::SettingsGroup &group) {
     CARDFileInfo finfo;
     s32 ret = OpenSavedSettings(group, finfo, true);
     if (ret < CARD_ERROR_READY) {
@@ -126,11 +141,8 @@ BETTER_SMS_FOR_EXPORT s32 Settings::saveSettingsGroup(Settings::SettingsGroup &g
     return CloseSavedSettings(group, &finfo);
 }
 
-BETTER_SMS_FOR_EXPORT s32 Settings::loadSettingsGroup(Settings::SettingsGroup &group) {
-    if (!group.isIOValid()) {
-        return CARD_ERROR_READY;
-    }
-
+// Reads the group's own card file, returns the open status
+static s32 readSettingsGroupFile(Settings::SettingsGroup &group) {
     CARDFileInfo finfo;
 
     int ret = OpenSavedSettings(group, finfo, false);
@@ -141,43 +153,380 @@ BETTER_SMS_FOR_EXPORT s32 Settings::loadSettingsGroup(Settings::SettingsGroup &g
                     "Failed to load settings for module \"%s\"! (VERSION MISMATCH)\n\n"
                     "Automatically resetting to defaults...",
                     Settings::getGroupName(group));
-            ret = UpdateSavedSettings(group, &finfo);
+            UpdateSavedSettings(group, &finfo);
         }
 
         CloseSavedSettings(group, &finfo);
     }
 
+    return ret;
+}
+
+#pragma region SettingsContainer
+
+#if BETTER_SMS_SETTINGS_CONTAINER
+
+// Every group that isn't saved globally shares one card file: the usual
+// comment, an index of module sections, one banner and icon set, then the
+// section data back to back. Boot loads and full saves become one open and
+// one sequential transfer. Groups missing from the index are read from their
+// own file and moved into the container once everything is loaded. Groups
+// that don't fit keep their own file.
+
+constexpr u32 SettingsContainerMagic          = 0x42534D53;  // 'BSMS'
+constexpr u16 SettingsContainerVersion        = 1;
+constexpr size_t SettingsContainerMaxSections = 32;
+constexpr size_t SettingsContainerIndexOffset = CARD_DIRENTRY_SIZE;
+
+static const char *sContainerFileName = "bettersms_settings";
+
+struct SettingsContainerSection {
+    char mSaveName[32];
+    u8 mMajorVersion;
+    u8 mMinorVersion;
+    u8 _22[2];
+    u32 mOffset;  // From the start of the file
+    u32 mSize;
+};
+
+struct SettingsContainerIndex {
+    u32 mMagic;
+    u16 mVersion;
+    u16 mBlocks;
+    u32 mSectionCount;
+    SettingsContainerSection mSections[SettingsContainerMaxSections];
+};
+
+constexpr size_t SettingsContainerBannerOffset =
+    (SettingsContainerIndexOffset + sizeof(SettingsContainerIndex) + 31) & ~31;
+
+static size_t sContainerBlocks = 0;  // Size of the file on the card, 0 if unknown
+static SMS_ALIGN(32) u8 sContainerSector[CARD_READ_SIZE];
+
+static SettingsContainerIndex *getContainerIndex() {
+    return reinterpret_cast<SettingsContainerIndex *>(sCardBuffer + SettingsContainerIndexOffset);
+}
+
+static bool isContainerGroup(const Settings::SettingsGroup &group) {
+    return group.isIOValid() && !group.getSaveInfo().mSaveGlobal;
+}
+
+// The index is read straight off the card, so its size must fit sCardBuffer
+static bool isContainerIndexValid(const SettingsContainerIndex &index) {
+    return index.mMagic == SettingsContainerMagic && index.mVersion == SettingsContainerVersion &&
+           index.mBlocks > 0 && index.mBlocks <= CARD_MAX_BLOCKS &&
+           index.mSectionCount <= SettingsContainerMaxSections;
+}
+
+// Reads the whole container into sCardBuffer, the first block carries the size
+static s32 readSettingsContainer() {
+    CARDFileInfo finfo;
+    s32 ret = CARD_RETRY(CARDOpen(sChannel, sContainerFileName, &finfo));
+    if (ret < CARD_ERROR_READY)
+        return ret;
+
+    ret = CARD_RETRY(CARDRead(&finfo, sCardBuffer, CARD_BLOCKS_TO_BYTES(1), 0));
+
+    const SettingsContainerIndex *index = getContainerIndex();
+    if (ret >= CARD_ERROR_READY && !isContainerIndexValid(*index))
+        ret = CARD_ERROR_BROKEN;
+
+    if (ret >= CARD_ERROR_READY) {
+        sContainerBlocks = index->mBlocks;
+        if (index->mBlocks > 1) {
+            ret = CARD_RETRY(CARDRead(&finfo, sCardBuffer + CARD_BLOCKS_TO_BYTES(1),
+                                      CARD_BLOCKS_TO_BYTES(index->mBlocks - 1),
+                                      CARD_BLOCKS_TO_BYTES(1)));
+        }
+    }
+
+    CARDClose(&finfo);
+    return ret;
+}
+
+static const SettingsContainerSection *findContainerSection(const Settings::SettingsGroup &group) {
+    const SettingsContainerIndex *index = getContainerIndex();
+    for (u32 i = 0; i < index->mSectionCount; ++i) {
+        if (strncmp(index->mSections[i].mSaveName, group.getSaveInfo().mSaveName, 31) == 0)
+            return &index->mSections[i];
+    }
+    return nullptr;
+}
+
+static void loadContainerSection(Settings::SettingsGroup &group,
+                                 const SettingsContainerSection &section) {
+    if (section.mMajorVersion != group.getMajorVersion()) {
+        // Defaults stay in place and replace the section on the next save
+        Console::record(Console::LEVEL_WARNING, Console::CATEGORY_SETTINGS,
+                        "Settings for module \"%s\" are from another version, using defaults!\n",
+                        Settings::getGroupName(group));
+        return;
+    }
+
+    JSUMemoryInputStream in(sCardBuffer + section.mOffset, section.mSize);
     for (auto &setting : group.getSettings()) {
-        setting->emit();
-        sNewUnlockMap.push_back(
-            {setting->getName(), setting->isUnlocked() && setting->isUserEditable()});
+        setting->load(in);
     }
+}
 
-    return CloseSavedSettings(group, &finfo);
+// Loads every group with a section in the container, the rest are returned in missing
+static void loadSettingsContainer(const TGlobalVector<Settings::SettingsGroup *> &groups,
+                                  TGlobalVector<Settings::SettingsGroup *> &missing) {
+    const bool isRead = readSettingsContainer() >= CARD_ERROR_READY;
+
+    for (auto &group : groups) {
+        if (!group->isIOValid())
+            continue;
+
+        const SettingsContainerSection *section =
+            isRead && isContainerGroup(*group) ? findContainerSection(*group) : nullptr;
+        if (!section) {
+            missing.push_back(group);
+            continue;
+        }
+
+        loadContainerSection(*group, *section);
+        emitLoadedGroup(*group);
+    }
+}
+
+// Serializes every container group from memory and writes the file in one go.
+// Groups that are global or don't fit are returned in leftover.
+static s32 writeSettingsContainer(const TGlobalVector<Settings::SettingsGroup *> &groups,
+                                  TGlobalVector<Settings::SettingsGroup *> &leftover) {
+    if (groups.size() == 0)
+        return CARD_ERROR_READY;
+
+    // The core group is always first and provides the banner and icons
+    const Settings::SettingsSaveInfo &bannerInfo = groups[0]->getSaveInfo();
+
+    memset(sCardBuffer, 0, sizeof(sCardBuffer));
+
+    snprintf(sCardBuffer + 4, 32, "%s", BETTER_SMS_MODULE_NAME);
+    {
+        OSCalendarTime calendar;
+        OSTicksToCalendarTime(OSGetTime(), &calendar);
+        snprintf(sCardBuffer + 36, 28, "Module Settings (%lu/%lu/%lu)", calendar.mon + 1,
+                 calendar.mday, calendar.year);
+    }
+
+    memcpy(sCardBuffer + SettingsContainerBannerOffset,
+           reinterpret_cast<const u8 *>(bannerInfo.mBannerImage) +
+               bannerInfo.mBannerImage->mTextureOffset,
+           0xE00);
+    memcpy(sCardBuffer + SettingsContainerBannerOffset + 0xE00,
+           reinterpret_cast<const u8 *>(bannerInfo.mIconTable) +
+               bannerInfo.mIconTable->mTextureOffset,
+           0x500 * bannerInfo.mIconCount);
+
+    SettingsContainerIndex *index = getContainerIndex();
+    index->mMagic                 = SettingsContainerMagic;
+    index->mVersion               = SettingsContainerVersion;
+
+    size_t dataPos = SettingsContainerBannerOffset + 0xE00 + (0x500 * bannerInfo.mIconCount);
+    for (auto &group : groups) {
+        if (!group->isIOValid())
+            continue;
+
+        if (!isContainerGroup(*group) || index->mSectionCount == SettingsContainerMaxSections) {
+            leftover.push_back(group);
+            continue;
+        }
+
+        JSUMemoryOutputStream out(sCardBuffer + dataPos, sizeof(sCardBuffer) - dataPos);
+        for (auto &setting : group->getSettings()) {
+            setting->save(out);
+        }
+
+        if (!out.isGood()) {
+            memset(sCardBuffer + dataPos, 0, sizeof(sCardBuffer) - dataPos);
+            leftover.push_back(group);
+            continue;
+        }
+
+        SettingsContainerSection &section = index->mSections[index->mSectionCount++];
+        snprintf(section.mSaveName, sizeof(section.mSaveName), "%s",
+                 group->getSaveInfo().mSaveName);
+        section.mMajorVersion = group->getMajorVersion();
+        section.mMinorVersion = group->getMinorVersion();
+        section.mOffset       = dataPos;
+        section.mSize         = out.getPosition();
+
+        dataPos += section.mSize;
+    }
+
+    const size_t blocks = (dataPos + CARD_BLOCKS_TO_BYTES(1) - 1) / CARD_BLOCKS_TO_BYTES(1);
+    index->mBlocks      = blocks;
+
+    CARDFileInfo finfo;
+    s32 ret = CARD_RETRY(CARDOpen(sChannel, sContainerFileName, &finfo));
+
+    // An existing file of unknown size is checked through its own index, one
+    // that can't be trusted is replaced
+    if (ret >= CARD_ERROR_READY && sContainerBlocks == 0) {
+        if (CARD_RETRY(CARDRead(&finfo, sContainerSector, CARD_READ_SIZE, 0)) >=
+            CARD_ERROR_READY) {
+            const SettingsContainerIndex *existing = reinterpret_cast<SettingsContainerIndex *>(
+                sContainerSector + SettingsContainerIndexOffset);
+            if (isContainerIndexValid(*existing))
+                sContainerBlocks = existing->mBlocks;
+        }
+    }
+
+    if (ret >= CARD_ERROR_READY && sContainerBlocks < blocks) {
+        CARDClose(&finfo);
+        CARD_RETRY(CARDDelete(sChannel, sContainerFileName));
+        ret = CARD_ERROR_NOFILE;
+    }
+
+    if (ret == CARD_ERROR_NOFILE) {
+        ret = CARD_RETRY(
+            CARDCreate(sChannel, sContainerFileName, CARD_BLOCKS_TO_BYTES(blocks), &finfo));
+        if (ret >= CARD_ERROR_READY)
+            sContainerBlocks = blocks;
+    }
+
+    if (ret < CARD_ERROR_READY)
+        return ret;
+
+    // A larger file from an earlier save keeps its size, the tail is zeroed
+    index->mBlocks = sContainerBlocks;
+
+    ret = UpdateSettingsStatus(&finfo, bannerInfo, SettingsContainerBannerOffset);
+    if (ret >= CARD_ERROR_READY)
+        ret = CARD_RETRY(
+            CARDWrite(&finfo, sCardBuffer, CARD_BLOCKS_TO_BYTES(sContainerBlocks), 0));
+
+    CARDClose(&finfo);
+
+    if (ret == CARD_ERROR_READY)
+        Console::record(Console::LEVEL_INFO, Console::CATEGORY_SETTINGS,
+                        "Saved settings for %lu modules to the settings container!\n",
+                        index->mSectionCount);
+    return ret;
+}
+
+static void deleteSettingsGroupFile(const Settings::SettingsGroup &group) {
+    char normalizedPath[32];
+    NormalizeSettingsPath(group.getSaveInfo(), normalizedPath);
+    CARD_RETRY(CARDDelete(sChannel, normalizedPath));
+}
+
+static bool saveSettingsGroups(const TGlobalVector<Settings::SettingsGroup *> &groups) {
+    TGlobalVector<Settings::SettingsGroup *> leftover;
+    if (writeSettingsContainer(groups, leftover) < CARD_ERROR_READY)
+        return false;
+
+    for (auto &group : leftover) {
+        if (saveSettingsGroupFile(*group) < CARD_ERROR_READY)
+            return false;
+    }
+
+    return true;
+}
+
+static void loadSettingsGroups(const TGlobalVector<Settings::SettingsGroup *> &groups) {
+    TGlobalVector<Settings::SettingsGroup *> missing;
+    loadSettingsContainer(groups, missing);
+
+    TGlobalVector<Settings::SettingsGroup *> migrated;
+    for (auto &group : missing) {
+        if (readSettingsGroupFile(*group) >= CARD_ERROR_READY && isContainerGroup(*group))
+            migrated.push_back(group);
+        emitLoadedGroup(*group);
+    }
+
+    if (migrated.size() == 0)
+        return;
+
+    // Move the per module files into the container, they are only removed
+    // once the container holds their section
+    TGlobalVector<Settings::SettingsGroup *> leftover;
+    if (writeSettingsContainer(groups, leftover) < CARD_ERROR_READY)
+        return;
+
+    for (auto &group : migrated) {
+        if (findContainerSection(*group)) {
+            Console::record(Console::LEVEL_INFO, Console::CATEGORY_SETTINGS,
+                            "Migrated settings for module \"%s\" into the settings container!\n",
+                            Settings::getGroupName(*group));
+            deleteSettingsGroupFile(*group);
+        }
+    }
+}
+
+#endif
+
+#pragma endregion
+
+BETTER_SMS_FOR_EXPORT s32 Settings::saveSettingsGroup(Settings::SettingsGroup &group) {
+    if (!group.isIOValid()) {
+        return CARD_ERROR_READY;
+    }
+
+#if BETTER_SMS_SETTINGS_CONTAINER
+    // The container is written as a whole from the in memory values
+    if (isContainerGroup(group)) {
+        TGlobalVector<Settings::SettingsGroup *> groups;
+        getSettingsGroups(groups);
+        return saveSettingsGroups(groups) ? CARD_ERROR_READY : CARD_ERROR_IOERROR;
+    }
+#endif
+
+    return saveSettingsGroupFile(group);
+}
+
+BETTER_SMS_FOR_EXPORT s32 Settings::loadSettingsGroup(Settings::SettingsGroup &group) {
+    if (!group.isIOValid()) {
+        return CARD_ERROR_READY;
+    }
+
+#if BETTER_SMS_SETTINGS_CONTAINER
+    if (isContainerGroup(group) && readSettingsContainer() >= CARD_ERROR_READY) {
+        if (const SettingsContainerSection *section = findContainerSection(group)) {
+            loadContainerSection(group, *section);
+            emitLoadedGroup(group);
+            return CARD_ERROR_READY;
+        }
+    }
+#endif
+
+    s32 ret = readSettingsGroupFile(group);
+    emitLoadedGroup(group);
+    return ret;
 }
 
 BETTER_SMS_FOR_EXPORT bool Settings::saveAllSettings() {
     TGlobalVector<Settings::SettingsGroup *> groups;
     getSettingsGroups(groups);
 
+#if BETTER_SMS_SETTINGS_CONTAINER
+    return saveSettingsGroups(groups);
+#else
     for (auto &group : groups) {
         if (saveSettingsGroup(*group) < CARD_ERROR_READY)
             return false;
     }
 
     return true;
+#endif
 }
 
 BETTER_SMS_FOR_EXPORT bool Settings::loadAllSettings() {
     TGlobalVector<Settings::SettingsGroup *> groups;
     getSettingsGroups(groups);
 
+#if BETTER_SMS_SETTINGS_CONTAINER
+    loadSettingsGroups(groups);
+    return true;
+#else
     for (auto &group : groups) {
         if (loadSettingsGroup(*group) < CARD_ERROR_READY)
             return false;
     }
 
     return true;
+#endif
 }
 
 #define DISK_GAME_ID (void *)0x80000000
@@ -198,6 +547,9 @@ void getSettingsGroups(TGlobalVector<Settings::SettingsGroup *> &out) {
 
     for (auto &item : gModuleInfos) {
         Settings::SettingsGroup *group = item.mSettings;
+        if (!group)  // No settings registered
+            continue;
+
         if (strcmp(item.mName, "Better Sunshine Engine") == 0) {
             tempCore.insert(tempCore.begin(), group);
             continue;
@@ -229,26 +581,149 @@ void getSettingsGroups(TGlobalVector<Settings::SettingsGroup *> &out) {
     }
 }
 
+#pragma region BootLoad
+
+// The card mount and every group load run on their own thread at boot, so
+// the card I/O overlaps the boot archives instead of preceding them. The
+// loader sits above the game thread but spends nearly all of its time
+// waiting on the card. Consumers only block until the groups they read are
+// in. Loaded groups are queued and their value callbacks run on the game
+// thread when it next waits, never on the loader.
+
+constexpr OSPriority BootLoadPriority = OSPriority(15);
+
+static u8 SMS_ALIGN(32) sBootLoadStack[0x4000];
+static OSThread sBootLoadThread;
+static OSThreadQueue sBootLoadQueue;
+static TGlobalVector<Settings::SettingsGroup *> sBootGroups;
+
+// Reserved for every boot group up front so the loader never reallocates it
+static TGlobalVector<Settings::SettingsGroup *> sLoadedGroups;
+static size_t sEmittedGroupCount    = 0;
+static volatile bool sIsBootLoading = false;
+static bool sIsBootLoadReported     = false;
+
+static OSTime sBootLoadStart   = 0;
+static OSTime sBootLoadEnd     = 0;
+static OSTime sBootBlockedTime = 0;
+
+static bool queueBootGroup(Settings::SettingsGroup &group) {
+    if (OSGetCurrentThread() != &sBootLoadThread)
+        return false;
+
+    {
+        TAtomicGuard guard;
+        sLoadedGroups.push_back(&group);
+    }
+    OSWakeupThread(&sBootLoadQueue);
+    return true;
+}
+
+static bool isGroupLoaded(const Settings::SettingsGroup &group) {
+    for (auto &loaded : sLoadedGroups) {
+        if (loaded == &group)
+            return true;
+    }
+    return false;
+}
+
+// Runs the value callbacks the loader queued, in load order
+static void emitBootGroups() {
+    for (;;) {
+        Settings::SettingsGroup *group;
+        {
+            TAtomicGuard guard;
+            if (sEmittedGroupCount >= sLoadedGroups.size())
+                return;
+            group = sLoadedGroups[sEmittedGroupCount++];
+        }
+        emitGroupSettings(*group);
+    }
+}
+
+static void *bootLoadThreadMain(void *arg) {
+    if (Settings::mountCard() >= CARD_ERROR_READY) {
+#if BETTER_SMS_SETTINGS_CONTAINER
+        loadSettingsGroups(sBootGroups);
+#else
+        for (auto &group : sBootGroups) {
+            Settings::loadSettingsGroup(*group);
+        }
+#endif
+        Settings::unmountCard();
+    }
+
+    {
+        TAtomicGuard guard;
+        sBootLoadEnd   = OSGetTime();
+        sIsBootLoading = false;
+    }
+    OSWakeupThread(&sBootLoadQueue);
+    return nullptr;
+}
+
 BETTER_SMS_FOR_CALLBACK void initAllSettings(TApplication *app) {
     sSunshineSettingsGroup.addSetting(&sRumbleSetting);
     sSunshineSettingsGroup.addSetting(&sSoundSetting);
     sSunshineSettingsGroup.addSetting(&sSubtitleSetting);
 
     InitCard();
-    if (Settings::mountCard() < CARD_ERROR_READY)
-        return;
 
-    for (BetterSMS::ModuleInfo &init : gModuleInfos) {
-        Settings::SettingsGroup *settingsGroup = init.mSettings;
-        if (!settingsGroup)  // No settings registered
-            continue;
+    // The core group comes first so the earliest consumer is released first
+    getSettingsGroups(sBootGroups);
+    sLoadedGroups.reserve(sBootGroups.size());
+
+    OSInitThreadQueue(&sBootLoadQueue);
+    sBootLoadStart = OSGetTime();
+    sIsBootLoading = true;
 
-        Settings::loadSettingsGroup(*settingsGroup);
+    OSCreateThread(&sBootLoadThread, bootLoadThreadMain, nullptr,
+                   sBootLoadStack + sizeof(sBootLoadStack), sizeof(sBootLoadStack),
+                   BootLoadPriority, OS_THREAD_ATTR_DETACH);
+    OSResumeThread(&sBootLoadThread);
+}
+
+static void blockOnBootLoad(const Settings::SettingsGroup *group) {
+    const OSTime start = OSGetTime();
+    {
+        TAtomicGuard guard;
+        while (sIsBootLoading && (!group || !isGroupLoaded(*group))) {
+            OSSleepThread(&sBootLoadQueue);
+        }
     }
+    sBootBlockedTime += OSGetTime() - start;
+}
 
-    Settings::unmountCard();
+BETTER_SMS_FOR_EXPORT void Settings::waitForSettingsGroup(const SettingsGroup &group) {
+    if (sIsBootLoading)
+        blockOnBootLoad(&group);
+    emitBootGroups();
+}
+
+BETTER_SMS_FOR_EXPORT void Settings::waitForAllSettings() {
+    if (sIsBootLoading)
+        blockOnBootLoad(nullptr);
+    emitBootGroups();
+
+    if (sIsBootLoadReported || sBootLoadEnd == 0)
+        return;
+    sIsBootLoadReported = true;
+
+    const u32 loadMs    = static_cast<u32>(OSTicksToMilliseconds(sBootLoadEnd - sBootLoadStart));
+    const u32 blockedMs = static_cast<u32>(OSTicksToMilliseconds(sBootBlockedTime));
+    Console::record(Console::LEVEL_INFO, Console::CATEGORY_SETTINGS,
+                    "Loaded %lu groups in %lums, the game thread waited %lums (%lums "
+                    "overlapped)\n",
+                    sLoadedGroups.size(), loadMs, blockedMs, loadMs - Min(loadMs, blockedMs));
+}
+
+void waitForCoreSettings() {
+    if (sBootGroups.size() > 0)
+        Settings::waitForSettingsGroup(*sBootGroups[0]);
 }
 
+#pragma endregion
+
 void InitCard() { CARDInit(); }
 
 s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, bool canCreate) {
@@ -256,12 +731,7 @@ s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, boo
 
     // Create and open save file for this group
     char normalizedPath[32];
-    for (int i = 0; i < 32; ++i) {
-        if (info.mSaveName[i] == ' ')
-            normalizedPath[i] = '_';
-        else
-            normalizedPath[i] = tolower(info.mSaveName[i]);
-    }
+    NormalizeSettingsPath(info, normalizedPath);
 
     if (info.mSaveGlobal)
         __CARDSetDiskID(&info.mGameCode);
@@ -291,6 +761,40 @@ s32 OpenSavedSettings(Settings::SettingsGroup &group, CARDFileInfo &infoOut, boo
     return CARD_ERROR_READY;
 }
 
+void NormalizeSettingsPath(const Settings::SettingsSaveInfo &info, char *out) {
+    for (int i = 0; i < 32; ++i) {
+        if (info.mSaveName[i] == ' ')
+            out[i] = '_';
+        else
+            out[i] = tolower(info.mSaveName[i]);
+    }
+}
+
+s32 UpdateSettingsStatus(CARDFileInfo *finfo, const Settings::SettingsSaveInfo &info,
+                         u32 iconAddr) {
+    CARDStat fstatus;
+
+    // Work out status
+    int statusRet = CARDGetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
+    if (statusRet < CARD_ERROR_READY)
+        return statusRet;
+
+    fstatus.mGameCode = info.mGameCode;
+    fstatus.mCompany  = info.mCompany;
+    CARDSetBannerFmt(&fstatus, info.mBannerFmt);
+    CARDSetIconAddr(&fstatus, iconAddr);
+    CARDSetCommentAddr(&fstatus, 4);
+    for (s32 i = 0; i < info.mIconCount; ++i) {
+        CARDSetIconFmt(&fstatus, i, info.mIconFmt);
+        CARDSetIconSpeed(&fstatus, i, info.mIconSpeed);
+    }
+    fstatus.mLastModified = OSTicksToSeconds(OSGetTime());
+
+    // As before, a failed update only costs the banner and the data is still written
+    CARDSetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
+    return CARD_ERROR_READY;
+}
+
 s32 UpdateSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo) {
     Settings::SettingsSaveInfo &info = group.getSaveInfo();
     if (info.mBlocks > CARD_MAX_BLOCKS) {
@@ -301,25 +805,9 @@ s32 UpdateSavedSettings(Settings::SettingsGroup &group, CARDFileInfo *finfo) {
     }
 
     {
-        CARDStat fstatus;
-
-        // Work out status
-        int statusRet = CARDGetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
+        int statusRet = UpdateSettingsStatus(finfo, info, CARD_DIRENTRY_SIZE);
         if (statusRet < CARD_ERROR_READY)
             return statusRet;
-
-        fstatus.mGameCode = info.mGameCode;
-        fstatus.mCompany  = info.mCompany;
-        CARDSetBannerFmt(&fstatus, info.mBannerFmt);
-        CARDSetIconAddr(&fstatus, CARD_DIRENTRY_SIZE);
-        CARDSetCommentAddr(&fstatus, 4);
-        for (s32 i = 0; i < info.mIconCount; ++i) {
-            CARDSetIconFmt(&fstatus, i, info.mIconFmt);
-            CARDSetIconSpeed(&fstatus, i, info.mIconSpeed);
-        }
-        fstatus.mLastModified = OSTicksToSeconds(OSGetTime());
-
-        CARDSetStatus(finfo->mChannel, finfo->mFileNo, &fstatus);
     }
 
     const size_t saveDataSize = CARD_BLOCKS_TO_BYTES(info.mBlocks);
@@ -485,19 +973,28 @@ s32 SaveAllSettings() {
         gpCardManager->mount_(true);
     }
 
-    {
-        JSUMemoryOutputStream out(nullptr, 0);
-        gpCardManager->getOptionWriteStream(&out);
-        TFlagManager::smInstance->saveOption(out);
-        gpCardManager->writeOptionBlock();
-
-        OSReport("Last Status (Option Save): %d\n", gpCardManager->getLastStatus());
-    }
+    SaveOptionBlock();
+    Console::record(Console::LEVEL_DEBUG, Console::CATEGORY_SETTINGS,
+                    "Last Status (Option Save): %d\n", gpCardManager->getLastStatus());
 
     return CARD_ERROR_READY;
 }
 
-SettingsDirector::~SettingsDirector() { gpMSound->exitStage(); }
+// Language, rumble and sound, the card must already be mounted
+void SaveOptionBlock() {
+    JSUMemoryOutputStream out(nullptr, 0);
+    gpCardManager->getOptionWriteStream(&out);
+    TFlagManager::smInstance->saveOption(out);
+    gpCardManager->writeOptionBlock();
+}
+
+SettingsDirector::~SettingsDirector() {
+    gpMSound->exitStage();
+
+    // The screen goes with the stage heap without being destroyed
+    if (mSettingScreen)
+        mSettingScreen->mDisplayList.release();
+}
 
 s32 SettingsDirector::direct() {
     s32 ret = 1;
@@ -551,11 +1048,22 @@ s32 SettingsDirector::direct() {
         mSaveErrorPanel->appear();
         saveSettings();
         break;
-    case State::SAVE_BUSY:
+    case State::SAVE_BUSY: {
         mSettingScreen->mPerformFlags |= 0b0001;    // Disable input
         mSaveErrorPanel->mPerformFlags &= ~0b1011;  // Enable view and input
         mIntSettingPanel->mPerformFlags |= 0b1011;  // Disable view and input
+
+        s32 status;
+        if (takeMenuSaveResult(status)) {
+            if (status < CARD_ERROR_READY) {
+                failSave(status);
+            } else {
+                mState     = State::SAVE_SUCCESS;
+                mErrorCode = CARD_ERROR_READY;
+            }
+        }
         break;
+    }
     case State::SAVE_FAIL:
         [[fallthrough]];
     case State::SAVE_SUCCESS:
@@ -654,6 +1162,9 @@ extern Settings::SwitchSetting gCameraInvertYSetting;
 bool BetterSMS::isCameraInvertedY() { return gCameraInvertYSetting.getBool(); }
 
 void SettingsDirector::initialize() {
+    // Every group is shown, the menu can open before GAME_BOOT has waited
+    Settings::waitForAllSettings();
+
     sRumbleSetting.setBool(TFlagManager::smInstance->getBool(0x90000));
     sSoundSetting.setInt(TFlagManager::smInstance->getFlag(0xA0000));
     sSubtitleSetting.setBool(TFlagManager::smInstance->getBool(0x90001));
@@ -1136,64 +1647,15 @@ void SettingsDirector::initializeIntSettingLayout() {
     }
 }
 
-void *SettingsDirector::saveThreadFunc(void *data) {
-    auto director = reinterpret_cast<SettingsDirector *>(data);
-    director->saveSettings_();
-    return nullptr;
-}
-
+// The card work happens on the autosave worker, SAVE_BUSY polls for the result
 void SettingsDirector::saveSettings() {
-    OSCreateThread(&gSetupThread, saveThreadFunc, this, gpSetupThreadStack + 0x10000, 0x10000, 17,
-                   0);
-    OSResumeThread(&gSetupThread);
-    mState = State::SAVE_BUSY;
-}
-
-void SettingsDirector::saveSettings_() {
-    char statusBuf[40];
-    char messageBuf[100];
-
-    {
-        gpCardManager->mount_(true);
-
-        // Save base game settings (language, etc)
-        sRumbleSetting.emit();
-        sSubtitleSetting.emit();
-        sSoundSetting.emit();
-
-        {
-            JSUMemoryOutputStream out(nullptr, 0);
-            gpCardManager->getOptionWriteStream(&out);
-            TFlagManager::smInstance->saveOption(out);
-            gpCardManager->writeOptionBlock();
-        }
-
-        gpCardManager->unmount();
-    }
+    // Save base game settings (language, etc)
+    sRumbleSetting.emit();
+    sSubtitleSetting.emit();
+    sSoundSetting.emit();
 
-    {
-        s32 cardStatus = Settings::mountCard();
-
-        if (cardStatus < CARD_ERROR_READY) {
-            failSave(cardStatus);
-            return;
-        }
-
-        CARDFileInfo finfo;
-
-        TGlobalVector<Settings::SettingsGroup *> groups;
-        getSettingsGroups(groups);
-
-        Settings::saveAllSettings();
-
-        Settings::unmountCard();
-    }
-
-    gpCardManager->mount_(true);
-
-    mState     = State::SAVE_SUCCESS;
-    mErrorCode = CARD_ERROR_READY;
-    return;
+    requestMenuSave();
+    mState = State::SAVE_BUSY;
 }
 
 void SettingsDirector::failSave(int errorcode) {
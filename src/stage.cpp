@@ -1,4 +1,5 @@
 #include <Dolphin/DVD.h>
+#include <Dolphin/string.h>
 #include <JSystem/J2D/J2DOrthoGraph.hxx>
 #include <JSystem/JDrama/JDRNameRef.hxx>
 
@@ -198,9 +199,48 @@ void BetterSMS::Stage::TStageParams::load(const char *stageName) {
     reset();
 }
 
+extern void beginLoadingPhase(Loading::Phase phase);
+extern void runStagePreload(TMarDirector *director);
+
+static u32 getStageArchiveSize() {
+    const char *stageName = Stage::getStageName(gpApplication.mCurrentScene.mAreaID,
+                                                gpApplication.mCurrentScene.mEpisodeID);
+    if (!stageName)
+        return 0;
+
+    // The archive is named .arc in the stage table but stored compressed as .szs
+    char path[64];
+    snprintf(path, 64, "/data/scene/%s", stageName);
+    char *loc = strstr(path, ".arc");
+    if (loc) {
+        strncpy(loc, ".szs", 4);
+    }
+
+    const s32 entrynum = DVDConvertPathToEntrynum(path);
+    if (entrynum < 0)
+        return 0;
+
+    DVDFileInfo fileInfo;
+    DVDFastOpen(entrynum, &fileInfo);
+    const u32 size = fileInfo.mLen;
+    DVDClose(&fileInfo);
+
+    return size;
+}
+
+// Runs on the director's setup thread while the render thread keeps drawing the loading screen
 void initStageLoading(TMarDirector *director) {
     Loading::setLoading(true);
-    director->loadResource();
+
+    beginLoadingPhase(Loading::PHASE_ARCHIVES);
+    {
+        const u32 archiveSize = getStageArchiveSize();
+        Loading::addArchivesExpected(1, archiveSize);
+        director->loadResource();
+        Loading::reportArchiveLoaded(archiveSize);
+    }
+
+    runStagePreload(director);
 }
 SMS_PATCH_BL(SMS_PORT_REGION(0x80296DE0, 0x80291750, 0, 0), initStageLoading);
 
@@ -239,6 +279,8 @@ BETTER_SMS_FOR_CALLBACK void resetStageConfig(TApplication *) {
 }
 
 void initStageCallbacks(TMarDirector *director) {
+    beginLoadingPhase(Loading::PHASE_OBJECTS);
+
     TFlagManager::smInstance->resetStage();
 
     loadStageConfig(director);
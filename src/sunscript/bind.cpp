@@ -1,5 +1,9 @@
+#include <Dolphin/OS.h>
+#include <Dolphin/string.h>
+#include <JSystem/JKernel/JKRFileLoader.hxx>
 #include <SMS/SPC/SpcBinary.hxx>
 
+#include "logging.hxx"
 #include "module.hxx"
 #include "sunscript.hxx"
 #include "p_sunscript.hxx"
@@ -8,12 +12,25 @@
 
 using namespace BetterSMS;
 
+// Builtins are interned by name hash when registered, and an SPC binary is
+// bound in one pass over its own symbol table, so only the builtins a script
+// actually references go through bindSystemDataToSymbol (itself a linear
+// symbol search). Binaries whose table doesn't check out against their
+// archive size, or that bind nothing through it, fall back to binding every
+// builtin by name.
+
 struct BuiltinData {
+    const char *mKey;
+    u32 mHash;
+    Spc::SpcFunction mFn;
+};
+
+struct BuiltinEntry {
     const char *mKey;
     Spc::SpcFunction mFn;
 };
 
-static const BuiltinData sBuiltinDataBSMS[] = {
+static const BuiltinEntry sBuiltinDataBSMS[] = {
     {"spawnObjByID", Spc::spawnObjByID},
     {"getPlayerInputByIndex", Spc::getPlayerInputByIndex},
     {"getStageBGM", Spc::getStageBGM},
@@ -30,32 +47,260 @@ static const BuiltinData sBuiltinDataBSMS[] = {
     {"setStreamLooping", Spc::setStreamLooping},
 };
 
+constexpr size_t BuiltinMaxCount  = 256;
+constexpr size_t BuiltinTableSize = 512;  // Power of two, at most half full
+
+// SPCB layout as the script compilers write it, 0x14 byte symbols followed
+// by their name table. Nothing here is trusted until it is checked against
+// the size of the resource.
+constexpr u32 SpcMagic         = 0x53504342;  // 'SPCB'
+constexpr u32 SpcHeaderSize    = 0x1C;
+constexpr u32 SpcSymbolOffset  = 0x10;
+constexpr u32 SpcSymbolCount   = 0x14;
+constexpr u32 SpcSymbolSize    = 0x14;
+constexpr u32 SpcSymbolNameOfs = 0x4;
+
 static TGlobalVector<BuiltinData> sBuiltinDatas;
+static u16 sBuiltinSlots[BuiltinTableSize] = {};  // Index + 1 into sBuiltinDatas, 0 is empty
+static bool sIsCoreInterned                = false;
 
-bool BetterSMS::Spc::registerBuiltinFunction(const char *key, SpcFunction function) {
-    for (const BuiltinData &data : sBuiltinDatas) {
-        if (data.mKey == key) {
+static u32 hashSymbol(const char *key) {
+    u32 hash = 2166136261;
+    for (; *key != '\0'; ++key) {
+        hash ^= static_cast<u8>(*key);
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+static s32 findBuiltin(const char *key, u32 hash) {
+    for (u32 slot = hash & (BuiltinTableSize - 1);; slot = (slot + 1) & (BuiltinTableSize - 1)) {
+        const u16 entry = sBuiltinSlots[slot];
+        if (entry == 0)
+            return -1;
+
+        const BuiltinData &data = sBuiltinDatas[entry - 1];
+        if (data.mHash == hash && strcmp(data.mKey, key) == 0)
+            return entry - 1;
+    }
+}
+
+// A later registration of a name replaces the earlier one, so modules can
+// override the BetterSMS builtins
+static bool internBuiltin(const char *key, Spc::SpcFunction function) {
+    const u32 hash    = hashSymbol(key);
+    const s32 current = findBuiltin(key, hash);
+    if (current >= 0) {
+        BuiltinData &data = sBuiltinDatas[current];
+        if (data.mKey == key)
             return false;
-        }
+        data.mFn = function;
+        return true;
+    }
+
+    if (sBuiltinDatas.size() >= BuiltinMaxCount) {
+        Console::record(Console::LEVEL_WARNING, Console::CATEGORY_SUNSCRIPT,
+                        "Builtin table is full, \"%s\" was not registered\n", key);
+        return false;
+    }
+
+    u32 slot = hash & (BuiltinTableSize - 1);
+    while (sBuiltinSlots[slot] != 0) {
+        slot = (slot + 1) & (BuiltinTableSize - 1);
     }
-    sBuiltinDatas.push_back({key, function});
+
+    sBuiltinDatas.push_back({key, hash, function});
+    sBuiltinSlots[slot] = static_cast<u16>(sBuiltinDatas.size());
     return true;
 }
 
-#define BIND_SYMBOL(binary, symbol, func)                                                          \
-    (binary)->bindSystemDataToSymbol((symbol), reinterpret_cast<u32>((func)))
+// BetterSMS builtins come first so they keep the low profiling slots
+static void internCoreBuiltins() {
+    if (sIsCoreInterned)
+        return;
+    sIsCoreInterned = true;
 
-static void initModuleFunctions(TSpcBinary* spcBinary) {
-    spcBinary->initUserBuiltin();
+    for (const BuiltinEntry &entry : sBuiltinDataBSMS) {
+        internBuiltin(entry.mKey, entry.mFn);
+    }
+}
+
+bool BetterSMS::Spc::registerBuiltinFunction(const char *key, SpcFunction function) {
+    internCoreBuiltins();
+    return internBuiltin(key, function);
+}
+
+#pragma region Profiling
+
+#if SMS_DEBUG
+
+// In debug builds each of the first BuiltinProfileSlots builtins is bound
+// through its own thunk, which counts the calls and the time spent in it.
+
+struct BuiltinProfile {
+    u32 mCalls;
+    OSTime mTicks;
+    OSTime mMaxTicks;
+};
+
+static BuiltinProfile sBuiltinProfiles[BuiltinProfileSlots] = {};
+static Spc::SpcFunction sProfileThunks[BuiltinProfileSlots] = {};
+
+template <u32 Slot> static void profiledBuiltin(TSpcInterp *interp, u32 argc) {
+    const OSTime start = OSGetTime();
+    sBuiltinDatas[Slot].mFn(interp, argc);
+    const OSTime ticks = OSGetTime() - start;
+
+    BuiltinProfile &profile = sBuiltinProfiles[Slot];
+    profile.mCalls += 1;
+    profile.mTicks += ticks;
+    if (ticks > profile.mMaxTicks)
+        profile.mMaxTicks = ticks;
+}
+
+template <u32 Slot> static void fillProfileThunks() {
+    sProfileThunks[Slot] = profiledBuiltin<Slot>;
+    if constexpr (Slot > 0)
+        fillProfileThunks<Slot - 1>();
+}
+
+SpcBuiltinStats getHottestSpcBuiltin() {
+    SpcBuiltinStats stats = {nullptr, 0, 0};
+
+    OSTime hottest = 0;
+    for (size_t i = 0; i < BuiltinProfileSlots && i < sBuiltinDatas.size(); ++i) {
+        if (sBuiltinProfiles[i].mTicks <= hottest)
+            continue;
+        hottest       = sBuiltinProfiles[i].mTicks;
+        stats.mName   = sBuiltinDatas[i].mKey;
+        stats.mCalls  = sBuiltinProfiles[i].mCalls;
+        stats.mMicros = static_cast<u32>(OSTicksToMicroseconds(hottest));
+    }
+
+    return stats;
+}
+
+BETTER_SMS_FOR_CALLBACK void reportSpcBuiltinProfile(TApplication *app) {
+    for (size_t i = 0; i < BuiltinProfileSlots && i < sBuiltinDatas.size(); ++i) {
+        BuiltinProfile &profile = sBuiltinProfiles[i];
+        if (profile.mCalls == 0)
+            continue;
+
+        Console::record(Console::LEVEL_DEBUG, Console::CATEGORY_SUNSCRIPT,
+                        "%s: %lu calls, %luus total, %luus max\n", sBuiltinDatas[i].mKey,
+                        profile.mCalls, static_cast<u32>(OSTicksToMicroseconds(profile.mTicks)),
+                        static_cast<u32>(OSTicksToMicroseconds(profile.mMaxTicks)));
+        profile = {0, 0, 0};
+    }
+}
+
+#else
+
+SpcBuiltinStats getHottestSpcBuiltin() { return {nullptr, 0, 0}; }
+
+BETTER_SMS_FOR_CALLBACK void reportSpcBuiltinProfile(TApplication *app) {}
 
-    for (const BuiltinData &data : sBuiltinDataBSMS) {
-        BIND_SYMBOL(spcBinary, data.mKey, data.mFn);
+#endif
+
+#pragma endregion
+
+static void bindBuiltin(TSpcBinary *spcBinary, size_t index) {
+    const BuiltinData &data = sBuiltinDatas[index];
+
+    Spc::SpcFunction function = data.mFn;
+#if SMS_DEBUG
+    if (index < BuiltinProfileSlots)
+        function = sProfileThunks[index];
+#endif
+
+    spcBinary->bindSystemDataToSymbol(data.mKey, reinterpret_cast<u32>(function));
+}
+
+// Scripts are stage or common archive resources, 0 when neither holds it
+static u32 getSpcBinarySize(const void *binary) {
+    static const char *sVolumes[] = {"scene", "common"};
+
+    for (const char *volume : sVolumes) {
+        JKRArchive *archive = JKRFileLoader::getVolume(volume);
+        if (!archive)
+            continue;
+
+        const u32 size = archive->getResSize(binary);
+        if (size != 0xFFFFFFFF)
+            return size;
     }
+    return 0;
+}
 
-    for (const BuiltinData &data : sBuiltinDatas) {
-        BIND_SYMBOL(spcBinary, data.mKey, data.mFn);
+static bool isNameTerminated(const char *name, u32 maxLength) {
+    for (u32 i = 0; i < maxLength; ++i) {
+        if (name[i] == '\0')
+            return true;
     }
+    return false;
 }
-SMS_PATCH_BL(SMS_PORT_REGION(0x80222584, 0, 0, 0), initModuleFunctions);
 
-#undef BIND_SYMBOL
+static bool bindFromSymbolTable(TSpcBinary *spcBinary) {
+    const u8 *binary = reinterpret_cast<const u8 *>(spcBinary->getHeader());
+    if (!binary)
+        return false;
+
+    const u32 binarySize = getSpcBinarySize(binary);
+    if (binarySize < SpcHeaderSize || *reinterpret_cast<const u32 *>(binary) != SpcMagic)
+        return false;
+
+    const u32 symbolOffset = *reinterpret_cast<const u32 *>(binary + SpcSymbolOffset);
+    const u32 symbolCount  = *reinterpret_cast<const u32 *>(binary + SpcSymbolCount);
+
+    // Ordered so none of the offset math can wrap
+    if (symbolOffset < SpcHeaderSize || symbolOffset > binarySize || (symbolOffset & 3) != 0)
+        return false;
+    if (symbolCount > (binarySize - symbolOffset) / SpcSymbolSize)
+        return false;
+
+    const u32 namesOffset = symbolOffset + symbolCount * SpcSymbolSize;
+    const u32 namesSize   = binarySize - namesOffset;
+
+    const u8 *symbols = binary + symbolOffset;
+    const char *names = reinterpret_cast<const char *>(binary + namesOffset);
+
+    u32 boundCount = 0;
+    for (u32 i = 0; i < symbolCount; ++i) {
+        const u32 nameOffset =
+            *reinterpret_cast<const u32 *>(symbols + i * SpcSymbolSize + SpcSymbolNameOfs);
+        if (nameOffset >= namesSize)
+            continue;
+
+        const char *name = names + nameOffset;
+        if (!isNameTerminated(name, namesSize - nameOffset))
+            continue;
+
+        const s32 index = findBuiltin(name, hashSymbol(name));
+        if (index >= 0) {
+            bindBuiltin(spcBinary, index);
+            boundCount += 1;
+        }
+    }
+
+    // A table that resolves to nothing is as likely a layout mismatch as a
+    // script without builtins, binding by name is right either way
+    return boundCount > 0;
+}
+
+static void initModuleFunctions(TSpcBinary *spcBinary) {
+    spcBinary->initUserBuiltin();
+    internCoreBuiltins();
+
+#if SMS_DEBUG
+    if (!sProfileThunks[0])
+        fillProfileThunks<BuiltinProfileSlots - 1>();
+#endif
+
+    if (bindFromSymbolTable(spcBinary))
+        return;
+
+    for (size_t i = 0; i < sBuiltinDatas.size(); ++i) {
+        bindBuiltin(spcBinary, i);
+    }
+}
+SMS_PATCH_BL(SMS_PORT_REGION(0x80222584, 0, 0, 0), initModuleFunctions);
@@ -1,15 +1,22 @@
 #include "time.hxx"
 #include "memory.hxx"
 #include <Dolphin/types.h>
+#include <SMS/System/Application.hxx>
 #include <SMS/macros.h>
 
 #include "module.hxx"
 
 static OSCalendarTime sCalendar;
 
+static f64 sFrameSeconds   = 0.0;
+static f32 sFrameDelta     = 0.0f;
+static bool sIsFrameTicked = false;
+
 BETTER_SMS_FOR_EXPORT const char *BetterSMS::Time::buildDate() { return __DATE__; }
 BETTER_SMS_FOR_EXPORT const char *BetterSMS::Time::buildTime() { return __TIME__; }
 BETTER_SMS_FOR_EXPORT OSTime BetterSMS::Time::ostime() { return OSGetTime(); }
+BETTER_SMS_FOR_EXPORT f64 BetterSMS::Time::frameSeconds() { return sFrameSeconds; }
+BETTER_SMS_FOR_EXPORT f32 BetterSMS::Time::frameDelta() { return sFrameDelta; }
 
 BETTER_SMS_FOR_EXPORT void BetterSMS::Time::getCalendar(OSCalendarTime &result) {
     return OSTicksToCalendarTime(ostime(), &result);
@@ -30,4 +37,22 @@ BETTER_SMS_FOR_EXPORT void BetterSMS::Time::calendarToTime(char *dst,
         snprintf(dst, 32, "%lu:%02lu PM", calendar.hour, calendar.min);
     else
         snprintf(dst, 32, "%lu:%02lu PM", (calendar.hour + 1) % 13, calendar.min);
-}
\ No newline at end of file
+}
+
+static void tickFrameClock() {
+    const f64 seconds = OSTicksToSeconds(f64(ostime()));
+    sFrameDelta       = sFrameSeconds == 0.0 ? 0.0f : seconds - sFrameSeconds;
+    sFrameSeconds     = seconds;
+}
+
+BETTER_SMS_FOR_CALLBACK void updateFrameClock(TApplication *app) {
+    tickFrameClock();
+    sIsFrameTicked = true;
+}
+
+// Loading screens are drawn without the game loop running, keep the clock moving there
+void syncFrameClockForDraw() {
+    if (!sIsFrameTicked)
+        tickFrameClock();
+    sIsFrameTicked = false;
+}
@@ -0,0 +1,472 @@
+// ColGridBaker - Bakes the static collision grid of a stage .col file
+//
+// Usage: colgridbaker <map.col> <map.colgrid> <areaSizeX> <areaSizeZ>
+//        colgridbaker --verify <map.colgrid> <runtime.colgrid>
+// Build: c++ -std=c++17 -O2 colgridbaker.cpp -o colgridbaker
+//
+// The output is placed next to the .col in the stage archive. At stage load
+// the engine links it straight into the static grid instead of inserting
+// every triangle; if the .col or grid dimensions change it falls back to the
+// runtime build. The layout below must match src/patches/collision/p_baked.hxx
+//
+// CellSize and CellPadding are the values addCheckDataToGridAll in
+// src/patches/collision/update.cpp passes to polygonIsInGrid. The cell range
+// (getGridArea) and plane classification are game code; WallPadding and
+// PlaneNormalLimit stand in for them, so a bake is only known to match once
+// --verify passes against the grid a debug build exports after building the
+// stage at runtime. That export is itself a valid map.colgrid.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+constexpr uint32_t BakedGridMagic   = 0x42475244;  // 'BGRD'
+constexpr uint32_t BakedGridVersion = 1;
+constexpr uint32_t BakedGridNone    = 0xFFFFFFFF;
+
+constexpr float CellSize         = 1024.0f;
+constexpr float CellPadding      = 80.0f;
+constexpr float WallPadding      = 100.0f;
+constexpr float PlaneNormalLimit = 0.2f;
+
+constexpr uint32_t HeaderSize   = 0x30;
+constexpr uint32_t GroupSize    = 0x18;
+constexpr uint32_t MaxTriangles = 0x100000;
+
+enum PlaneType : uint8_t { GROUND, ROOF, WALL };
+
+struct Vec3 {
+    float x, y, z;
+};
+
+struct Triangle {
+    Vec3 mVertices[3];
+    float mMinHeight;
+    float mMaxHeight;
+    PlaneType mType;
+};
+
+struct Node {
+    uint32_t mNext;
+    uint32_t mTriangle;
+};
+
+static uint16_t readU16(const uint8_t *p) { return uint16_t((p[0] << 8) | p[1]); }
+
+static uint32_t readU32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+static float readF32(const uint8_t *p) {
+    uint32_t bits = readU32(p);
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+static void writeU16(std::vector<uint8_t> &out, uint16_t value) {
+    out.push_back(uint8_t(value >> 8));
+    out.push_back(uint8_t(value));
+}
+
+static void writeU32(std::vector<uint8_t> &out, uint32_t value) {
+    out.push_back(uint8_t(value >> 24));
+    out.push_back(uint8_t(value >> 16));
+    out.push_back(uint8_t(value >> 8));
+    out.push_back(uint8_t(value));
+}
+
+static void writeF32(std::vector<uint8_t> &out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    writeU32(out, bits);
+}
+
+static uint32_t hashBytes(uint32_t hash, const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Hashes the parts of the .col the grid is derived from; must match the loader
+static uint32_t hashCollision(const uint8_t *col) {
+    const uint32_t vertexCount  = readU32(col + 0x0);
+    const uint32_t vertexOffset = readU32(col + 0x4);
+    const uint32_t groupCount   = readU32(col + 0x8);
+    const uint32_t groupOffset  = readU32(col + 0xC);
+
+    uint32_t hash = 2166136261u;
+    hash          = hashBytes(hash, col, 0x10);
+    hash          = hashBytes(hash, col + vertexOffset, vertexCount * 12);
+    hash          = hashBytes(hash, col + groupOffset, groupCount * 0x18);
+
+    for (uint32_t i = 0; i < groupCount; ++i) {
+        const uint8_t *group = col + groupOffset + (i * 0x18);
+        hash = hashBytes(hash, col + readU32(group + 0x8), readU16(group + 0x2) * 6);
+    }
+
+    return hash;
+}
+
+static PlaneType getPlaneType(const Vec3 &a, const Vec3 &b, const Vec3 &c) {
+    const float nx = (b.y - a.y) * (c.z - b.z) - (b.z - a.z) * (c.y - b.y);
+    const float ny = (b.z - a.z) * (c.x - b.x) - (b.x - a.x) * (c.z - b.z);
+    const float nz = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+
+    const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    const float normalY = length > 0.0f ? ny / length : 0.0f;
+
+    if (normalY > PlaneNormalLimit)
+        return GROUND;
+    if (normalY < -PlaneNormalLimit)
+        return ROOF;
+    return WALL;
+}
+
+// Insertion search mirroring addGroundNode_, addRoofNode_ and addWallNode_ in
+// src/patches/collision/update.cpp
+static bool isInsertPoint(const Triangle &col, const Triangle &data) {
+    switch (data.mType) {
+    case GROUND:
+        return col.mMinHeight < data.mMinHeight || col.mMinHeight == data.mMinHeight ||
+               col.mMaxHeight < data.mMaxHeight;
+    case ROOF:
+        return data.mMaxHeight < col.mMaxHeight || col.mMaxHeight == data.mMaxHeight ||
+               data.mMinHeight < col.mMinHeight;
+    case WALL:
+    default:
+        return col.mMaxHeight < data.mMaxHeight || col.mMaxHeight == data.mMaxHeight ||
+               col.mMinHeight < data.mMinHeight;
+    }
+}
+
+static bool readFile(const char *path, std::vector<uint8_t> &out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return false;
+    }
+    out.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool isInFile(const std::vector<uint8_t> &file, uint64_t offset, uint64_t size) {
+    return offset <= file.size() && size <= file.size() - offset;
+}
+
+// Rejects anything that would read outside the file before a single triangle is built
+static bool checkCollision(const std::vector<uint8_t> &col) {
+    if (col.size() < 0x10) {
+        fprintf(stderr, "Collision file is too small for a header\n");
+        return false;
+    }
+
+    const uint32_t vertexCount  = readU32(&col[0x0]);
+    const uint32_t vertexOffset = readU32(&col[0x4]);
+    const uint32_t groupCount   = readU32(&col[0x8]);
+    const uint32_t groupOffset  = readU32(&col[0xC]);
+
+    if (!isInFile(col, vertexOffset, uint64_t(vertexCount) * 12)) {
+        fprintf(stderr, "Vertex table (%u vertices at 0x%X) runs past the file\n", vertexCount,
+                vertexOffset);
+        return false;
+    }
+
+    if (!isInFile(col, groupOffset, uint64_t(groupCount) * GroupSize)) {
+        fprintf(stderr, "Group table (%u groups at 0x%X) runs past the file\n", groupCount,
+                groupOffset);
+        return false;
+    }
+
+    uint64_t triangleCount = 0;
+    for (uint32_t i = 0; i < groupCount; ++i) {
+        const uint8_t *group     = &col[groupOffset + (i * GroupSize)];
+        const uint16_t count     = readU16(group + 0x2);
+        const uint32_t idxOffset = readU32(group + 0x8);
+
+        if (!isInFile(col, idxOffset, uint64_t(count) * 6)) {
+            fprintf(stderr, "Group %u indices (%u triangles at 0x%X) run past the file\n", i,
+                    count, idxOffset);
+            return false;
+        }
+
+        for (uint32_t v = 0; v < uint32_t(count) * 3; ++v) {
+            if (readU16(&col[idxOffset + (v * 2)]) >= vertexCount) {
+                fprintf(stderr, "Group %u triangle %u uses a vertex past %u\n", i, v / 3,
+                        vertexCount);
+                return false;
+            }
+        }
+
+        triangleCount += count;
+    }
+
+    if (triangleCount > MaxTriangles) {
+        fprintf(stderr, "%llu triangles is more than a stage can hold\n",
+                (unsigned long long)triangleCount);
+        return false;
+    }
+
+    return true;
+}
+
+struct Grid {
+    uint32_t mColHash;
+    uint32_t mTriangleCount;
+    uint16_t mBlockXCount, mBlockZCount;
+    float mAreaSizeX, mAreaSizeZ;
+    const uint8_t *mTypes;
+    std::vector<std::vector<uint32_t>> mLists;  // Triangle indices per cell and slot
+};
+
+static bool parseGrid(const char *path, const std::vector<uint8_t> &file, Grid &grid) {
+    if (file.size() < HeaderSize || readU32(&file[0x0]) != BakedGridMagic ||
+        readU32(&file[0x4]) != BakedGridVersion) {
+        fprintf(stderr, "%s is not a version %u colgrid\n", path, BakedGridVersion);
+        return false;
+    }
+
+    grid.mColHash       = readU32(&file[0x8]);
+    grid.mTriangleCount = readU32(&file[0xC]);
+    grid.mBlockXCount   = readU16(&file[0x10]);
+    grid.mBlockZCount   = readU16(&file[0x12]);
+    grid.mAreaSizeX     = readF32(&file[0x14]);
+    grid.mAreaSizeZ     = readF32(&file[0x18]);
+
+    const uint32_t nodeCount  = readU32(&file[0x1C]);
+    const uint32_t typeOffset = readU32(&file[0x20]);
+    const uint32_t rootOffset = readU32(&file[0x24]);
+    const uint32_t nodeOffset = readU32(&file[0x28]);
+    const uint64_t cellCount  = uint64_t(grid.mBlockXCount) * grid.mBlockZCount;
+
+    if (!isInFile(file, typeOffset, grid.mTriangleCount) ||
+        !isInFile(file, rootOffset, cellCount * 12) ||
+        !isInFile(file, nodeOffset, uint64_t(nodeCount) * 8)) {
+        fprintf(stderr, "%s has tables past the end of the file\n", path);
+        return false;
+    }
+
+    grid.mTypes = &file[typeOffset];
+    grid.mLists.assign(cellCount * 3, {});
+    for (uint64_t list = 0; list < cellCount * 3; ++list) {
+        uint32_t node = readU32(&file[rootOffset + (list * 4)]);
+        // A list can't be longer than the node table without looping
+        for (uint32_t steps = 0; node != BakedGridNone; ++steps) {
+            if (node >= nodeCount || steps >= nodeCount) {
+                fprintf(stderr, "%s has a broken list in cell %llu\n", path,
+                        (unsigned long long)(list / 3));
+                return false;
+            }
+            grid.mLists[list].push_back(readU32(&file[nodeOffset + (node * 8) + 4]));
+            node = readU32(&file[nodeOffset + (node * 8)]);
+        }
+    }
+
+    return true;
+}
+
+// Compares a bake against a runtime export list by list
+static int verifyGrids(const char *bakedPath, const char *runtimePath) {
+    std::vector<uint8_t> bakedFile, runtimeFile;
+    if (!readFile(bakedPath, bakedFile) || !readFile(runtimePath, runtimeFile))
+        return 1;
+
+    Grid baked, runtime;
+    if (!parseGrid(bakedPath, bakedFile, baked) || !parseGrid(runtimePath, runtimeFile, runtime))
+        return 1;
+
+    if (baked.mColHash != runtime.mColHash || baked.mTriangleCount != runtime.mTriangleCount ||
+        baked.mBlockXCount != runtime.mBlockXCount || baked.mBlockZCount != runtime.mBlockZCount ||
+        baked.mAreaSizeX != runtime.mAreaSizeX || baked.mAreaSizeZ != runtime.mAreaSizeZ) {
+        fprintf(stderr, "Grids were built from different collision or grid dimensions\n");
+        return 1;
+    }
+
+    size_t mismatches = 0;
+    for (uint32_t i = 0; i < baked.mTriangleCount; ++i) {
+        if (baked.mTypes[i] != runtime.mTypes[i] && mismatches++ < 10)
+            fprintf(stderr, "Triangle %u is plane type %u baked, %u at runtime\n", i,
+                    baked.mTypes[i], runtime.mTypes[i]);
+    }
+
+    static const char *slotNames[] = {"ground", "roof", "wall"};
+    for (size_t list = 0; list < baked.mLists.size(); ++list) {
+        if (baked.mLists[list] != runtime.mLists[list] && mismatches++ < 10)
+            fprintf(stderr, "Cell %zu %s list differs (%zu baked, %zu at runtime)\n", list / 3,
+                    slotNames[list % 3], baked.mLists[list].size(), runtime.mLists[list].size());
+    }
+
+    if (mismatches > 0) {
+        fprintf(stderr, "%zu differences, ship the runtime export instead\n", mismatches);
+        return 1;
+    }
+
+    printf("Grids match (%u triangles, %ux%u cells)\n", baked.mTriangleCount, baked.mBlockXCount,
+           baked.mBlockZCount);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "--verify") == 0)
+        return verifyGrids(argv[2], argv[3]);
+
+    if (argc != 5) {
+        fprintf(stderr,
+                "Usage: %s <map.col> <map.colgrid> <areaSizeX> <areaSizeZ>\n"
+                "       %s --verify <map.colgrid> <runtime.colgrid>\n",
+                argv[0], argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> col;
+    if (!readFile(argv[1], col) || !checkCollision(col))
+        return 1;
+
+    const float areaSizeX = strtof(argv[3], nullptr);
+    const float areaSizeZ = strtof(argv[4], nullptr);
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const uint32_t vertexCount  = readU32(&col[0x0]);
+    const uint32_t vertexOffset = readU32(&col[0x4]);
+    const uint32_t groupCount   = readU32(&col[0x8]);
+    const uint32_t groupOffset  = readU32(&col[0xC]);
+
+    std::vector<Vec3> vertices(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        const uint8_t *v = &col[vertexOffset + (i * 12)];
+        vertices[i]      = {readF32(v), readF32(v + 4), readF32(v + 8)};
+    }
+
+    std::vector<Triangle> triangles;
+    for (uint32_t i = 0; i < groupCount; ++i) {
+        const uint8_t *group   = &col[groupOffset + (i * GroupSize)];
+        const uint16_t count   = readU16(group + 0x2);
+        const uint8_t *indices = &col[readU32(group + 0x8)];
+
+        for (uint16_t t = 0; t < count; ++t) {
+            Triangle tri;
+            for (int v = 0; v < 3; ++v) {
+                tri.mVertices[v] = vertices[readU16(indices + (t * 6) + (v * 2))];
+            }
+            tri.mMinHeight = std::min({tri.mVertices[0].y, tri.mVertices[1].y, tri.mVertices[2].y});
+            tri.mMaxHeight = std::max({tri.mVertices[0].y, tri.mVertices[1].y, tri.mVertices[2].y});
+            tri.mType      = getPlaneType(tri.mVertices[0], tri.mVertices[1], tri.mVertices[2]);
+            triangles.push_back(tri);
+        }
+    }
+
+    const int blockXCount = int((areaSizeX * 2.0f) / CellSize);
+    const int blockZCount = int((areaSizeZ * 2.0f) / CellSize);
+    if (!(areaSizeX > 0.0f) || !(areaSizeZ > 0.0f) || blockXCount <= 0 || blockZCount <= 0 ||
+        blockXCount > 0xFFFF || blockZCount > 0xFFFF) {
+        fprintf(stderr, "Area size %g x %g does not make a usable grid\n", areaSizeX, areaSizeZ);
+        return 1;
+    }
+
+    std::vector<uint32_t> roots(size_t(blockXCount) * blockZCount * 3, BakedGridNone);
+    std::vector<Node> nodes;
+
+    for (uint32_t i = 0; i < triangles.size(); ++i) {
+        const Triangle &tri = triangles[i];
+        const float padding = tri.mType == WALL ? WallPadding : 0.0f;
+
+        float minX = tri.mVertices[0].x, maxX = tri.mVertices[0].x;
+        float minZ = tri.mVertices[0].z, maxZ = tri.mVertices[0].z;
+        for (int v = 1; v < 3; ++v) {
+            minX = std::min(minX, tri.mVertices[v].x);
+            maxX = std::max(maxX, tri.mVertices[v].x);
+            minZ = std::min(minZ, tri.mVertices[v].z);
+            maxZ = std::max(maxZ, tri.mVertices[v].z);
+        }
+
+        const int cellMinX = std::max(0, int((minX - padding + areaSizeX) / CellSize));
+        const int cellMaxX =
+            std::min(blockXCount - 1, int((maxX + padding + areaSizeX) / CellSize));
+        const int cellMinZ = std::max(0, int((minZ - padding + areaSizeZ) / CellSize));
+        const int cellMaxZ =
+            std::min(blockZCount - 1, int((maxZ + padding + areaSizeZ) / CellSize));
+
+        for (int cellz = cellMinZ; cellz <= cellMaxZ; ++cellz) {
+            const float baseZ = cellz * CellSize - areaSizeZ;
+            if (maxZ < baseZ || minZ > baseZ + CellSize + CellPadding)
+                continue;
+
+            for (int cellx = cellMinX; cellx <= cellMaxX; ++cellx) {
+                const float baseX = cellx * CellSize - areaSizeX;
+                if (maxX < baseX || minX > baseX + CellSize + CellPadding)
+                    continue;
+
+                uint32_t *link =
+                    &roots[((cellx + (cellz * size_t(blockXCount))) * 3) + tri.mType];
+
+                // Walk to the node addCheckDataToGridAll would link after
+                uint32_t *insert = link;
+                while (*insert != BakedGridNone) {
+                    const uint32_t current = *insert;
+                    insert                 = &nodes[current].mNext;
+                    if (isInsertPoint(triangles[nodes[current].mTriangle], tri))
+                        break;
+                }
+
+                nodes.push_back({*insert, i});
+                *insert = uint32_t(nodes.size() - 1);
+            }
+        }
+    }
+
+    // Header, then per triangle plane types, then cell roots, then nodes
+    std::vector<uint8_t> out;
+    const uint32_t typeOffset = 0x30;
+    const uint32_t rootOffset = (typeOffset + uint32_t(triangles.size()) + 3) & ~3;
+    const uint32_t nodeOffset = rootOffset + uint32_t(roots.size()) * 4;
+
+    writeU32(out, BakedGridMagic);
+    writeU32(out, BakedGridVersion);
+    writeU32(out, hashCollision(col.data()));
+    writeU32(out, uint32_t(triangles.size()));
+    writeU16(out, uint16_t(blockXCount));
+    writeU16(out, uint16_t(blockZCount));
+    writeF32(out, areaSizeX);
+    writeF32(out, areaSizeZ);
+    writeU32(out, uint32_t(nodes.size()));
+    writeU32(out, typeOffset);
+    writeU32(out, rootOffset);
+    writeU32(out, nodeOffset);
+    writeU32(out, 0);
+
+    for (const Triangle &tri : triangles)
+        out.push_back(tri.mType);
+    out.resize(rootOffset, 0);
+
+    for (uint32_t root : roots)
+        writeU32(out, root);
+
+    for (const Node &node : nodes) {
+        writeU32(out, node.mNext);
+        writeU32(out, node.mTriangle);
+    }
+
+    const auto endTime = std::chrono::steady_clock::now();
+
+    std::ofstream outFile(argv[2], std::ios::binary);
+    if (!outFile) {
+        fprintf(stderr, "Failed to write %s\n", argv[2]);
+        return 1;
+    }
+    outFile.write(reinterpret_cast<const char *>(out.data()), out.size());
+
+    printf("%zu triangles, %zu nodes, %dx%d cells, %zu bytes (%.2f ms)\n", triangles.size(),
+           nodes.size(), blockXCount, blockZCount, out.size(),
+           std::chrono::duration<double, std::milli>(endTime - startTime).count());
+    return 0;
+}
@@ -0,0 +1,478 @@
+// FifoAnalyzer - Decodes a GP FIFO capture taken by the engine's debug build
+//
+// Usage: fifoanalyzer <dump.bin> [--commands]
+// Build: c++ -std=c++17 -O2 fifoanalyzer.cpp -o fifoanalyzer
+//
+// Hold Z and press Y with debug mode on (outside of the XYZ and camera modes)
+// to capture the next frame. The log reports the address and size of the
+// capture; dump that range, or all of MEM1, from the emulator's memory view.
+// The capture is located by its header, so any dump containing it works.
+// The layout below must match src/p_gptrace.hxx
+//
+// Each capture record is the exact command stream one engine render feature
+// wrote to the CPU FIFO, padded by NOPs from the flushes around it. Records
+// are decoded one at a time; state written by the game in between is not in
+// the capture, so redundant loads are only counted within a record.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+constexpr uint32_t GPCaptureMagic   = 0x47505452;  // 'GPTR'
+constexpr uint32_t GPCaptureVersion = 1;
+constexpr size_t GPZoneNameSize     = 16;
+constexpr size_t GPHeaderFixedSize  = 24;
+constexpr size_t GPRecordSize       = 8;
+
+enum Opcode : uint8_t {
+    OP_NOP             = 0x00,
+    OP_LOAD_CP_REG     = 0x08,
+    OP_LOAD_XF_REG     = 0x10,
+    OP_LOAD_INDX_A     = 0x20,
+    OP_LOAD_INDX_B     = 0x28,
+    OP_LOAD_INDX_C     = 0x30,
+    OP_LOAD_INDX_D     = 0x38,
+    OP_CALL_DL         = 0x40,
+    OP_UNKNOWN_METRICS = 0x44,
+    OP_INVALIDATE_VTX  = 0x48,
+    OP_LOAD_BP_REG     = 0x61,
+    OP_DRAW_FIRST      = 0x80,
+};
+
+struct ZoneStats {
+    std::string mName;
+    uint32_t mRecords      = 0;
+    uint32_t mBytes        = 0;
+    uint32_t mPaddingBytes = 0;
+    uint32_t mBPWrites     = 0;
+    uint32_t mCPWrites     = 0;
+    uint32_t mXFWrites     = 0;  // Commands
+    uint32_t mXFWords      = 0;  // Register words carried
+    uint32_t mRedundantBP  = 0;
+    uint32_t mRedundantCP  = 0;
+    uint32_t mRedundantXF  = 0;
+    uint32_t mMatrixLoads  = 0;  // Direct XF matrix memory writes and indexed loads
+    uint32_t mMatrixBytes  = 0;
+    uint32_t mDLCalls      = 0;
+    uint32_t mDraws        = 0;
+    uint32_t mVertices     = 0;
+    uint32_t mVertexBytes  = 0;
+    uint32_t mStateBytes   = 0;  // BP, CP and XF register traffic
+    uint32_t mUndecoded    = 0;  // Bytes skipped after an unknown command
+};
+
+// CP and XF state the vertex size depends on, persists across records
+struct VertexState {
+    uint32_t mVCDLo;
+    uint32_t mVCDHi;
+    uint32_t mVATA[8];
+    uint32_t mVATB[8];
+    uint32_t mVATC[8];
+    bool mIsVCDKnown;
+    bool mIsVATKnown[8];
+};
+
+// Register shadows for the redundancy count, reset for every record
+struct Shadow {
+    uint32_t mBP[256];
+    bool mIsBPValid[256];
+    uint32_t mCP[256];
+    bool mIsCPValid[256];
+    std::vector<uint32_t> mXF;
+    std::vector<bool> mIsXFValid;
+
+    void reset() {
+        memset(mIsBPValid, 0, sizeof(mIsBPValid));
+        memset(mIsCPValid, 0, sizeof(mIsCPValid));
+        mXF.assign(0x1100, 0);
+        mIsXFValid.assign(0x1100, false);
+    }
+};
+
+static uint16_t readU16(const uint8_t *p) { return uint16_t((p[0] << 8) | p[1]); }
+
+static uint32_t readU32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+// BP registers that trigger an action rather than hold state
+static bool isBPCommand(uint8_t reg) {
+    switch (reg) {
+    case 0x45:  // Draw done
+    case 0x47:  // Token
+    case 0x48:  // Token interrupt
+    case 0x52:  // Copy execute
+    case 0x64:  // TLUT load
+    case 0x65:
+    case 0x66:  // Texture invalidate
+    case 0x67:  // Perf metric
+    case 0xFE:  // Write mask, handled separately
+        return true;
+    default:
+        return false;
+    }
+}
+
+static uint32_t componentSize(uint32_t format) {
+    switch (format) {
+    case 0:
+    case 1:
+        return 1;
+    case 2:
+    case 3:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+static uint32_t colorSize(uint32_t format) {
+    static const uint32_t sizes[8] = {2, 3, 4, 2, 3, 4, 4, 4};
+    return sizes[format & 7];
+}
+
+static uint32_t indexSize(uint32_t type) { return type == 2 ? 1 : 2; }
+
+// Returns 0 if the vertex layout has not been seen in the capture yet
+static uint32_t vertexSize(const VertexState &state, uint32_t vat) {
+    if (!state.mIsVCDKnown || !state.mIsVATKnown[vat])
+        return 0;
+
+    const uint32_t lo = state.mVCDLo;
+    const uint32_t hi = state.mVCDHi;
+    const uint32_t a  = state.mVATA[vat];
+    const uint32_t b  = state.mVATB[vat];
+    const uint32_t c  = state.mVATC[vat];
+
+    uint32_t size = 0;
+
+    // Matrix indices
+    for (uint32_t i = 0; i < 9; ++i) {
+        size += (lo >> i) & 1;
+    }
+
+    const uint32_t pos = (lo >> 9) & 3;
+    if (pos == 1)
+        size += componentSize((a >> 1) & 7) * ((a & 1) ? 3 : 2);
+    else if (pos > 1)
+        size += indexSize(pos);
+
+    const uint32_t nrm = (lo >> 11) & 3;
+    const bool isNBT   = (a >> 9) & 1;
+    if (nrm == 1)
+        size += componentSize((a >> 10) & 7) * (isNBT ? 9 : 3);
+    else if (nrm > 1)
+        size += indexSize(nrm) * ((isNBT && ((a >> 31) & 1)) ? 3 : 1);
+
+    const uint32_t colFormats[2] = {(a >> 14) & 7, (a >> 18) & 7};
+    for (uint32_t i = 0; i < 2; ++i) {
+        const uint32_t col = (lo >> (13 + i * 2)) & 3;
+        if (col == 1)
+            size += colorSize(colFormats[i]);
+        else if (col > 1)
+            size += indexSize(col);
+    }
+
+    // Count and format bit positions for TEX0 through TEX7
+    const uint32_t texFields[8][2] = {
+        {a >> 21, a >> 22}, {b >> 0, b >> 1},   {b >> 9, b >> 10},  {b >> 18, b >> 19},
+        {b >> 27, b >> 28}, {c >> 5, c >> 6},   {c >> 14, c >> 15}, {c >> 23, c >> 24},
+    };
+    for (uint32_t i = 0; i < 8; ++i) {
+        const uint32_t tex = (hi >> (i * 2)) & 3;
+        if (tex == 1)
+            size += componentSize(texFields[i][1] & 7) * ((texFields[i][0] & 1) ? 2 : 1);
+        else if (tex > 1)
+            size += indexSize(tex);
+    }
+
+    return size;
+}
+
+static void trackCP(VertexState &state, uint8_t reg, uint32_t value) {
+    if (reg == 0x50) {
+        state.mVCDLo      = value;
+        state.mIsVCDKnown = true;
+    } else if (reg == 0x60) {
+        state.mVCDHi = value;
+    } else if ((reg & 0xF8) == 0x70) {
+        state.mVATA[reg & 7]       = value;
+        state.mIsVATKnown[reg & 7] = true;
+    } else if ((reg & 0xF8) == 0x80) {
+        state.mVATB[reg & 7] = value;
+    } else if ((reg & 0xF8) == 0x90) {
+        state.mVATC[reg & 7] = value;
+    }
+}
+
+static void decodeRecord(const uint8_t *data, uint32_t size, ZoneStats &stats, VertexState &vtx,
+                         Shadow &shadow, bool printCommands) {
+    shadow.reset();
+    uint32_t bpMask = 0xFFFFFF;
+
+    uint32_t pos = 0;
+    while (pos < size) {
+        const uint8_t op    = data[pos];
+        const uint32_t left = size - pos;
+        uint32_t length     = 0;
+
+        if (op == OP_NOP) {
+            stats.mPaddingBytes += 1;
+            pos += 1;
+            continue;
+        }
+
+        if (op == OP_LOAD_BP_REG && left >= 5) {
+            length             = 5;
+            const uint32_t raw = readU32(data + pos + 1);
+            const uint8_t reg  = raw >> 24;
+            uint32_t value     = raw & 0xFFFFFF;
+
+            stats.mBPWrites += 1;
+            stats.mStateBytes += length;
+
+            if (reg == 0xFE) {
+                bpMask = value;
+            } else {
+                if (shadow.mIsBPValid[reg])
+                    value = (shadow.mBP[reg] & ~bpMask) | (value & bpMask);
+                if (!isBPCommand(reg)) {
+                    if (shadow.mIsBPValid[reg] && shadow.mBP[reg] == value)
+                        stats.mRedundantBP += 1;
+                    shadow.mBP[reg]        = value;
+                    shadow.mIsBPValid[reg] = true;
+                }
+                bpMask = 0xFFFFFF;
+            }
+
+            if (printCommands)
+                printf("    BP  %02X = %06X\n", reg, raw & 0xFFFFFF);
+        } else if (op == OP_LOAD_CP_REG && left >= 6) {
+            length               = 6;
+            const uint8_t reg    = data[pos + 1];
+            const uint32_t value = readU32(data + pos + 2);
+
+            stats.mCPWrites += 1;
+            stats.mStateBytes += length;
+            if (shadow.mIsCPValid[reg] && shadow.mCP[reg] == value)
+                stats.mRedundantCP += 1;
+            shadow.mCP[reg]        = value;
+            shadow.mIsCPValid[reg] = true;
+            trackCP(vtx, reg, value);
+
+            if (printCommands)
+                printf("    CP  %02X = %08X\n", reg, value);
+        } else if (op == OP_LOAD_XF_REG && left >= 5) {
+            const uint32_t header = readU32(data + pos + 1);
+            const uint32_t count  = ((header >> 16) & 0xF) + 1;
+            const uint32_t addr   = header & 0xFFFF;
+            length                = 5 + count * 4;
+            if (left < length)
+                break;
+
+            stats.mXFWrites += 1;
+            stats.mXFWords += count;
+
+            // Matrix memory below 0x600, registers from 0x1000
+            if (addr < 0x600) {
+                stats.mMatrixLoads += 1;
+                stats.mMatrixBytes += length;
+            } else {
+                stats.mStateBytes += length;
+            }
+
+            bool isRedundant = true;
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint32_t reg   = addr + i;
+                const uint32_t value = readU32(data + pos + 5 + i * 4);
+                if (reg >= shadow.mXF.size() || !shadow.mIsXFValid[reg] || shadow.mXF[reg] != value)
+                    isRedundant = false;
+                if (reg < shadow.mXF.size()) {
+                    shadow.mXF[reg]        = value;
+                    shadow.mIsXFValid[reg] = true;
+                }
+            }
+            if (isRedundant)
+                stats.mRedundantXF += 1;
+
+            if (printCommands)
+                printf("    XF  %04X x%u\n", addr, count);
+        } else if ((op == OP_LOAD_INDX_A || op == OP_LOAD_INDX_B || op == OP_LOAD_INDX_C ||
+                    op == OP_LOAD_INDX_D) &&
+                   left >= 5) {
+            length = 5;
+            stats.mMatrixLoads += 1;
+            stats.mMatrixBytes += length;
+
+            if (printCommands)
+                printf("    IDX %c  %08X\n", 'A' + ((op - OP_LOAD_INDX_A) >> 3),
+                       readU32(data + pos + 1));
+        } else if (op == OP_CALL_DL && left >= 9) {
+            length = 9;
+            stats.mDLCalls += 1;
+
+            if (printCommands)
+                printf("    DL  %08X +%u\n", readU32(data + pos + 1), readU32(data + pos + 5));
+        } else if (op == OP_UNKNOWN_METRICS || op == OP_INVALIDATE_VTX) {
+            length = 1;
+        } else if (op >= OP_DRAW_FIRST && left >= 3) {
+            const uint32_t vat      = op & 7;
+            const uint32_t vertices = readU16(data + pos + 1);
+            const uint32_t stride   = vertexSize(vtx, vat);
+            if (stride == 0) {
+                fprintf(stderr,
+                        "  Draw with an unknown vertex layout (VAT %u), skipping the rest of the "
+                        "record\n",
+                        vat);
+                break;
+            }
+
+            length = 3 + vertices * stride;
+            if (left < length)
+                break;
+
+            stats.mDraws += 1;
+            stats.mVertices += vertices;
+            stats.mVertexBytes += length;
+
+            if (printCommands)
+                printf("    DRAW %02X  %u verts x %u bytes\n", op & 0xF8, vertices, stride);
+        } else {
+            fprintf(stderr, "  Unknown command %02X at +%u, skipping the rest of the record\n", op,
+                    pos);
+            break;
+        }
+
+        pos += length;
+    }
+
+    if (pos < size)
+        stats.mUndecoded += size - pos;
+}
+
+static long findCapture(const std::vector<uint8_t> &file) {
+    for (size_t i = 0; i + GPHeaderFixedSize <= file.size(); i += 4) {
+        if (readU32(&file[i]) == GPCaptureMagic && readU32(&file[i + 4]) == GPCaptureVersion)
+            return long(i);
+    }
+    return -1;
+}
+
+static void printZone(const ZoneStats &z) {
+    printf("%-16s %4u %7u %6u %6u %6u %5u %7u %5u %6u %6u %7u %7u\n", z.mName.c_str(), z.mRecords,
+           z.mBytes, z.mBPWrites, z.mCPWrites, z.mXFWrites,
+           z.mRedundantBP + z.mRedundantCP + z.mRedundantXF, z.mMatrixLoads, z.mDLCalls, z.mDraws,
+           z.mVertices, z.mStateBytes, z.mVertexBytes);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <dump.bin> [--commands]\n", argv[0]);
+        return 1;
+    }
+
+    const bool printCommands = argc > 2 && strcmp(argv[2], "--commands") == 0;
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+
+    const long base = findCapture(file);
+    if (base < 0) {
+        fprintf(stderr, "No version %u capture found in %s\n", GPCaptureVersion, argv[1]);
+        return 1;
+    }
+
+    const uint8_t *header      = &file[base];
+    const uint32_t zoneCount   = readU32(header + 8);
+    const uint32_t recordCount = readU32(header + 12);
+    const uint32_t dataSize    = readU32(header + 16);
+    const uint32_t dropped     = readU32(header + 20);
+    const size_t headerSize    = GPHeaderFixedSize + zoneCount * GPZoneNameSize;
+
+    if (base + headerSize + dataSize > file.size()) {
+        fprintf(stderr, "Capture at 0x%lX is truncated, dump %zu bytes from there\n", base,
+                headerSize + dataSize);
+        return 1;
+    }
+
+    std::vector<ZoneStats> zones(zoneCount);
+    for (uint32_t i = 0; i < zoneCount; ++i) {
+        const char *name = reinterpret_cast<const char *>(header + GPHeaderFixedSize +
+                                                          i * GPZoneNameSize);
+        zones[i].mName.assign(name, strnlen(name, GPZoneNameSize));
+    }
+
+    VertexState vtx = {};
+    Shadow *shadow  = new Shadow();
+
+    const uint8_t *cursor = header + headerSize;
+    const uint8_t *end    = cursor + dataSize;
+    for (uint32_t i = 0; i < recordCount && cursor + GPRecordSize <= end; ++i) {
+        const uint8_t zone  = cursor[0];
+        const uint32_t size = readU32(cursor + 4);
+        cursor += GPRecordSize;
+
+        if (zone >= zoneCount || cursor + size > end) {
+            fprintf(stderr, "Record %u is malformed, stopping\n", i);
+            break;
+        }
+
+        ZoneStats &stats = zones[zone];
+        stats.mRecords += 1;
+        stats.mBytes += size;
+
+        if (printCommands)
+            printf("[%s] %u bytes\n", stats.mName.c_str(), size);
+        decodeRecord(cursor, size, stats, vtx, *shadow, printCommands);
+
+        cursor += (size + 3) & ~3u;
+    }
+    delete shadow;
+
+    printf("Capture at 0x%lX: %u records, %u bytes", base, recordCount, dataSize);
+    if (dropped > 0)
+        printf(", %u bytes dropped (buffer full)", dropped);
+    printf("\n\n");
+
+    printf("%-16s %4s %7s %6s %6s %6s %5s %7s %5s %6s %6s %7s %7s\n", "Zone", "Rec", "Bytes", "BP",
+           "CP", "XF", "Redun", "MtxLoad", "DL", "Draws", "Verts", "StateB", "VertB");
+
+    ZoneStats total;
+    total.mName = "Total";
+    for (const ZoneStats &z : zones) {
+        printZone(z);
+        total.mRecords += z.mRecords;
+        total.mBytes += z.mBytes;
+        total.mBPWrites += z.mBPWrites;
+        total.mCPWrites += z.mCPWrites;
+        total.mXFWrites += z.mXFWrites;
+        total.mRedundantBP += z.mRedundantBP;
+        total.mRedundantCP += z.mRedundantCP;
+        total.mRedundantXF += z.mRedundantXF;
+        total.mMatrixLoads += z.mMatrixLoads;
+        total.mDLCalls += z.mDLCalls;
+        total.mDraws += z.mDraws;
+        total.mVertices += z.mVertices;
+        total.mStateBytes += z.mStateBytes;
+        total.mVertexBytes += z.mVertexBytes;
+        total.mPaddingBytes += z.mPaddingBytes;
+        total.mUndecoded += z.mUndecoded;
+    }
+    printZone(total);
+
+    printf("\nBytes include %u bytes of flush padding", total.mPaddingBytes);
+    if (total.mUndecoded > 0)
+        printf(" and %u undecoded bytes", total.mUndecoded);
+    printf(". Redundant loads: %u BP, %u CP, %u XF\n", total.mRedundantBP, total.mRedundantCP,
+           total.mRedundantXF);
+    return 0;
+}
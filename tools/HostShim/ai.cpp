@@ -0,0 +1,113 @@
+// HostShim AI layer - the streaming sample counter, driven by the shim clock
+
+#include <Dolphin/AI.h>
+
+#include "p_hostshim.hxx"
+
+// How often the sample counter is brought up to date while the stream plays
+static constexpr OSTime AudioTickPeriod = HostShim::TicksPerSecond / 1000;
+
+// ADPCM stream frames hold 28 samples in 32 bytes
+static constexpr u32 StreamFrameSamples = 28;
+static constexpr u32 StreamFrameBytes   = 32;
+
+// Guarded by the interrupt lock, like the AI registers they replace
+static AISCallback sStreamCallback = nullptr;
+static u32 sSampleRate             = 48000;
+static u32 sSampleCount            = 0;
+static u32 sTrigger                = 0;
+static u8 sVolLeft                 = 0;
+static u8 sVolRight                = 0;
+static bool sIsPlaying             = false;
+static OSTime sCountBaseTime       = 0;
+static u32 sCountBase              = 0;
+static u64 sTickGeneration         = 0;
+
+static void rebaseSampleCount() {
+    sCountBaseTime = HostShim::now();
+    sCountBase     = sSampleCount;
+}
+
+static void updateSampleCount() {
+    if (!sIsPlaying)
+        return;
+
+    const OSTime elapsed = HostShim::now() - sCountBaseTime;
+    const u32 previous   = sSampleCount;
+    const u64 samples    = (static_cast<u64>(elapsed) * sSampleRate) / HostShim::TicksPerSecond;
+    sSampleCount         = sCountBase + static_cast<u32>(samples);
+
+    if (sStreamCallback && previous < sTrigger && sSampleCount >= sTrigger)
+        sStreamCallback(sTrigger);
+}
+
+static void scheduleAudioTick(u64 generation) {
+    HostShim::postEventAt(HostShim::now() + AudioTickPeriod, [generation]() {
+        if (generation != sTickGeneration || !sIsPlaying)
+            return;
+        updateSampleCount();
+        scheduleAudioTick(generation);
+    });
+}
+
+u32 HostShim::getStreamBytesPlayed() {
+    updateSampleCount();
+    return (sSampleCount / StreamFrameSamples) * StreamFrameBytes;
+}
+
+void AIInit(u8 *stack) {}
+
+AISCallback AIRegisterStreamCallback(AISCallback cb) {
+    const bool level = OSDisableInterrupts();
+    AISCallback prev = sStreamCallback;
+    sStreamCallback  = cb;
+    OSRestoreInterrupts(level);
+    return prev;
+}
+
+void AISetStreamSampleRate(u32 rate) {
+    const bool level = OSDisableInterrupts();
+    updateSampleCount();
+    sSampleRate = rate == AI_SAMPLE_48K ? 48000 : 32000;
+    rebaseSampleCount();
+    OSRestoreInterrupts(level);
+}
+
+void AIResetStreamSampleCount() {
+    const bool level = OSDisableInterrupts();
+    sSampleCount     = 0;
+    rebaseSampleCount();
+    OSRestoreInterrupts(level);
+}
+
+u32 AIGetStreamSampleCount() {
+    const bool level = OSDisableInterrupts();
+    updateSampleCount();
+    const u32 count = sSampleCount;
+    OSRestoreInterrupts(level);
+    return count;
+}
+
+void AISetStreamTrigger(u32 trigger) { sTrigger = trigger; }
+u32 AIGetStreamTrigger() { return sTrigger; }
+
+void AISetStreamVolLeft(u8 vol) { sVolLeft = vol; }
+void AISetStreamVolRight(u8 vol) { sVolRight = vol; }
+u8 AIGetStreamVolLeft() { return sVolLeft; }
+u8 AIGetStreamVolRight() { return sVolRight; }
+
+void AISetStreamPlayState(u32 state) {
+    const bool level = OSDisableInterrupts();
+
+    updateSampleCount();
+    sIsPlaying = state != 0;
+    rebaseSampleCount();
+
+    sTickGeneration += 1;
+    if (sIsPlaying)
+        scheduleAudioTick(sTickGeneration);
+
+    OSRestoreInterrupts(level);
+}
+
+u32 AIGetStreamPlayState() { return sIsPlaying ? 1 : 0; }
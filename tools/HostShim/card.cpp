@@ -0,0 +1,266 @@
+// HostShim CARD layer - one host directory per slot, one host file per card file
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Dolphin/CARD.h>
+
+#include "p_hostshim.hxx"
+
+struct HostCardFile {
+    std::string mName;
+    std::vector<u8> mStat;
+};
+
+static std::mutex sCardLock;
+static std::string sCardRoot = ".";
+static bool sIsMounted[2]    = {false, false};
+static u32 sBusyCalls[2]     = {0, 0};
+static std::vector<HostCardFile> sCardFiles[2];
+
+void HostShim::setCardRoot(const char *path) {
+    std::lock_guard<std::mutex> lock(sCardLock);
+    sCardRoot = path;
+    for (int i = 0; i < 2; ++i) {
+        sIsMounted[i] = false;
+        sBusyCalls[i] = 0;
+        sCardFiles[i].clear();
+    }
+}
+
+void HostShim::setCardBusy(s32 chan, u32 calls) {
+    if (chan != CARD_SLOTA && chan != CARD_SLOTB)
+        return;
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+    sBusyCalls[chan] = calls;
+}
+
+// Takes one refused call from the slot's busy count
+static bool isCardBusy(s32 chan) {
+    if (chan != CARD_SLOTA && chan != CARD_SLOTB)
+        return false;
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+    if (sBusyCalls[chan] == 0)
+        return false;
+
+    sBusyCalls[chan] -= 1;
+    return true;
+}
+
+static std::string getSlotPath(s32 chan) {
+    return sCardRoot + (chan == CARD_SLOTA ? "/slotA" : "/slotB");
+}
+
+static bool isCardInserted(s32 chan) {
+    if (chan != CARD_SLOTA && chan != CARD_SLOTB)
+        return false;
+
+    struct stat info;
+    return stat(getSlotPath(chan).c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+static std::string getFilePath(s32 chan, const std::string &name) {
+    return getSlotPath(chan) + "/" + name;
+}
+
+// Caller holds sCardLock
+static s32 findFileNo(s32 chan, const char *fileName) {
+    std::vector<HostCardFile> &files = sCardFiles[chan];
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (files[i].mName == fileName)
+            return static_cast<s32>(i);
+    }
+
+    HostCardFile file;
+    file.mName = fileName;
+    file.mStat.resize(sizeof(CARDStat));
+    files.push_back(file);
+    return static_cast<s32>(files.size() - 1);
+}
+
+void CARDInit() {}
+
+void __CARDSetDiskID(const DVDDiskID *id) {}
+
+s32 CARDCheck(s32 chan) {
+    if (isCardBusy(chan))
+        return CARD_ERROR_BUSY;
+
+    HostShim::wait(HostShim::getCardLatency());
+    return isCardInserted(chan) ? CARD_ERROR_READY : CARD_ERROR_NOCARD;
+}
+
+s32 CARDMount(s32 chan, void *workArea, CARDCallback detachCallback) {
+    if (isCardBusy(chan))
+        return CARD_ERROR_BUSY;
+
+    HostShim::wait(HostShim::getCardLatency());
+
+    if (!isCardInserted(chan))
+        return CARD_ERROR_NOCARD;
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+    sIsMounted[chan] = true;
+    return CARD_ERROR_READY;
+}
+
+s32 CARDUnmount(s32 chan) {
+    if (chan != CARD_SLOTA && chan != CARD_SLOTB)
+        return CARD_ERROR_NOCARD;
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+    sIsMounted[chan] = false;
+    return CARD_ERROR_READY;
+}
+
+s32 CARDOpen(s32 chan, const char *fileName, CARDFileInfo *fileInfo) {
+    if (isCardBusy(chan))
+        return CARD_ERROR_BUSY;
+
+    if (!isCardInserted(chan))
+        return CARD_ERROR_NOCARD;
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+    if (!sIsMounted[chan])
+        return CARD_ERROR_NOCARD;
+
+    struct stat info;
+    if (stat(getFilePath(chan, fileName).c_str(), &info) != 0)
+        return CARD_ERROR_NOFILE;
+
+    fileInfo->mChannel = chan;
+    fileInfo->mFileNo  = findFileNo(chan, fileName);
+    return CARD_ERROR_READY;
+}
+
+s32 CARDCreate(s32 chan, const char *fileName, u32 size, CARDFileInfo *fileInfo) {
+    if (isCardBusy(chan))
+        return CARD_ERROR_BUSY;
+
+    HostShim::wait(HostShim::getCardLatency());
+
+    if (!isCardInserted(chan))
+        return CARD_ERROR_NOCARD;
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+    if (!sIsMounted[chan])
+        return CARD_ERROR_NOCARD;
+
+    const std::string path = getFilePath(chan, fileName);
+
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0)
+        return CARD_ERROR_EXIST;
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+        return CARD_ERROR_FATAL_ERROR;
+
+    std::vector<u8> blank(size, 0);
+    fwrite(blank.data(), 1, blank.size(), file);
+    fclose(file);
+
+    fileInfo->mChannel = chan;
+    fileInfo->mFileNo  = findFileNo(chan, fileName);
+    return CARD_ERROR_READY;
+}
+
+s32 CARDClose(CARDFileInfo *fileInfo) { return CARD_ERROR_READY; }
+
+// Caller holds sCardLock
+static std::string getOpenFilePath(CARDFileInfo *fileInfo) {
+    const s32 chan = fileInfo->mChannel;
+    if (chan != CARD_SLOTA && chan != CARD_SLOTB)
+        return std::string();
+
+    std::vector<HostCardFile> &files = sCardFiles[chan];
+    if (fileInfo->mFileNo < 0 || fileInfo->mFileNo >= static_cast<s32>(files.size()))
+        return std::string();
+
+    return getFilePath(chan, files[fileInfo->mFileNo].mName);
+}
+
+s32 CARDRead(CARDFileInfo *fileInfo, void *buf, s32 length, s32 offset) {
+    if (isCardBusy(fileInfo->mChannel))
+        return CARD_ERROR_BUSY;
+
+    HostShim::wait(HostShim::getCardLatency());
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+
+    const std::string path = getOpenFilePath(fileInfo);
+    if (path.empty() || !isCardInserted(fileInfo->mChannel))
+        return CARD_ERROR_NOCARD;
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+        return CARD_ERROR_NOFILE;
+
+    fseek(file, offset, SEEK_SET);
+    const size_t read = fread(buf, 1, length, file);
+    fclose(file);
+
+    return read == static_cast<size_t>(length) ? CARD_ERROR_READY : CARD_ERROR_LIMIT;
+}
+
+s32 CARDWrite(CARDFileInfo *fileInfo, const void *buf, s32 length, s32 offset) {
+    if (isCardBusy(fileInfo->mChannel))
+        return CARD_ERROR_BUSY;
+
+    HostShim::wait(HostShim::getCardLatency());
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+
+    const std::string path = getOpenFilePath(fileInfo);
+    if (path.empty() || !isCardInserted(fileInfo->mChannel))
+        return CARD_ERROR_NOCARD;
+
+    FILE *file = fopen(path.c_str(), "r+b");
+    if (!file)
+        return CARD_ERROR_NOFILE;
+
+    fseek(file, offset, SEEK_SET);
+    const size_t written = fwrite(buf, 1, length, file);
+    fclose(file);
+
+    return written == static_cast<size_t>(length) ? CARD_ERROR_READY : CARD_ERROR_LIMIT;
+}
+
+// Status blocks are kept in memory only; banner and icon layout do not matter off-console
+s32 CARDGetStatus(s32 chan, s32 fileNo, CARDStat *stat) {
+    if (isCardBusy(chan))
+        return CARD_ERROR_BUSY;
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+
+    if ((chan != CARD_SLOTA && chan != CARD_SLOTB) || fileNo < 0 ||
+        fileNo >= static_cast<s32>(sCardFiles[chan].size()))
+        return CARD_ERROR_NOFILE;
+
+    memcpy(stat, sCardFiles[chan][fileNo].mStat.data(), sizeof(CARDStat));
+    return CARD_ERROR_READY;
+}
+
+s32 CARDSetStatus(s32 chan, s32 fileNo, CARDStat *stat) {
+    if (isCardBusy(chan))
+        return CARD_ERROR_BUSY;
+
+    HostShim::wait(HostShim::getCardLatency());
+
+    std::lock_guard<std::mutex> lock(sCardLock);
+
+    if ((chan != CARD_SLOTA && chan != CARD_SLOTB) || fileNo < 0 ||
+        fileNo >= static_cast<s32>(sCardFiles[chan].size()))
+        return CARD_ERROR_NOFILE;
+
+    memcpy(sCardFiles[chan][fileNo].mStat.data(), stat, sizeof(CARDStat));
+    return CARD_ERROR_READY;
+}
@@ -0,0 +1,226 @@
+// HostShim DVD layer - files under the disc root, plus the audio streaming commands
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Dolphin/DVD.h>
+
+#include "p_hostshim.hxx"
+
+struct HostDiscEntry {
+    std::string mPath;
+    u32 mStart;
+    u32 mLength;
+};
+
+static std::mutex sDiscLock;
+static std::string sDiscRoot = ".";
+static std::vector<HostDiscEntry> sEntries;
+static std::unordered_map<DVDFileInfo *, s32> sOpenFiles;
+static u32 sNextDiscOffset = 0;
+
+// Prepared stream; the AI layer reports how far into it playback is
+static DVDFileInfo *sStreamFile = nullptr;
+static u32 sStreamOffset        = 0;
+static u32 sStreamLength        = 0;
+static bool sIsStreaming        = false;
+
+void HostShim::setDiscRoot(const char *path) {
+    std::lock_guard<std::mutex> lock(sDiscLock);
+    sDiscRoot = path;
+    sEntries.clear();
+    sNextDiscOffset = 0;
+}
+
+static void finishCommand(DVDCommandBlock *block, s32 result) {
+    block->mCommandResult = result;
+    block->mCurState      = DVD_STATE_END;
+}
+
+// Queues a drive command; the callback fires after the DVD latency like the drive interrupt
+static void postCommand(DVDCommandBlock *block, DVDCBCallback cb, s32 result) {
+    block->mCurState = DVD_STATE_BUSY;
+    HostShim::postEventAt(HostShim::now() + HostShim::getDVDLatency(), [block, cb, result]() {
+        finishCommand(block, result);
+        if (cb)
+            cb(result, block);
+    });
+}
+
+s32 DVDConvertPathToEntrynum(const char *path) {
+    std::lock_guard<std::mutex> lock(sDiscLock);
+
+    for (size_t i = 0; i < sEntries.size(); ++i) {
+        if (sEntries[i].mPath == path)
+            return static_cast<s32>(i);
+    }
+
+    const std::string hostPath = sDiscRoot + (path[0] == '/' ? "" : "/") + path;
+
+    struct stat info;
+    if (stat(hostPath.c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+        return -1;
+
+    // Hand out disc addresses the way a packed FST would, 32 KB aligned
+    HostDiscEntry entry;
+    entry.mPath     = path;
+    entry.mStart    = sNextDiscOffset;
+    entry.mLength   = static_cast<u32>(info.st_size);
+    sNextDiscOffset = (sNextDiscOffset + entry.mLength + 0x7FFF) & ~0x7FFF;
+
+    sEntries.push_back(entry);
+    return static_cast<s32>(sEntries.size() - 1);
+}
+
+bool DVDFastOpen(s32 entrynum, DVDFileInfo *fileInfo) {
+    std::lock_guard<std::mutex> lock(sDiscLock);
+
+    if (entrynum < 0 || entrynum >= static_cast<s32>(sEntries.size()))
+        return false;
+
+    const HostDiscEntry &entry = sEntries[entrynum];
+    fileInfo->mStart              = entry.mStart;
+    fileInfo->mLen                = entry.mLength;
+    fileInfo->mCmdBlock.mOffset   = 0;
+    fileInfo->mCmdBlock.mCurState = DVD_STATE_END;
+
+    sOpenFiles[fileInfo] = entrynum;
+    return true;
+}
+
+bool DVDOpen(const char *fileName, DVDFileInfo *fileInfo) {
+    const s32 entrynum = DVDConvertPathToEntrynum(fileName);
+    if (entrynum < 0)
+        return false;
+    return DVDFastOpen(entrynum, fileInfo);
+}
+
+bool DVDClose(DVDFileInfo *fileInfo) {
+    std::lock_guard<std::mutex> lock(sDiscLock);
+    sOpenFiles.erase(fileInfo);
+    return true;
+}
+
+static s32 readHostFile(DVDFileInfo *fileInfo, void *addr, s32 length, s32 offset) {
+    std::string hostPath;
+    {
+        std::lock_guard<std::mutex> lock(sDiscLock);
+
+        auto it = sOpenFiles.find(fileInfo);
+        if (it == sOpenFiles.end())
+            return -1;
+
+        const std::string &path = sEntries[it->second].mPath;
+        hostPath                = sDiscRoot + (path[0] == '/' ? "" : "/") + path;
+    }
+
+    const int fd = open(hostPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    const ssize_t result = pread(fd, addr, length, offset);
+    close(fd);
+
+    return result < 0 ? -1 : static_cast<s32>(result);
+}
+
+s32 DVDReadPrio(DVDFileInfo *fileInfo, void *addr, s32 length, s32 offset, s32 prio) {
+    HostShim::wait(HostShim::getDVDLatency());
+    return readHostFile(fileInfo, addr, length, offset);
+}
+
+bool DVDReadAsyncPrio(DVDFileInfo *fileInfo, void *addr, s32 length, s32 offset,
+                      DVDCallback cb, s32 prio) {
+    fileInfo->mCmdBlock.mCurState = DVD_STATE_BUSY;
+    HostShim::postEventAt(HostShim::now() + HostShim::getDVDLatency(),
+                          [fileInfo, addr, length, offset, cb]() {
+                              const s32 result = readHostFile(fileInfo, addr, length, offset);
+                              finishCommand(&fileInfo->mCmdBlock, result);
+                              if (cb)
+                                  cb(result, fileInfo);
+                          });
+    return true;
+}
+
+s32 DVDCheckDisk() { return 1; }
+
+#pragma region Streaming
+
+bool DVDPrepareStreamAsync(DVDFileInfo *fileInfo, u32 length, u32 offset, DVDCallback cb) {
+    fileInfo->mCmdBlock.mCurState = DVD_STATE_BUSY;
+    HostShim::postEventAt(HostShim::now() + HostShim::getDVDLatency(),
+                          [fileInfo, length, offset, cb]() {
+                              sStreamFile   = fileInfo;
+                              sStreamOffset = offset;
+                              sStreamLength = length;
+                              sIsStreaming  = true;
+                              finishCommand(&fileInfo->mCmdBlock, 0);
+                              if (cb)
+                                  cb(0, fileInfo);
+                          });
+    return true;
+}
+
+// Disc address of the sample being played, clamped to the prepared range
+static u32 getStreamPlayAddr() {
+    if (!sStreamFile)
+        return 0;
+
+    u32 played = HostShim::getStreamBytesPlayed();
+    if (played > sStreamLength)
+        played = sStreamLength;
+
+    return sStreamFile->mStart + sStreamOffset + played;
+}
+
+bool DVDGetStreamPlayAddrAsync(DVDCommandBlock *block, DVDCBCallback cb) {
+    const bool level = OSDisableInterrupts();
+    const u32 addr   = getStreamPlayAddr();
+    OSRestoreInterrupts(level);
+
+    postCommand(block, cb, addr);
+    return true;
+}
+
+// 1 while a stream is playing, 0 once it ran off the end or was cancelled
+bool DVDGetStreamErrorStatusAsync(DVDCommandBlock *block, DVDCBCallback cb) {
+    const bool level    = OSDisableInterrupts();
+    const bool isActive = sIsStreaming && HostShim::getStreamBytesPlayed() < sStreamLength;
+    OSRestoreInterrupts(level);
+
+    postCommand(block, cb, isActive ? 1 : 0);
+    return true;
+}
+
+bool DVDStopStreamAtEndAsync(DVDCommandBlock *block, DVDCBCallback cb) {
+    postCommand(block, cb, 0);
+    return true;
+}
+
+bool DVDCancelStreamAsync(DVDCommandBlock *block, DVDCBCallback cb) {
+    const bool level = OSDisableInterrupts();
+    sIsStreaming     = false;
+    OSRestoreInterrupts(level);
+
+    postCommand(block, cb, 0);
+    return true;
+}
+
+u32 DVDCancelStream(DVDCommandBlock *block) {
+    HostShim::wait(HostShim::getDVDLatency());
+
+    const bool level = OSDisableInterrupts();
+    sIsStreaming     = false;
+    finishCommand(block, 0);
+    OSRestoreInterrupts(level);
+
+    return 0;
+}
+
+#pragma endregion
@@ -0,0 +1,49 @@
+#pragma once
+
+// HostShim - Linux stand-ins for the Dolphin OS, DVD, CARD and AI calls the
+// engine makes, so the audio streamer, card I/O and autosave threads can be
+// run and timed off-console.
+//
+// Build: CMakeLists.txt here builds the shim as the HostShim library plus its
+// test, against the Dolphin headers in lib/sms_interface (override with
+// HOSTSHIM_DOLPHIN_INCLUDE_DIR). Link the engine sources under test against
+// HostShim and leave src/libs/dolphin out; this folder replaces it.
+//
+// Anything the hardware delivers as an interrupt (alarms, DVD and AI
+// callbacks) runs on a shim thread while holding the lock that
+// OSDisableInterrupts takes, so callbacks observe the same exclusion they
+// would on console. Thread priorities are ignored.
+
+#include <Dolphin/OS.h>
+#include <Dolphin/types.h>
+
+namespace HostShim {
+    // Console timebase, bus clock / 4
+    constexpr u64 TicksPerSecond = 40500000;
+
+    // Host directories standing in for the disc root and the memory card slots.
+    // A slot is inserted when <cardRoot>/slotA or <cardRoot>/slotB exists.
+    void setDiscRoot(const char *path);
+    void setCardRoot(const char *path);
+
+    // With the simulated clock, time only moves through advanceClock. Alarms,
+    // device callbacks and the audio stream fire as the clock passes them, and
+    // I/O latency is charged to the clock instead of sleeping, so timings don't
+    // depend on host speed. A blocking OSReceiveMessage on an empty queue
+    // moves the clock to the next pending event instead of sleeping. Every
+    // thread that waits advances the one shared clock, so with several threads
+    // waiting the result still depends on how the host schedules them. Pick
+    // the mode before starting any engine threads.
+    void useSimulatedClock(bool simulated);
+    void advanceClock(OSTime ticks);
+
+    // Latency charged to every DVD or CARD transfer, and to CARDCheck and
+    // CARDMount, which read the card's directory on console
+    void setDVDLatency(OSTime ticks);
+    void setCardLatency(OSTime ticks);
+
+    // The next calls on the slot fail with CARD_ERROR_BUSY without starting,
+    // as when another thread's operation holds the card. Unmount and close
+    // are never refused.
+    void setCardBusy(s32 chan, u32 calls);
+}  // namespace HostShim
@@ -0,0 +1,589 @@
+// HostShim OS layer - clock, interrupts, threads, message queues, mutexes and alarms
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "p_hostshim.hxx"
+
+#pragma region Clock
+
+static std::atomic<bool> sIsSimulatedClock{false};
+static std::atomic<OSTime> sSimulatedTime{0};
+static const auto sRealBaseTime = std::chrono::steady_clock::now();
+
+static std::atomic<OSTime> sDVDLatency{0};
+static std::atomic<OSTime> sCardLatency{0};
+
+static OSTime nanosecondsToTicks(s64 ns) {
+    return static_cast<OSTime>((static_cast<__int128>(ns) * HostShim::TicksPerSecond) /
+                               1000000000);
+}
+
+static s64 ticksToNanoseconds(OSTime ticks) {
+    return static_cast<s64>((static_cast<__int128>(ticks) * 1000000000) /
+                            HostShim::TicksPerSecond);
+}
+
+OSTime HostShim::now() {
+    if (sIsSimulatedClock)
+        return sSimulatedTime;
+
+    const auto elapsed = std::chrono::steady_clock::now() - sRealBaseTime;
+    return nanosecondsToTicks(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void HostShim::useSimulatedClock(bool simulated) { sIsSimulatedClock = simulated; }
+
+void HostShim::setDVDLatency(OSTime ticks) { sDVDLatency = ticks; }
+void HostShim::setCardLatency(OSTime ticks) { sCardLatency = ticks; }
+OSTime HostShim::getDVDLatency() { return sDVDLatency; }
+OSTime HostShim::getCardLatency() { return sCardLatency; }
+
+OSTime OSGetTime() { return HostShim::now(); }
+OSTick OSGetTick() { return static_cast<OSTick>(HostShim::now()); }
+
+#pragma endregion
+
+#pragma region Interrupts
+
+// Held while "interrupts are disabled"; device callbacks take it too
+static std::recursive_mutex sInterruptLock;
+static thread_local u32 tInterruptDepth = 0;
+
+bool OSDisableInterrupts() {
+    sInterruptLock.lock();
+    return tInterruptDepth++ == 0;
+}
+
+bool OSRestoreInterrupts(bool level) {
+    if (tInterruptDepth == 0)
+        return true;
+    tInterruptDepth -= 1;
+    sInterruptLock.unlock();
+    return level;
+}
+
+bool OSEnableInterrupts() {
+    const bool wasEnabled = tInterruptDepth == 0;
+    while (tInterruptDepth > 0) {
+        tInterruptDepth -= 1;
+        sInterruptLock.unlock();
+    }
+    return wasEnabled;
+}
+
+#pragma endregion
+
+#pragma region Events
+
+struct HostEvent {
+    OSTime mWhen;
+    std::function<void()> mWork;
+};
+
+// Never destroyed, the scheduler thread may still be waiting on them at exit
+static std::mutex &sEventLock              = *new std::mutex;
+static std::condition_variable &sEventCond = *new std::condition_variable;
+static std::map<u64, HostEvent> &sEvents   = *new std::map<u64, HostEvent>;
+static u64 sNextEventID      = 1;
+static bool sIsSchedulerLive = false;
+
+static std::recursive_mutex sAdvanceLock;
+
+// Pops the earliest event due by the given time, if any
+static bool popDueEvent(OSTime until, HostEvent &out) {
+    std::lock_guard<std::mutex> lock(sEventLock);
+
+    auto due = sEvents.end();
+    for (auto it = sEvents.begin(); it != sEvents.end(); ++it) {
+        if (it->second.mWhen > until)
+            continue;
+        if (due == sEvents.end() || it->second.mWhen < due->second.mWhen)
+            due = it;
+    }
+
+    if (due == sEvents.end())
+        return false;
+
+    out = std::move(due->second);
+    sEvents.erase(due);
+    return true;
+}
+
+static void runEvent(HostEvent &event) {
+    const bool level = OSDisableInterrupts();
+    event.mWork();
+    OSRestoreInterrupts(level);
+}
+
+static void schedulerThread() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(sEventLock);
+            if (sEvents.empty()) {
+                sEventCond.wait(lock);
+                continue;
+            }
+
+            OSTime next = sEvents.begin()->second.mWhen;
+            for (auto &item : sEvents) {
+                if (item.second.mWhen < next)
+                    next = item.second.mWhen;
+            }
+
+            const OSTime current = HostShim::now();
+            if (next > current) {
+                const s64 ns = ticksToNanoseconds(next - current);
+                sEventCond.wait_for(lock, std::chrono::nanoseconds(ns));
+                continue;
+            }
+        }
+
+        HostEvent event;
+        while (popDueEvent(HostShim::now(), event)) {
+            runEvent(event);
+        }
+    }
+}
+
+u64 HostShim::postEventAt(OSTime when, std::function<void()> work) {
+    std::lock_guard<std::mutex> lock(sEventLock);
+
+    const u64 id = sNextEventID++;
+    sEvents[id]  = {when, std::move(work)};
+
+    if (!sIsSimulatedClock && !sIsSchedulerLive) {
+        std::thread(schedulerThread).detach();
+        sIsSchedulerLive = true;
+    }
+
+    sEventCond.notify_one();
+    return id;
+}
+
+void HostShim::cancelEvent(u64 id) {
+    std::lock_guard<std::mutex> lock(sEventLock);
+    sEvents.erase(id);
+}
+
+void HostShim::advanceClock(OSTime ticks) {
+    std::lock_guard<std::recursive_mutex> lock(sAdvanceLock);
+
+    const OSTime target = sSimulatedTime + ticks;
+
+    HostEvent event;
+    while (popDueEvent(target, event)) {
+        if (event.mWhen > sSimulatedTime)
+            sSimulatedTime = event.mWhen;
+        runEvent(event);
+    }
+
+    sSimulatedTime = target;
+}
+
+bool HostShim::advanceToNextEvent() {
+    OSTime next;
+    {
+        std::lock_guard<std::mutex> lock(sEventLock);
+        if (sEvents.empty())
+            return false;
+
+        next = sEvents.begin()->second.mWhen;
+        for (auto &item : sEvents) {
+            if (item.second.mWhen < next)
+                next = item.second.mWhen;
+        }
+    }
+
+    const OSTime current = sSimulatedTime;
+    advanceClock(next > current ? next - current : 0);
+    return true;
+}
+
+void HostShim::wait(OSTime ticks) {
+    if (ticks <= 0)
+        return;
+
+    if (sIsSimulatedClock)
+        advanceClock(ticks);
+    else
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ticksToNanoseconds(ticks)));
+}
+
+#pragma endregion
+
+#pragma region Threads
+
+struct HostThread {
+    pthread_t mHandle;
+    void *(*mFunc)(void *);
+    void *mParam;
+    void *mResult;
+    s32 mSuspendCount;
+    bool mIsStarted;
+    bool mIsTerminated;
+    bool mIsJoined;
+};
+
+static std::mutex sThreadLock;
+static std::condition_variable sThreadCond;
+static std::unordered_map<OSThread *, HostThread> sThreads;
+static thread_local OSThread *tCurrentThread = nullptr;
+static OSThread sDefaultThread;
+
+static void finishThread(OSThread *thread, void *result) {
+    std::lock_guard<std::mutex> lock(sThreadLock);
+    HostThread &host   = sThreads[thread];
+    host.mResult       = result;
+    host.mIsTerminated = true;
+    sThreadCond.notify_all();
+}
+
+static void onThreadCancelled(void *arg) {
+    finishThread(static_cast<OSThread *>(arg), nullptr);
+}
+
+static void *threadTrampoline(void *arg) {
+    OSThread *thread = static_cast<OSThread *>(arg);
+    tCurrentThread   = thread;
+
+    void *(*func)(void *);
+    void *param;
+    {
+        std::lock_guard<std::mutex> lock(sThreadLock);
+        func  = sThreads[thread].mFunc;
+        param = sThreads[thread].mParam;
+    }
+
+    void *result = nullptr;
+    pthread_cleanup_push(onThreadCancelled, thread);
+    result = func(param);
+    pthread_cleanup_pop(0);
+
+    finishThread(thread, result);
+    return result;
+}
+
+bool OSCreateThread(OSThread *thread, void *(*func)(void *), void *param, void *stack,
+                    u32 stackSize, OSPriority priority, u16 attr) {
+    std::lock_guard<std::mutex> lock(sThreadLock);
+
+    HostThread &host   = sThreads[thread];
+    host.mFunc         = func;
+    host.mParam        = param;
+    host.mResult       = nullptr;
+    host.mSuspendCount = 1;
+    host.mIsStarted    = false;
+    host.mIsTerminated = false;
+    host.mIsJoined     = false;
+    return true;
+}
+
+s32 OSResumeThread(OSThread *thread) {
+    std::lock_guard<std::mutex> lock(sThreadLock);
+
+    auto it = sThreads.find(thread);
+    if (it == sThreads.end())
+        return 0;
+
+    HostThread &host = it->second;
+    const s32 prev   = host.mSuspendCount;
+    if (host.mSuspendCount > 0)
+        host.mSuspendCount -= 1;
+
+    // Suspending a running host thread is not supported, only the initial start
+    if (host.mSuspendCount == 0 && !host.mIsStarted) {
+        host.mIsStarted = true;
+        pthread_create(&host.mHandle, nullptr, threadTrampoline, thread);
+    }
+
+    return prev;
+}
+
+s32 OSSuspendThread(OSThread *thread) {
+    std::lock_guard<std::mutex> lock(sThreadLock);
+    return sThreads[thread].mSuspendCount++;
+}
+
+bool OSIsThreadTerminated(OSThread *thread) {
+    std::lock_guard<std::mutex> lock(sThreadLock);
+
+    auto it = sThreads.find(thread);
+    return it == sThreads.end() || it->second.mIsTerminated;
+}
+
+bool OSJoinThread(OSThread *thread, void **val) {
+    pthread_t handle;
+    {
+        std::unique_lock<std::mutex> lock(sThreadLock);
+
+        auto it = sThreads.find(thread);
+        if (it == sThreads.end() || !it->second.mIsStarted || it->second.mIsJoined)
+            return false;
+
+        it->second.mIsJoined = true;
+        handle               = it->second.mHandle;
+    }
+
+    pthread_join(handle, nullptr);
+
+    std::lock_guard<std::mutex> lock(sThreadLock);
+    if (val)
+        *val = sThreads[thread].mResult;
+    return true;
+}
+
+void OSCancelThread(OSThread *thread) {
+    if (thread == tCurrentThread)
+        pthread_exit(nullptr);
+
+    pthread_t handle;
+    {
+        std::lock_guard<std::mutex> lock(sThreadLock);
+
+        auto it = sThreads.find(thread);
+        if (it == sThreads.end() || !it->second.mIsStarted || it->second.mIsTerminated)
+            return;
+
+        handle = it->second.mHandle;
+    }
+
+    // Takes effect at the thread's next blocking call, as OSReceiveMessage
+    // and the other waits here are cancellation points
+    pthread_cancel(handle);
+}
+
+void OSExitThread(void *val) { pthread_exit(val); }
+
+void OSYieldThread() { sched_yield(); }
+
+OSThread *OSGetCurrentThread() { return tCurrentThread ? tCurrentThread : &sDefaultThread; }
+
+#pragma endregion
+
+#pragma region Messages
+
+struct HostMessageQueue {
+    OSMessage *mMessages;
+    s32 mCapacity;
+    s32 mFirst;
+    s32 mCount;
+    std::mutex mLock;
+    std::condition_variable mSendCond;
+    std::condition_variable mReceiveCond;
+};
+
+static std::mutex sQueueLock;
+static std::unordered_map<OSMessageQueue *, HostMessageQueue> sQueues;
+
+static HostMessageQueue &getHostQueue(OSMessageQueue *mq) {
+    std::lock_guard<std::mutex> lock(sQueueLock);
+    return sQueues[mq];
+}
+
+void OSInitMessageQueue(OSMessageQueue *mq, OSMessage *msgArray, s32 msgCount) {
+    HostMessageQueue &queue = getHostQueue(mq);
+    std::lock_guard<std::mutex> lock(queue.mLock);
+    queue.mMessages = msgArray;
+    queue.mCapacity = msgCount;
+    queue.mFirst    = 0;
+    queue.mCount    = 0;
+}
+
+bool OSSendMessage(OSMessageQueue *mq, OSMessage msg, s32 flags) {
+    HostMessageQueue &queue = getHostQueue(mq);
+    std::unique_lock<std::mutex> lock(queue.mLock);
+
+    while (queue.mCount >= queue.mCapacity) {
+        if (flags != OS_MESSAGE_BLOCK)
+            return false;
+        queue.mSendCond.wait(lock);
+    }
+
+    queue.mMessages[(queue.mFirst + queue.mCount) % queue.mCapacity] = msg;
+    queue.mCount += 1;
+    queue.mReceiveCond.notify_one();
+    return true;
+}
+
+bool OSJamMessage(OSMessageQueue *mq, OSMessage msg, s32 flags) {
+    HostMessageQueue &queue = getHostQueue(mq);
+    std::unique_lock<std::mutex> lock(queue.mLock);
+
+    while (queue.mCount >= queue.mCapacity) {
+        if (flags != OS_MESSAGE_BLOCK)
+            return false;
+        queue.mSendCond.wait(lock);
+    }
+
+    queue.mFirst                  = (queue.mFirst + queue.mCapacity - 1) % queue.mCapacity;
+    queue.mMessages[queue.mFirst] = msg;
+    queue.mCount += 1;
+    queue.mReceiveCond.notify_one();
+    return true;
+}
+
+bool OSReceiveMessage(OSMessageQueue *mq, OSMessage *msg, s32 flags) {
+    HostMessageQueue &queue = getHostQueue(mq);
+    std::unique_lock<std::mutex> lock(queue.mLock);
+
+    while (queue.mCount == 0) {
+        if (flags != OS_MESSAGE_BLOCK)
+            return false;
+
+        // Nothing else moves a simulated clock while this thread waits, so
+        // it skips ahead to whatever is due next, such as the alarm it's
+        // waiting on. A sender gets the queue back in the meantime.
+        if (sIsSimulatedClock) {
+            lock.unlock();
+            const bool isAdvanced = HostShim::advanceToNextEvent();
+            lock.lock();
+            if (isAdvanced || queue.mCount > 0)
+                continue;
+        }
+
+        queue.mReceiveCond.wait(lock);
+    }
+
+    if (msg)
+        *msg = queue.mMessages[queue.mFirst];
+    queue.mFirst = (queue.mFirst + 1) % queue.mCapacity;
+    queue.mCount -= 1;
+    queue.mSendCond.notify_one();
+    return true;
+}
+
+#pragma endregion
+
+#pragma region Mutexes
+
+// Engine globals such as BetterSMS::TMutex init their mutex during static
+// initialization, so the table is built on first use rather than with the shim
+static std::recursive_mutex &getHostMutex(OSMutex *mutex) {
+    static std::mutex sMutexLock;
+    static std::unordered_map<OSMutex *, std::recursive_mutex> sMutexes;
+
+    std::lock_guard<std::mutex> lock(sMutexLock);
+    return sMutexes[mutex];
+}
+
+void OSInitMutex(OSMutex *mutex) { getHostMutex(mutex); }
+void OSLockMutex(OSMutex *mutex) { getHostMutex(mutex).lock(); }
+void OSUnlockMutex(OSMutex *mutex) { getHostMutex(mutex).unlock(); }
+bool OSTryLockMutex(OSMutex *mutex) { return getHostMutex(mutex).try_lock(); }
+
+#pragma endregion
+
+#pragma region Alarms
+
+struct HostAlarm {
+    u64 mEventID;
+    u64 mGeneration;
+    OSAlarmHandler mHandler;
+};
+
+// Set, cancel and fire all run with interrupts disabled, as on console, so a
+// cancel can never land between an alarm firing and it being re-armed
+static std::unordered_map<OSAlarm *, HostAlarm> sAlarms;
+static u64 sAlarmGeneration = 0;
+static OSContext sAlarmContext;
+
+static void fireAlarm(OSAlarm *alarm, OSTime when, u64 generation);
+
+// Caller has interrupts disabled
+static void scheduleAlarm(OSAlarm *alarm, OSTime when, OSAlarmHandler handler) {
+    const u64 generation = ++sAlarmGeneration;
+
+    HostAlarm &host  = sAlarms[alarm];
+    host.mHandler    = handler;
+    host.mGeneration = generation;
+    host.mEventID    = HostShim::postEventAt(
+        when, [alarm, when, generation]() { fireAlarm(alarm, when, generation); });
+}
+
+// Runs from runEvent, so interrupts are already disabled. The event was
+// popped before that lock was taken, so it may belong to an alarm that has
+// since been cancelled or set again; the generation tells them apart.
+static void fireAlarm(OSAlarm *alarm, OSTime when, u64 generation) {
+    auto it = sAlarms.find(alarm);
+    if (it == sAlarms.end() || it->second.mGeneration != generation)
+        return;
+
+    const OSAlarmHandler handler = it->second.mHandler;
+    if (alarm->mPeriod > 0)
+        scheduleAlarm(alarm, when + alarm->mPeriod, handler);
+    else
+        sAlarms.erase(it);
+
+    handler(alarm, &sAlarmContext);
+}
+
+void OSCreateAlarm(OSAlarm *alarm) {
+    OSCancelAlarm(alarm);
+    alarm->mPeriod = 0;
+    alarm->mStart  = 0;
+}
+
+void OSSetAlarm(OSAlarm *alarm, OSTime tick, OSAlarmHandler handler) {
+    const bool level = OSDisableInterrupts();
+    alarm->mPeriod   = 0;
+    scheduleAlarm(alarm, HostShim::now() + tick, handler);
+    OSRestoreInterrupts(level);
+}
+
+// Matches src/libs/dolphin/OS.c: first fires at start, then every period
+void OSSetPeriodicAlarm(OSAlarm *alarm, OSTime start, OSTime period, OSAlarmHandler handler) {
+    const bool level = OSDisableInterrupts();
+    alarm->mStart    = start;
+    alarm->mPeriod   = period;
+
+    const OSTime current = HostShim::now();
+    scheduleAlarm(alarm, start > current ? start : current, handler);
+    OSRestoreInterrupts(level);
+}
+
+void OSCancelAlarm(OSAlarm *alarm) {
+    const bool level = OSDisableInterrupts();
+
+    auto it = sAlarms.find(alarm);
+    if (it != sAlarms.end()) {
+        HostShim::cancelEvent(it->second.mEventID);
+        sAlarms.erase(it);
+    }
+
+    OSRestoreInterrupts(level);
+}
+
+#pragma endregion
+
+#pragma region Reporting
+
+void OSReport(const char *msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    vprintf(msg, args);
+    va_end(args);
+}
+
+void OSPanic(const char *file, int line, const char *msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    fprintf(stderr, "PANIC %s:%d: ", file, line);
+    vfprintf(stderr, msg, args);
+    va_end(args);
+    abort();
+}
+
+#pragma endregion
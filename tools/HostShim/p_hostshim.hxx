@@ -0,0 +1,27 @@
+#pragma once
+
+#include <functional>
+
+#include "hostshim.hxx"
+
+namespace HostShim {
+    OSTime now();
+
+    // Sleeps for the given ticks, or charges them to the simulated clock
+    void wait(OSTime ticks);
+
+    // Simulated clock only, moves it to the earliest pending event and runs
+    // whatever is due. Returns false if nothing is pending.
+    bool advanceToNextEvent();
+
+    // Runs work once the clock reaches the given time, with interrupts
+    // disabled. Returns an id for cancelEvent.
+    u64 postEventAt(OSTime when, std::function<void()> work);
+    void cancelEvent(u64 id);
+
+    OSTime getDVDLatency();
+    OSTime getCardLatency();
+
+    // Stream bytes consumed since the AI sample count was last reset
+    u32 getStreamBytesPlayed();
+}  // namespace HostShim
@@ -0,0 +1,363 @@
+// HostShim tests - alarms, message queues, DVD and card I/O and the audio
+// stream counter on the simulated clock, plus the engine's card retry and
+// mutex running on top of them
+//
+// Built and registered with CTest by ../CMakeLists.txt. Exits non-zero and
+// names the failing check on the first mismatch.
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <Dolphin/AI.h>
+#include <Dolphin/CARD.h>
+#include <Dolphin/DVD.h>
+#include <Dolphin/OS.h>
+
+#include "hostshim.hxx"
+#include "libs/mutex.hxx"
+#include "p_card.hxx"
+
+static int sFailures = 0;
+
+#define CHECK(cond)                                                                                \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);              \
+            sFailures += 1;                                                                        \
+        }                                                                                          \
+    } while (0)
+
+constexpr OSTime Period = 1000;
+
+static int sFireCount     = 0;
+static OSTime sLastFireAt = 0;
+
+static void countAlarm(OSAlarm *alarm, OSContext *context) {
+    sFireCount += 1;
+    sLastFireAt = OSGetTime();
+}
+
+static void cancelSelf(OSAlarm *alarm, OSContext *context) {
+    sFireCount += 1;
+    if (sFireCount == 3)
+        OSCancelAlarm(alarm);
+}
+
+static void testPeriodicAlarm() {
+    OSAlarm alarm;
+    OSCreateAlarm(&alarm);
+
+    sFireCount = 0;
+    OSSetPeriodicAlarm(&alarm, OSGetTime(), Period, countAlarm);
+    HostShim::advanceClock(Period * 10);
+
+    // Fires at the start and then on every period up to and including the target
+    CHECK(sFireCount == 11);
+    OSCancelAlarm(&alarm);
+
+    HostShim::advanceClock(Period * 10);
+    CHECK(sFireCount == 11);
+}
+
+static void testCancelledAlarm() {
+    OSAlarm alarm;
+    OSCreateAlarm(&alarm);
+
+    sFireCount = 0;
+    OSSetAlarm(&alarm, Period, countAlarm);
+    OSCancelAlarm(&alarm);
+    HostShim::advanceClock(Period * 2);
+    CHECK(sFireCount == 0);
+}
+
+// The first event is still queued when the alarm is set again; only the new one may fire
+static void testRearmedAlarm() {
+    OSAlarm alarm;
+    OSCreateAlarm(&alarm);
+
+    sFireCount           = 0;
+    const OSTime setTime = OSGetTime();
+    OSSetAlarm(&alarm, Period, countAlarm);
+    OSSetAlarm(&alarm, Period * 2, countAlarm);
+
+    HostShim::advanceClock(Period + (Period / 2));
+    CHECK(sFireCount == 0);
+
+    HostShim::advanceClock(Period);
+    CHECK(sFireCount == 1);
+    CHECK(sLastFireAt == setTime + Period * 2);
+}
+
+static void testAlarmCancelledFromHandler() {
+    OSAlarm alarm;
+    OSCreateAlarm(&alarm);
+
+    sFireCount = 0;
+    OSSetPeriodicAlarm(&alarm, OSGetTime() + Period, Period, cancelSelf);
+    HostShim::advanceClock(Period * 10);
+    CHECK(sFireCount == 3);
+}
+
+static OSMessageQueue sQueue;
+static OSMessage sQueueMessages[4];
+static OSThread sSenderThread;
+
+constexpr u32 MessageCount = 100;
+
+static void *sendMessages(void *param) {
+    for (u32 i = 1; i <= MessageCount; ++i) {
+        OSSendMessage(&sQueue, reinterpret_cast<OSMessage>(static_cast<uintptr_t>(i)),
+                      OS_MESSAGE_BLOCK);
+    }
+    return nullptr;
+}
+
+static void testMessageQueue() {
+    OSInitMessageQueue(&sQueue, sQueueMessages, 4);
+    OSCreateThread(&sSenderThread, sendMessages, nullptr, nullptr, 0, 16, 0);
+    OSResumeThread(&sSenderThread);
+
+    u32 expected = 1;
+    for (u32 i = 0; i < MessageCount; ++i) {
+        OSMessage msg;
+        OSReceiveMessage(&sQueue, &msg, OS_MESSAGE_BLOCK);
+        if (reinterpret_cast<uintptr_t>(msg) == expected)
+            expected += 1;
+    }
+    CHECK(expected == MessageCount + 1);
+
+    OSJoinThread(&sSenderThread, nullptr);
+    CHECK(OSIsThreadTerminated(&sSenderThread));
+
+    OSMessage msg;
+    CHECK(!OSReceiveMessage(&sQueue, &msg, OS_MESSAGE_NOBLOCK));
+}
+
+static void testDVDRead() {
+    char root[] = "/tmp/hostshimXXXXXX";
+    if (!mkdtemp(root)) {
+        fprintf(stderr, "Could not make a disc root\n");
+        sFailures += 1;
+        return;
+    }
+
+    const std::string path = std::string(root) + "/file.bin";
+    const char contents[]  = "HostShim disc file";
+    if (FILE *file = fopen(path.c_str(), "wb")) {
+        fwrite(contents, 1, sizeof(contents), file);
+        fclose(file);
+    }
+
+    HostShim::setDiscRoot(root);
+    HostShim::setDVDLatency(Period);
+
+    DVDFileInfo fileInfo;
+    CHECK(DVDOpen("/file.bin", &fileInfo));
+    CHECK(fileInfo.mLen == sizeof(contents));
+
+    char buffer[sizeof(contents)] = {};
+    const OSTime start            = OSGetTime();
+    CHECK(DVDReadPrio(&fileInfo, buffer, sizeof(buffer), 0, 2) == sizeof(contents));
+    CHECK(memcmp(buffer, contents, sizeof(contents)) == 0);
+    CHECK(OSGetTime() - start == Period);
+
+    DVDClose(&fileInfo);
+    CHECK(DVDConvertPathToEntrynum("/missing.bin") < 0);
+
+    unlink(path.c_str());
+    rmdir(root);
+}
+
+static bool makeCardRoot(char *root) {
+    if (!mkdtemp(root)) {
+        fprintf(stderr, "Could not make a card root\n");
+        sFailures += 1;
+        return false;
+    }
+
+    const std::string slot = std::string(root) + "/slotA";
+    mkdir(slot.c_str(), 0755);
+    HostShim::setCardRoot(root);
+    return true;
+}
+
+static void removeCardRoot(const char *root, const char *fileName) {
+    unlink((std::string(root) + "/slotA/" + fileName).c_str());
+    rmdir((std::string(root) + "/slotA").c_str());
+    rmdir(root);
+}
+
+static void testCardIO() {
+    char root[] = "/tmp/hostshimXXXXXX";
+    if (!makeCardRoot(root))
+        return;
+
+    HostShim::setCardLatency(Period);
+
+    CHECK(CARDCheck(CARD_SLOTB) == CARD_ERROR_NOCARD);
+
+    OSTime start = OSGetTime();
+    CHECK(CARDCheck(CARD_SLOTA) == CARD_ERROR_READY);
+    CHECK(CARDMount(CARD_SLOTA, nullptr, nullptr) == CARD_ERROR_READY);
+    CHECK(OSGetTime() - start == Period * 2);
+
+    CARDFileInfo fileInfo;
+    CHECK(CARDOpen(CARD_SLOTA, "save", &fileInfo) == CARD_ERROR_NOFILE);
+    CHECK(CARDCreate(CARD_SLOTA, "save", 0x2000, &fileInfo) == CARD_ERROR_READY);
+    CHECK(CARDCreate(CARD_SLOTA, "save", 0x2000, &fileInfo) == CARD_ERROR_EXIST);
+
+    char contents[0x200];
+    for (size_t i = 0; i < sizeof(contents); ++i)
+        contents[i] = static_cast<char>(i);
+
+    start = OSGetTime();
+    CHECK(CARDWrite(&fileInfo, contents, sizeof(contents), 0x200) == CARD_ERROR_READY);
+    CHECK(CARDClose(&fileInfo) == CARD_ERROR_READY);
+
+    char buffer[sizeof(contents)] = {};
+    CHECK(CARDOpen(CARD_SLOTA, "save", &fileInfo) == CARD_ERROR_READY);
+    CHECK(CARDRead(&fileInfo, buffer, sizeof(buffer), 0x200) == CARD_ERROR_READY);
+    CHECK(memcmp(buffer, contents, sizeof(contents)) == 0);
+    CHECK(OSGetTime() - start == Period * 2);
+    CHECK(CARDClose(&fileInfo) == CARD_ERROR_READY);
+
+    // Busy calls are refused before any latency is charged
+    HostShim::setCardBusy(CARD_SLOTA, 3);
+    start = OSGetTime();
+    CHECK(CARDCheck(CARD_SLOTA) == CARD_ERROR_BUSY);
+    CHECK(CARDOpen(CARD_SLOTA, "save", &fileInfo) == CARD_ERROR_BUSY);
+    CHECK(CARDMount(CARD_SLOTA, nullptr, nullptr) == CARD_ERROR_BUSY);
+    CHECK(OSGetTime() == start);
+    CHECK(CARDOpen(CARD_SLOTA, "save", &fileInfo) == CARD_ERROR_READY);
+
+    CHECK(CARDUnmount(CARD_SLOTA) == CARD_ERROR_READY);
+    HostShim::setCardLatency(0);
+    removeCardRoot(root, "save");
+}
+
+// src/p_card.hxx, as the settings container I/O uses it
+static void testCardRetry() {
+    char root[] = "/tmp/hostshimXXXXXX";
+    if (!makeCardRoot(root))
+        return;
+
+    CHECK(CARDMount(CARD_SLOTA, nullptr, nullptr) == CARD_ERROR_READY);
+
+    CARDFileInfo fileInfo;
+    CHECK(CARD_RETRY(CARDCreate(CARD_SLOTA, "retry", 0x2000, &fileInfo)) == CARD_ERROR_READY);
+
+    HostShim::setCardBusy(CARD_SLOTA, 5);
+
+    u32 attempts = 0;
+    const s32 result =
+        retryWhileBusy([&]() -> s32 {
+            attempts += 1;
+            return CARDOpen(CARD_SLOTA, "retry", &fileInfo);
+        });
+    CHECK(result == CARD_ERROR_READY);
+    CHECK(attempts == 6);
+
+    // Errors other than busy come straight back
+    attempts = 0;
+    CHECK(retryWhileBusy([&]() -> s32 {
+              attempts += 1;
+              return CARDOpen(CARD_SLOTA, "missing", &fileInfo);
+          }) == CARD_ERROR_NOFILE);
+    CHECK(attempts == 1);
+
+    CHECK(CARDUnmount(CARD_SLOTA) == CARD_ERROR_READY);
+    removeCardRoot(root, "retry");
+}
+
+static u32 sTriggerCount = 0;
+static u32 sTriggerAt    = 0;
+
+static void countTrigger(u32 trigger) {
+    sTriggerCount += 1;
+    sTriggerAt = trigger;
+}
+
+static void testAudioStream() {
+    constexpr OSTime Second = HostShim::TicksPerSecond;
+
+    AIRegisterStreamCallback(countTrigger);
+    AISetStreamSampleRate(AI_SAMPLE_48K);
+    AIResetStreamSampleCount();
+    AISetStreamTrigger(24000);
+
+    sTriggerCount = 0;
+    AISetStreamPlayState(1);
+    CHECK(AIGetStreamPlayState() == 1);
+
+    HostShim::advanceClock(Second / 4);
+    CHECK(AIGetStreamSampleCount() == 12000);
+    CHECK(sTriggerCount == 0);
+
+    HostShim::advanceClock((Second * 3) / 4);
+    CHECK(AIGetStreamSampleCount() == 48000);
+    CHECK(sTriggerCount == 1);
+    CHECK(sTriggerAt == 24000);
+
+    // A stopped stream holds its count
+    AISetStreamPlayState(0);
+    HostShim::advanceClock(Second);
+    CHECK(AIGetStreamSampleCount() == 48000);
+    CHECK(sTriggerCount == 1);
+
+    AIResetStreamSampleCount();
+    CHECK(AIGetStreamSampleCount() == 0);
+    AIRegisterStreamCallback(nullptr);
+}
+
+// include/BetterSMS/libs/mutex.hxx, shared by two shim threads
+static BetterSMS::TMutex sCounterMutex;
+static u32 sCounter = 0;
+static OSThread sCounterThread;
+
+constexpr u32 CounterSteps = 20000;
+
+static void *countUnderMutex(void *param) {
+    for (u32 i = 0; i < CounterSteps; ++i) {
+        sCounterMutex.lock();
+        sCounter += 1;
+        sCounterMutex.unlock();
+    }
+    return nullptr;
+}
+
+static void testEngineMutex() {
+    sCounter = 0;
+    OSCreateThread(&sCounterThread, countUnderMutex, nullptr, nullptr, 0, 16, 0);
+    OSResumeThread(&sCounterThread);
+    countUnderMutex(nullptr);
+    OSJoinThread(&sCounterThread, nullptr);
+    CHECK(sCounter == CounterSteps * 2);
+}
+
+int main() {
+    HostShim::useSimulatedClock(true);
+
+    testPeriodicAlarm();
+    testCancelledAlarm();
+    testRearmedAlarm();
+    testAlarmCancelledFromHandler();
+    testMessageQueue();
+    testDVDRead();
+    testCardIO();
+    testCardRetry();
+    testAudioStream();
+    testEngineMutex();
+
+    if (sFailures > 0) {
+        fprintf(stderr, "%d checks failed\n", sFailures);
+        return 1;
+    }
+
+    printf("All HostShim checks passed\n");
+    return 0;
+}
@@ -0,0 +1,264 @@
+// BoundBoxCheck - Compares CachedBoundingBox with the per call BoundingBox test it replaced
+//
+// Usage: boundboxcheck [--bench]
+// Build: c++ -std=c++20 -O2 -Ihost -I../../include/BetterSMS boundboxcheck.cpp -o boundboxcheck
+//
+// Compiles include/BetterSMS/libs/boundbox.hxx as it is against the stand-in
+// headers in host/. BoundingBox::contains as it was before the cache, which
+// rebuilt and inverted the rotation matrix on every call, is kept below as
+// the reference. Random boxes, half of them rotated, are tested against
+// random points with both volume types. The current BoundingBox, the cached
+// contains and containsMany must all agree with the reference. The one
+// allowed difference is a spheroid point whose squared distance rounds to
+// within an ULP of 1, where the reference compared its square root instead.
+// Exits 1 on any other mismatch.
+//
+// --bench times a TParticleBox style workload, boxes whose rotation never
+// changes tested against a batch of points every frame, through the
+// reference and through the cache. The figures only compare the two on this
+// machine.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "libs/boundbox.hxx"
+
+namespace Reference {
+
+    static bool contains(const BoundingBox &box, const TVec3f &point, f32 scale,
+                         BoundingType type) {
+        Mtx rot, inv_rot;
+        MsMtxSetTRS(rot, 0, 0, 0, box.rotation.x, box.rotation.y, box.rotation.z, 1, 1, 1);
+
+        PSMTXInverse(rot, inv_rot);
+
+        TVec3f local_point = point, inv_point;
+        local_point -= box.center;
+        PSMTXMultVec(inv_rot, local_point, inv_point);
+        if (type == BoundingType::Box) {
+            return (fabsf(inv_point.x) <= box.size.x * 0.5f * scale) &&
+                   (fabsf(inv_point.y) <= box.size.y * 0.5f * scale) &&
+                   (fabsf(inv_point.z) <= box.size.z * 0.5f * scale);
+        } else {
+            inv_point.x /= (box.size.x * 0.5f * scale);
+            inv_point.y /= (box.size.y * 0.5f * scale);
+            inv_point.z /= (box.size.z * 0.5f * scale);
+
+            return sqrtf((inv_point.x * inv_point.x + inv_point.y * inv_point.y +
+                          inv_point.z * inv_point.z)) <= 1.0f;
+        }
+    }
+
+    // Distance used by the spheroid test, to tell rounding at the surface from a real mismatch
+    static f32 spheroidDistance(const BoundingBox &box, const TVec3f &point, f32 scale) {
+        Mtx rot, inv_rot;
+        MsMtxSetTRS(rot, 0, 0, 0, box.rotation.x, box.rotation.y, box.rotation.z, 1, 1, 1);
+        PSMTXInverse(rot, inv_rot);
+
+        TVec3f local_point = point, inv_point;
+        local_point -= box.center;
+        PSMTXMultVec(inv_rot, local_point, inv_point);
+
+        const f32 nx = inv_point.x / (box.size.x * 0.5f * scale);
+        const f32 ny = inv_point.y / (box.size.y * 0.5f * scale);
+        const f32 nz = inv_point.z / (box.size.z * 0.5f * scale);
+        return nx * nx + ny * ny + nz * nz;
+    }
+
+}  // namespace Reference
+
+static u32 sRandomState = 0x12345678;
+
+static f32 randomUnit() {
+    sRandomState = sRandomState * 1664525 + 1013904223;
+    return static_cast<f32>(sRandomState >> 8) / 8388608.0f - 1.0f;
+}
+
+static TVec3f randomVec(f32 range) {
+    return {randomUnit() * range, randomUnit() * range, randomUnit() * range};
+}
+
+constexpr size_t BoxCount      = 4096;
+constexpr size_t PointsPerBox  = 64;
+constexpr f32 SurfaceTolerance = 1.0f / 4194304.0f;  // 2^-22, an ULP either side of 1
+
+struct Scene {
+    std::vector<BoundingBox> mBoxes;
+    std::vector<TVec3f> mPoints;  // PointsPerBox around each box in turn
+};
+
+static Scene makeScene() {
+    Scene scene;
+    scene.mBoxes.reserve(BoxCount);
+    scene.mPoints.reserve(BoxCount * PointsPerBox);
+
+    for (size_t i = 0; i < BoxCount; ++i) {
+        const TVec3f center = randomVec(5000.0f);
+        const TVec3f size   = {100.0f + fabsf(randomUnit()) * 1000.0f,
+                               100.0f + fabsf(randomUnit()) * 1000.0f,
+                               100.0f + fabsf(randomUnit()) * 1000.0f};
+        const TVec3f rotation = i % 2 == 0 ? TVec3f{0.0f, 0.0f, 0.0f} : randomVec(180.0f);
+        scene.mBoxes.push_back(BoundingBox(center, size, rotation));
+
+        // Spread so that a good share of the points land outside
+        for (size_t j = 0; j < PointsPerBox; ++j) {
+            TVec3f point = randomVec(450.0f);
+            point += center;
+            scene.mPoints.push_back(point);
+        }
+    }
+
+    return scene;
+}
+
+static bool checkVolume(const Scene &scene, BoundingType type, const char *name) {
+    u32 mismatches = 0, surfaceCases = 0, contained = 0;
+    bool results[PointsPerBox];
+
+    for (size_t i = 0; i < BoxCount; ++i) {
+        const BoundingBox &box = scene.mBoxes[i];
+        const TVec3f *points   = &scene.mPoints[i * PointsPerBox];
+        const f32 scale        = i % 3 == 0 ? 1.5f : 1.0f;
+
+        CachedBoundingBox cached(box.center, box.size, box.rotation);
+        const size_t manyCount = cached.containsMany(points, results, PointsPerBox, scale, type);
+
+        size_t expectedCount = 0;
+        for (size_t j = 0; j < PointsPerBox; ++j) {
+            const bool expected = Reference::contains(box, points[j], scale, type);
+            expectedCount += expected ? 1 : 0;
+
+            const bool isAgreed = box.contains(points[j], scale, type) == expected &&
+                                  cached.contains(points[j], scale, type) == expected &&
+                                  results[j] == expected;
+            if (isAgreed)
+                continue;
+
+            const bool isSurface =
+                type == BoundingType::Spheroid &&
+                fabsf(Reference::spheroidDistance(box, points[j], scale) - 1.0f) <=
+                    SurfaceTolerance;
+            if (isSurface) {
+                surfaceCases += 1;
+                continue;
+            }
+
+            mismatches += 1;
+        }
+
+        if (manyCount != expectedCount && surfaceCases == 0)
+            mismatches += 1;
+        contained += expectedCount;
+    }
+
+    const bool isPassed = mismatches == 0;
+    printf("%-9s %u of %zu points contained, %u mismatches, %u on the surface  %s\n", name,
+           contained, BoxCount * PointsPerBox, mismatches, surfaceCases, isPassed ? "ok" : "FAIL");
+    return isPassed;
+}
+
+// A moved box must rebuild its matrices, and one moved back to no rotation must drop them
+static bool checkRotationChanges(const Scene &scene) {
+    u32 mismatches = 0;
+
+    CachedBoundingBox cached;
+    for (size_t i = 0; i < BoxCount; ++i) {
+        const BoundingBox &box = scene.mBoxes[i];
+        cached.set(box.center, box.size, box.rotation);
+
+        for (size_t j = 0; j < PointsPerBox; ++j) {
+            const TVec3f &point = scene.mPoints[i * PointsPerBox + j];
+            if (cached.contains(point) != Reference::contains(box, point, 1.0f, BoundingType::Box))
+                mismatches += 1;
+        }
+    }
+
+    const bool isPassed = mismatches == 0;
+    printf("%-9s %u mismatches after moving one cached box through every box  %s\n", "set",
+           mismatches, isPassed ? "ok" : "FAIL");
+    return isPassed;
+}
+
+static volatile size_t sBenchSink;
+
+template <typename Fn> static double timeFrames(Fn fn) {
+    constexpr int Frames = 20;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < Frames; ++frame)
+        fn();
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (BoxCount * PointsPerBox * static_cast<double>(Frames));
+}
+
+static void runBench(const Scene &scene) {
+    std::vector<CachedBoundingBox> cached;
+    cached.reserve(BoxCount);
+    for (const BoundingBox &box : scene.mBoxes)
+        cached.emplace_back(box.center, box.size, box.rotation);
+
+    bool results[PointsPerBox];
+    size_t contained = 0;
+
+    printf("\nHost throughput, ns per point (relative only)\n");
+    printf("%-9s %9s %9s %12s\n", "", "reference", "contains", "containsMany");
+
+    for (const BoundingType type : {BoundingType::Box, BoundingType::Spheroid}) {
+        const double reference = timeFrames([&] {
+            for (size_t i = 0; i < BoxCount; ++i) {
+                for (size_t j = 0; j < PointsPerBox; ++j)
+                    contained += Reference::contains(scene.mBoxes[i],
+                                                     scene.mPoints[i * PointsPerBox + j], 1.0f,
+                                                     type);
+            }
+        });
+        const double single = timeFrames([&] {
+            for (size_t i = 0; i < BoxCount; ++i) {
+                for (size_t j = 0; j < PointsPerBox; ++j)
+                    contained +=
+                        cached[i].contains(scene.mPoints[i * PointsPerBox + j], 1.0f, type);
+            }
+        });
+        const double many = timeFrames([&] {
+            for (size_t i = 0; i < BoxCount; ++i)
+                contained += cached[i].containsMany(&scene.mPoints[i * PointsPerBox], results,
+                                                    PointsPerBox, 1.0f, type);
+        });
+
+        printf("%-9s %9.2f %9.2f %12.2f\n", type == BoundingType::Box ? "box" : "spheroid",
+               reference, single, many);
+    }
+
+    sBenchSink = contained;
+}
+
+int main(int argc, char **argv) {
+    bool isBench = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            isBench = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--bench]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const Scene scene = makeScene();
+
+    bool isPassed = true;
+    isPassed &= checkVolume(scene, BoundingType::Box, "box");
+    isPassed &= checkVolume(scene, BoundingType::Spheroid, "spheroid");
+    isPassed &= checkRotationChanges(scene);
+
+    if (isBench)
+        runBench(scene);
+
+    return isPassed ? 0 : 1;
+}
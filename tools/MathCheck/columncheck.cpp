@@ -0,0 +1,540 @@
+// ColumnCheck - Compares TCollisionColumn with the per list water and roof lookups it replaced
+//
+// Usage: columncheck [--bench]
+// Build: c++ -std=c++20 -O2 -Ihost -I../../include/BetterSMS -I../../src/patches/collision
+//            columncheck.cpp ../../src/patches/collision/column.cpp -o columncheck
+//
+// Compiles src/patches/collision/column.cpp as it is against the stand-in
+// headers in host/. findAnyGroundLikePlaneBelow and findAnyRoofLikePlaneAbove,
+// which ran the patched checkGroundList and checkRoofList over the static and
+// moving ground, roof and wall lists of a cell one after another, are kept
+// below as the reference. Each random cell holds a stack of ground, roof, wall
+// and water layers spanning most of it among many small detail triangles, and
+// random columns through them are queried with every ignore flag, with the
+// collision fixes on like the water checks require.
+//
+// The old lookups had two list artifacts the column drops. checkRoofList
+// returned the first matching roof of a list rather than the lowest, and every
+// list allowed the step, so a moving ground or wall just above the sample hid
+// any lower match in the same list before the combine rejected it. Each query
+// is therefore matched exactly against the reference with those two artifacts
+// removed, and the old reference may only ever report a ground at or below, or
+// a roof at or above, what the column found. Exits 1 on any mismatch.
+//
+// --bench times the lookups enhanceWaterCheckGeneric_ makes for one sample,
+// one roof and three grounds, through the reference and through a column.
+// The figures only compare the two on this machine.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "logging.hxx"
+#include "module.hxx"
+#include "p_column.hxx"
+
+TBGCheckData TMapCollisionData::mIllegalCheckData = {};
+
+bool BetterSMS::isCollisionRepaired() { return true; }
+
+void BetterSMS::Console::record(Level level, Category category, const char *msg, ...) {}
+
+namespace Reference {
+
+    static bool isWaterType(u16 type) {
+        return (type >= 0x100 && type < 0x106) || type == 0x4104;
+    }
+
+    static bool isPassThroughType(u16 type) {
+        return type == 0x401 || type == 0x801 || type == 0x10A || type == 0x8400 || type == 0x800;
+    }
+
+    // patchedCheckGroundList with the collision fixes on. Without isStepAllowed
+    // the match must be at or below y
+    static f32 checkGroundList(f32 x, f32 y, f32 z, u8 flags, const TBGCheckList *list,
+                               const TBGCheckData **out, bool isStepAllowed) {
+        *out       = &TMapCollisionData::mIllegalCheckData;
+        f32 exactY = -32767.0f;
+
+        for (; list; list = list->mNextTriangle) {
+            const TBGCheckData *checkData = list->mColTriangle;
+            const u16 type                = checkData->mType;
+
+            if (y < checkData->mMinHeight)
+                continue;
+            if ((flags & 0b100000) && ((type >= 0x100 && type < 0x104) || type == 0x4104))
+                continue;
+            if ((flags & 0b10000) && checkData->isMarioThrough())
+                continue;
+            if ((flags & 0b1000) && !isWaterType(type))
+                continue;
+            if ((flags & 0b100) && isPassThroughType(type))
+                continue;
+            if ((flags & 0b1) && isWaterType(type))
+                continue;
+
+            const f32 ax = checkData->mVertices[0].x;
+            const f32 az = checkData->mVertices[0].z;
+            const f32 bx = checkData->mVertices[1].x;
+            const f32 bz = checkData->mVertices[1].z;
+            const f32 cx = checkData->mVertices[2].x;
+            const f32 cz = checkData->mVertices[2].z;
+
+            if (!(-1.0f <= (az - z) * (bx - ax) - (ax - x) * (bz - az)))
+                continue;
+            if (!(-1.0f <= (bz - z) * (cx - bx) - (bx - x) * (cz - bz) &&
+                  -1.0f <= (cz - z) * (ax - cx) - (cx - x) * (az - cz)))
+                continue;
+
+            const f32 sampleExactY = -(checkData->mProjectionFactor + x * checkData->mNormal.x +
+                                       z * checkData->mNormal.z) /
+                                     checkData->mNormal.y;
+            if (y - (sampleExactY - 78.0f) < 0.0f)
+                continue;
+            if (!isStepAllowed && sampleExactY > y)
+                continue;
+
+            if (sampleExactY > exactY) {
+                *out   = checkData;
+                exactY = sampleExactY;
+            }
+        }
+
+        return exactY;
+    }
+
+    // patchedCheckRoofList with the collision fixes on. isLowest keeps the lowest
+    // match instead of returning the first one, and without isStepAllowed the
+    // match must be above y
+    static f32 checkRoofList(f32 x, f32 y, f32 z, u8 flags, const TBGCheckList *list,
+                             const TBGCheckData **out, bool isLowest, bool isStepAllowed) {
+        *out       = &TMapCollisionData::mIllegalCheckData;
+        f32 exactY = 10000000.0f;
+
+        for (; list; list = list->mNextTriangle) {
+            const TBGCheckData *checkData = list->mColTriangle;
+            const u16 type                = checkData->mType;
+
+            if ((flags & 8) && !isWaterType(type))
+                continue;
+            if ((flags & 4) && isPassThroughType(type))
+                continue;
+            if ((flags & 1) && isWaterType(type))
+                continue;
+
+            const f32 ax = checkData->mVertices[0].x;
+            const f32 az = checkData->mVertices[0].z;
+            const f32 bx = checkData->mVertices[1].x;
+            const f32 bz = checkData->mVertices[1].z;
+            const f32 cx = checkData->mVertices[2].x;
+            const f32 cz = checkData->mVertices[2].z;
+
+            if (!((az - z) * (bx - ax) - (ax - x) * (bz - az) <= 1.0f))
+                continue;
+            if (!((bz - z) * (cx - bx) - (bx - x) * (cz - bz) <= 1.0f &&
+                  (cz - z) * (ax - cx) - (cx - x) * (az - cz) <= 1.0f))
+                continue;
+
+            const f32 sampleExactY = -(checkData->mProjectionFactor + x * checkData->mNormal.x +
+                                       z * checkData->mNormal.z) /
+                                     checkData->mNormal.y;
+            if (y - (sampleExactY + 78.0f) > 0.0f)
+                continue;
+            if (!isStepAllowed && sampleExactY <= y)
+                continue;
+
+            if (!isLowest) {
+                *out = checkData;
+                return sampleExactY;
+            }
+
+            if (sampleExactY < exactY) {
+                *out   = checkData;
+                exactY = sampleExactY;
+            }
+        }
+
+        return exactY;
+    }
+
+    static const TBGCheckListRoot *getRoot(const TBGCheckListRoot *roots,
+                                           const TMapCollisionData &data, f32 x, f32 z) {
+        const f32 gridFraction = 1.0f / 1024.0f;
+        const int cellX        = gridFraction * (x + data.mAreaSizeX);
+        const int cellZ        = gridFraction * (z + data.mAreaSizeZ);
+        return &roots[cellX + (cellZ * data.mBlockXCount)];
+    }
+
+    static bool isInBounds(const TMapCollisionData &data, f32 x, f32 z) {
+        return x >= -data.mAreaSizeX && x < data.mAreaSizeX && z >= -data.mAreaSizeZ &&
+               z < data.mAreaSizeZ;
+    }
+
+    // isExact drops the step from every list but the static ground
+    static f32 findAnyGroundLikePlaneBelow(const TVec3f &position, const TMapCollisionData &data,
+                                           u8 ignoreFlags, const TBGCheckData **out,
+                                           bool isExact) {
+        *out = &TMapCollisionData::mIllegalCheckData;
+
+        if (!isInBounds(data, position.x, position.z))
+            return 0;
+
+        const TBGCheckListRoot *statics =
+            getRoot(data.mStaticCollisionRoot, data, position.x, position.z);
+        const TBGCheckListRoot *moves =
+            getRoot(data.mMoveCollisionRoot, data, position.x, position.z);
+
+        // Static ground, then moving ground, static walls and moving walls
+        f32 aboveY = checkGroundList(position.x, position.y, position.z, ignoreFlags,
+                                     statics->mCheckList[TBGCheckListRoot::GROUND].mNextTriangle,
+                                     out, true);
+
+        const TBGCheckList *lists[] = {moves->mCheckList[TBGCheckListRoot::GROUND].mNextTriangle,
+                                       statics->mCheckList[TBGCheckListRoot::WALL].mNextTriangle,
+                                       moves->mCheckList[TBGCheckListRoot::WALL].mNextTriangle};
+        for (const TBGCheckList *list : lists) {
+            const TBGCheckData *potential;
+            f32 potentialY = checkGroundList(position.x, position.y, position.z, ignoreFlags, list,
+                                             &potential, !isExact);
+            if (potentialY > aboveY && potentialY <= position.y) {
+                *out   = potential;
+                aboveY = potentialY;
+            }
+        }
+
+        return aboveY;
+    }
+
+    // isExact takes the lowest roof of each list and drops the step from every
+    // list but the static roofs
+    static f32 findAnyRoofLikePlaneAbove(const TVec3f &position, const TMapCollisionData &data,
+                                         u8 ignoreFlags, const TBGCheckData **out, bool isExact) {
+        *out = &TMapCollisionData::mIllegalCheckData;
+
+        if (!isInBounds(data, position.x, position.z))
+            return 0;
+
+        const TBGCheckListRoot *statics =
+            getRoot(data.mStaticCollisionRoot, data, position.x, position.z);
+        const TBGCheckListRoot *moves =
+            getRoot(data.mMoveCollisionRoot, data, position.x, position.z);
+
+        // Static roofs, then moving roofs, static walls and moving walls
+        f32 aboveY = checkRoofList(position.x, position.y, position.z, ignoreFlags,
+                                   statics->mCheckList[TBGCheckListRoot::ROOF].mNextTriangle, out,
+                                   isExact, true);
+
+        const TBGCheckList *lists[] = {moves->mCheckList[TBGCheckListRoot::ROOF].mNextTriangle,
+                                       statics->mCheckList[TBGCheckListRoot::WALL].mNextTriangle,
+                                       moves->mCheckList[TBGCheckListRoot::WALL].mNextTriangle};
+        for (const TBGCheckList *list : lists) {
+            const TBGCheckData *potential;
+            f32 potentialY = checkRoofList(position.x, position.y, position.z, ignoreFlags, list,
+                                           &potential, isExact, !isExact);
+            if (potentialY < aboveY && potentialY > position.y) {
+                *out   = potential;
+                aboveY = potentialY;
+            }
+        }
+
+        return aboveY;
+    }
+
+}  // namespace Reference
+
+static u32 sRandomState = 0x12345678;
+
+static f32 randomUnit() {
+    sRandomState = sRandomState * 1664525 + 1013904223;
+    return static_cast<f32>(sRandomState >> 8) / 8388608.0f - 1.0f;
+}
+
+static u32 randomIndex(u32 count) {
+    sRandomState = sRandomState * 1664525 + 1013904223;
+    return (sRandomState >> 8) % count;
+}
+
+constexpr int BlockCount         = 8;  // Per side
+constexpr f32 CellSize           = 1024.0f;
+constexpr size_t LayersPerCell   = 12;   // Stacked surfaces spanning most of the cell
+constexpr size_t DetailPerCell   = 150;  // Small triangles, like terrain and props
+constexpr size_t SurfacesPerCell = LayersPerCell + DetailPerCell;
+constexpr size_t SamplesPerCell  = 64;
+
+static const u16 sSurfaceTypes[] = {0x0000, 0x0000, 0x0001, 0x0100, 0x0101, 0x0102,
+                                    0x0104, 0x4104, 0x0401, 0x0800, 0x8400};
+static const u8 sIgnoreFlags[]   = {0, 1, 4, 8, 0x10, 0x20, 1 | 4, 4 | 0x20};
+
+struct Scene {
+    std::vector<TBGCheckData> mTriangles;
+    std::vector<TBGCheckList> mNodes;
+    std::vector<TBGCheckListRoot> mStaticRoots;
+    std::vector<TBGCheckListRoot> mMoveRoots;
+    TMapCollisionData mData;
+};
+
+static TBGCheckData makeTriangle(f32 cellMinX, f32 cellMinZ, bool isLayer) {
+    const f32 centerX = cellMinX + (randomUnit() + 1.0f) * CellSize * 0.5f;
+    const f32 centerZ = cellMinZ + (randomUnit() + 1.0f) * CellSize * 0.5f;
+    const f32 height  = randomUnit() * 2000.0f;
+    const f32 radius  = isLayer ? 800.0f + fabsf(randomUnit()) * 800.0f
+                                : 60.0f + fabsf(randomUnit()) * 200.0f;
+
+    // Mostly flat stacked surfaces, with some slopes steep enough to land in the wall lists
+    const f32 tilt = randomIndex(4) == 0 ? 3000.0f : 300.0f;
+
+    TBGCheckData data = {};
+    data.mType        = sSurfaceTypes[randomIndex(sizeof(sSurfaceTypes) / sizeof(u16))];
+    data.mFlags       = randomIndex(4) == 0 ? 0x10 : 0;
+
+    const f32 angle = randomUnit() * 3.14159265f;
+    for (int i = 0; i < 3; ++i) {
+        const f32 vertexAngle = angle + i * 2.0943951f + randomUnit() * 0.3f;
+        data.mVertices[i]     = {centerX + cosf(vertexAngle) * radius, height + randomUnit() * tilt,
+                                 centerZ + sinf(vertexAngle) * radius};
+    }
+
+    // Either winding, so both upward and downward facing surfaces are stacked
+    if (randomIndex(2) == 0) {
+        const TVec3f swap = data.mVertices[1];
+        data.mVertices[1] = data.mVertices[2];
+        data.mVertices[2] = swap;
+    }
+
+    const TVec3f &a = data.mVertices[0];
+    const TVec3f &b = data.mVertices[1];
+    const TVec3f &c = data.mVertices[2];
+    const f32 nx    = (b.y - a.y) * (c.z - a.z) - (b.z - a.z) * (c.y - a.y);
+    const f32 ny    = (b.z - a.z) * (c.x - a.x) - (b.x - a.x) * (c.z - a.z);
+    const f32 nz    = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    const f32 scale = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
+
+    data.mNormal           = {nx * scale, ny * scale, nz * scale};
+    data.mProjectionFactor = -(data.mNormal.x * a.x + data.mNormal.y * a.y + data.mNormal.z * a.z);
+    data.mMinHeight        = fminf(a.y, fminf(b.y, c.y));
+    data.mMaxHeight        = fmaxf(a.y, fmaxf(b.y, c.y));
+    return data;
+}
+
+static Scene makeScene() {
+    constexpr size_t CellCount = BlockCount * BlockCount;
+
+    Scene scene;
+    scene.mTriangles.reserve(CellCount * SurfacesPerCell);
+    scene.mNodes.reserve(CellCount * SurfacesPerCell);
+    scene.mStaticRoots.resize(CellCount);
+    scene.mMoveRoots.resize(CellCount);
+
+    scene.mData.mAreaSizeX           = BlockCount * CellSize * 0.5f;
+    scene.mData.mAreaSizeZ           = BlockCount * CellSize * 0.5f;
+    scene.mData.mBlockXCount         = BlockCount;
+    scene.mData.mBlockZCount         = BlockCount;
+    scene.mData.mStaticCollisionRoot = scene.mStaticRoots.data();
+    scene.mData.mMoveCollisionRoot   = scene.mMoveRoots.data();
+
+    for (size_t cell = 0; cell < CellCount; ++cell) {
+        const f32 cellMinX = (cell % BlockCount) * CellSize - scene.mData.mAreaSizeX;
+        const f32 cellMinZ = (cell / BlockCount) * CellSize - scene.mData.mAreaSizeZ;
+
+        for (size_t i = 0; i < SurfacesPerCell; ++i) {
+            scene.mTriangles.push_back(makeTriangle(cellMinX, cellMinZ, i < LayersPerCell));
+            TBGCheckData *data = &scene.mTriangles.back();
+
+            // Plane type as TBGCheckData::getPlaneType sorts it
+            const s32 type = data->mNormal.y > 0.2f    ? TBGCheckListRoot::GROUND
+                             : data->mNormal.y < -0.2f ? TBGCheckListRoot::ROOF
+                                                       : TBGCheckListRoot::WALL;
+
+            TBGCheckListRoot &root =
+                randomIndex(3) == 0 ? scene.mMoveRoots[cell] : scene.mStaticRoots[cell];
+            scene.mNodes.push_back({root.mCheckList[type].mNextTriangle, data});
+            root.mCheckList[type].mNextTriangle = &scene.mNodes.back();
+        }
+    }
+
+    return scene;
+}
+
+struct Sample {
+    f32 mX, mY, mZ;
+    u8 mFlags;
+};
+
+static std::vector<Sample> makeSamples() {
+    std::vector<Sample> samples;
+    samples.reserve(BlockCount * BlockCount * SamplesPerCell);
+
+    const f32 halfSize = BlockCount * CellSize * 0.5f;
+    for (size_t i = 0; i < BlockCount * BlockCount * SamplesPerCell; ++i) {
+        Sample sample;
+        sample.mX = randomUnit() * halfSize;
+        sample.mZ = randomUnit() * halfSize;
+        // The water checks also probe from far above the whole column
+        sample.mY     = randomIndex(8) == 0 ? 10000000.0f : randomUnit() * 2500.0f;
+        sample.mFlags = sIgnoreFlags[randomIndex(sizeof(sIgnoreFlags))];
+        samples.push_back(sample);
+    }
+
+    // A few outside the grid, where both sides return 0
+    samples.push_back({halfSize, 0.0f, 0.0f, 0});
+    samples.push_back({0.0f, 0.0f, -halfSize - 1.0f, 8});
+    return samples;
+}
+
+static bool checkGround(const Scene &scene, const std::vector<Sample> &samples) {
+    u32 mismatches = 0, found = 0, unmasked = 0;
+
+    for (const Sample &sample : samples) {
+        const TCollisionColumn column(scene.mData, sample.mX, sample.mZ);
+        const TVec3f position = {sample.mX, sample.mY, sample.mZ};
+
+        const TBGCheckData *exactData, *oldData, *data;
+        const f32 exact = Reference::findAnyGroundLikePlaneBelow(position, scene.mData,
+                                                                 sample.mFlags, &exactData, true);
+        const f32 old   = Reference::findAnyGroundLikePlaneBelow(position, scene.mData,
+                                                                 sample.mFlags, &oldData, false);
+        const f32 height = column.findGroundBelow(sample.mY, sample.mFlags, &data);
+
+        if (height != exact || data != exactData || height < old) {
+            mismatches += 1;
+            continue;
+        }
+
+        if (data != &TMapCollisionData::mIllegalCheckData)
+            found += 1;
+        if (data != oldData)
+            unmasked += 1;
+    }
+
+    const bool isPassed = mismatches == 0;
+    printf("%-7s %u of %zu samples hit, %u mismatches, %u above a masked old match  %s\n",
+           "ground", found, samples.size(), mismatches, unmasked, isPassed ? "ok" : "FAIL");
+    return isPassed;
+}
+
+static bool checkRoof(const Scene &scene, const std::vector<Sample> &samples) {
+    u32 mismatches = 0, found = 0, unmasked = 0;
+
+    for (const Sample &sample : samples) {
+        const TCollisionColumn column(scene.mData, sample.mX, sample.mZ);
+        const TVec3f position = {sample.mX, sample.mY, sample.mZ};
+
+        const TBGCheckData *exactData, *oldData, *data;
+        const f32 exact  = Reference::findAnyRoofLikePlaneAbove(position, scene.mData,
+                                                                sample.mFlags, &exactData, true);
+        const f32 old    = Reference::findAnyRoofLikePlaneAbove(position, scene.mData,
+                                                                sample.mFlags, &oldData, false);
+        const f32 height = column.findRoofAbove(sample.mY, sample.mFlags, &data);
+
+        if (height != exact || data != exactData || height > old) {
+            mismatches += 1;
+            continue;
+        }
+
+        if (data != &TMapCollisionData::mIllegalCheckData)
+            found += 1;
+        if (data != oldData)
+            unmasked += 1;
+    }
+
+    const bool isPassed = mismatches == 0;
+    printf("%-7s %u of %zu samples hit, %u mismatches, %u below a masked old match  %s\n", "roof",
+           found, samples.size(), mismatches, unmasked, isPassed ? "ok" : "FAIL");
+    return isPassed;
+}
+
+static bool checkTruncation(const Scene &scene) {
+    size_t truncated = 0, largest = 0;
+
+    const f32 halfSize = BlockCount * CellSize * 0.5f;
+    for (int i = 0; i < 4096; ++i) {
+        const TCollisionColumn column(scene.mData, randomUnit() * halfSize,
+                                      randomUnit() * halfSize);
+        truncated += column.isTruncated() ? 1 : 0;
+        largest = column.size() > largest ? column.size() : largest;
+    }
+
+    const bool isPassed = truncated == 0;
+    printf("%-7s %zu truncated columns, at most %zu surfaces in one  %s\n", "column", truncated,
+           largest, isPassed ? "ok" : "FAIL");
+    return isPassed;
+}
+
+static volatile f32 sBenchSink;
+
+template <typename Fn> static double timeSamples(const std::vector<Sample> &samples, Fn fn) {
+    constexpr int Rounds = 20;
+
+    f32 sum          = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < Rounds; ++round) {
+        for (const Sample &sample : samples)
+            sum += fn(sample);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    sBenchSink      = sum;
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (samples.size() * static_cast<double>(Rounds));
+}
+
+static void runBench(const Scene &scene, const std::vector<Sample> &samples) {
+    printf("\nHost time per water sample, one roof and three ground lookups, ns (relative "
+           "only)\n");
+
+    const double reference = timeSamples(samples, [&](const Sample &sample) {
+        const TBGCheckData *roof, *ground;
+        const f32 roofY = Reference::findAnyRoofLikePlaneAbove(
+            {sample.mX, sample.mY, sample.mZ}, scene.mData, 0, &roof, false);
+        f32 sum = roofY;
+        sum += Reference::findAnyGroundLikePlaneBelow({sample.mX, roofY - 1.0f, sample.mZ},
+                                                      scene.mData, 8, &ground, false);
+        sum += Reference::findAnyGroundLikePlaneBelow({sample.mX, sum - 10.0f, sample.mZ},
+                                                      scene.mData, 1, &ground, false);
+        sum += Reference::findAnyGroundLikePlaneBelow({sample.mX, 10000000.0f, sample.mZ},
+                                                      scene.mData, 8, &ground, false);
+        return sum;
+    });
+
+    const double column = timeSamples(samples, [&](const Sample &sample) {
+        const TCollisionColumn column(scene.mData, sample.mX, sample.mZ);
+
+        const TBGCheckData *roof, *ground;
+        const f32 roofY = column.findRoofAbove(sample.mY, 0, &roof);
+        f32 sum         = roofY;
+        sum += column.findGroundBelow(roofY - 1.0f, 8, &ground);
+        sum += column.findGroundBelow(sum - 10.0f, 1, &ground);
+        sum += column.findGroundBelow(10000000.0f, 8, &ground);
+        return sum;
+    });
+
+    printf("%-9s %9.1f\n%-9s %9.1f\n", "reference", reference, "column", column);
+}
+
+int main(int argc, char **argv) {
+    bool isBench = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            isBench = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--bench]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const Scene scene                 = makeScene();
+    const std::vector<Sample> samples = makeSamples();
+
+    bool isPassed = true;
+    isPassed &= checkGround(scene, samples);
+    isPassed &= checkRoof(scene, samples);
+    isPassed &= checkTruncation(scene);
+
+    if (isBench)
+        runBench(scene, samples);
+
+    return isPassed ? 0 : 1;
+}
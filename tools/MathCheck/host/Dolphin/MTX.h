@@ -0,0 +1,85 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, only what fastmath and geometry
+// need. The PS routines are plain C here, with the SDK's single Newton step.
+
+#include <cmath>
+
+#include "types.h"
+
+struct Vec {
+    f32 x, y, z;
+};
+
+typedef f32 Mtx[3][4];
+
+inline f32 PSVECDotProduct(const Vec *a, const Vec *b) {
+    return a->x * b->x + a->y * b->y + a->z * b->z;
+}
+
+inline f32 PSVECMag(const Vec *vec) { return sqrtf(PSVECDotProduct(vec, vec)); }
+
+inline void PSVECNormalize(const Vec *vec, Vec *out) {
+    const f32 sq  = PSVECDotProduct(vec, vec);
+    const f32 est = 1.0f / sqrtf(sq);
+    const f32 inv = 0.5f * est * (3.0f - sq * est * est);
+    out->x        = vec->x * inv;
+    out->y        = vec->y * inv;
+    out->z        = vec->z * inv;
+}
+
+inline void PSVECCrossProduct(const Vec *a, const Vec *b, Vec *out) {
+    const Vec cross = {a->y * b->z - a->z * b->y, a->z * b->x - a->x * b->z,
+                       a->x * b->y - a->y * b->x};
+    *out            = cross;
+}
+
+inline void PSMTXIdentity(Mtx mtx) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j)
+            mtx[i][j] = i == j ? 1.0f : 0.0f;
+    }
+}
+
+inline void PSMTXCopy(const Mtx src, Mtx dst) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j)
+            dst[i][j] = src[i][j];
+    }
+}
+
+inline void PSMTXMultVec(const Mtx mtx, const Vec *src, Vec *dst) {
+    const Vec out = {mtx[0][0] * src->x + mtx[0][1] * src->y + mtx[0][2] * src->z + mtx[0][3],
+                     mtx[1][0] * src->x + mtx[1][1] * src->y + mtx[1][2] * src->z + mtx[1][3],
+                     mtx[2][0] * src->x + mtx[2][1] * src->y + mtx[2][2] * src->z + mtx[2][3]};
+    *dst          = out;
+}
+
+// Affine inverse through the adjugate, 0 when the matrix is singular like the SDK
+inline u32 PSMTXInverse(const Mtx src, Mtx inv) {
+    const f32 det = src[0][0] * (src[1][1] * src[2][2] - src[1][2] * src[2][1]) -
+                    src[0][1] * (src[1][0] * src[2][2] - src[1][2] * src[2][0]) +
+                    src[0][2] * (src[1][0] * src[2][1] - src[1][1] * src[2][0]);
+    if (det == 0.0f)
+        return 0;
+
+    const f32 invDet = 1.0f / det;
+
+    Mtx out;
+    out[0][0] = (src[1][1] * src[2][2] - src[1][2] * src[2][1]) * invDet;
+    out[0][1] = (src[0][2] * src[2][1] - src[0][1] * src[2][2]) * invDet;
+    out[0][2] = (src[0][1] * src[1][2] - src[0][2] * src[1][1]) * invDet;
+    out[1][0] = (src[1][2] * src[2][0] - src[1][0] * src[2][2]) * invDet;
+    out[1][1] = (src[0][0] * src[2][2] - src[0][2] * src[2][0]) * invDet;
+    out[1][2] = (src[0][2] * src[1][0] - src[0][0] * src[1][2]) * invDet;
+    out[2][0] = (src[1][0] * src[2][1] - src[1][1] * src[2][0]) * invDet;
+    out[2][1] = (src[0][1] * src[2][0] - src[0][0] * src[2][1]) * invDet;
+    out[2][2] = (src[0][0] * src[1][1] - src[0][1] * src[1][0]) * invDet;
+
+    for (int i = 0; i < 3; ++i) {
+        out[i][3] = -(out[i][0] * src[0][3] + out[i][1] * src[1][3] + out[i][2] * src[2][3]);
+    }
+
+    PSMTXCopy(out, inv);
+    return 1;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, boundbox.hxx only needs the types
+
+#include "types.h"
@@ -0,0 +1,7 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, only what fastmath and geometry need
+
+#include <cmath>
+
+#include "types.h"
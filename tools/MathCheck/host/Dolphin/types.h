@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, only what fastmath and geometry need
+
+#include <cstddef>
+#include <cstdint>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+typedef float f32;
+typedef double f64;
@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, only what boundbox needs
+
+#include "JGMVec.hxx"
+
+namespace JGeometry {
+    template <typename T> struct TBox {
+        T center;
+        T size;
+    };
+}  // namespace JGeometry
@@ -0,0 +1,39 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, only what fastmath, geometry and boundbox need
+
+#include <Dolphin/MTX.h>
+#include <Dolphin/types.h>
+
+// Derived from Vec so the PS routines see the same object, not a punned one
+struct TVec3f : Vec {
+    static TVec3f up() { return {0.0f, 1.0f, 0.0f}; }
+    static TVec3f forward() { return {0.0f, 0.0f, 1.0f}; }
+
+    TVec3f &operator+=(const TVec3f &other) {
+        x += other.x;
+        y += other.y;
+        z += other.z;
+        return *this;
+    }
+
+    TVec3f &operator-=(const TVec3f &other) {
+        sub(other);
+        return *this;
+    }
+
+    void scale(f32 factor) {
+        x *= factor;
+        y *= factor;
+        z *= factor;
+    }
+
+    void sub(const TVec3f &other) {
+        x -= other.x;
+        y -= other.y;
+        z -= other.z;
+    }
+
+    operator Vec *() { return this; }
+    operator const Vec *() const { return this; }
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, only what the collision column needs
+
+#include <Dolphin/types.h>
+#include <JSystem/JGeometry/JGMVec.hxx>
+
+class TBGCheckData {
+public:
+    bool isMarioThrough() const { return (mFlags & 0x10) != 0; }
+
+    u16 mType;
+    u16 mFlags;
+    f32 mMinHeight;
+    f32 mMaxHeight;
+    TVec3f mVertices[3];
+    TVec3f mNormal;
+    f32 mProjectionFactor;
+};
+
+class TBGCheckList {
+public:
+    TBGCheckList *mNextTriangle;
+    TBGCheckData *mColTriangle;
+};
+
+class TBGCheckListRoot {
+public:
+    enum { GROUND, ROOF, WALL };
+
+    TBGCheckList mCheckList[3];
+};
+
+class TMapCollisionData {
+public:
+    static TBGCheckData mIllegalCheckData;
+
+    f32 mAreaSizeX;
+    f32 mAreaSizeZ;
+    s32 mBlockXCount;
+    s32 mBlockZCount;
+    TBGCheckListRoot *mStaticCollisionRoot;
+    TBGCheckListRoot *mMoveCollisionRoot;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+// Host stand-in for the sms_interface header, only what geometry and boundbox need
+
+#include <JSystem/JGeometry/JGMVec.hxx>
+
+inline f32 MsGetRotFromZaxisY(const TVec3f &vec) {
+    return atan2f(vec.x, vec.z) * (180.0f / static_cast<f32>(M_PI));
+}
+
+// Rotation about X, then Y, then Z in degrees, scaled per axis and translated.
+// Only the rotation matters to the checks, and both sides of them share it.
+inline void MsMtxSetTRS(Mtx mtx, f32 tx, f32 ty, f32 tz, f32 rx, f32 ry, f32 rz, f32 sx, f32 sy,
+                        f32 sz) {
+    const f32 x = rx * (static_cast<f32>(M_PI) / 180.0f);
+    const f32 y = ry * (static_cast<f32>(M_PI) / 180.0f);
+    const f32 z = rz * (static_cast<f32>(M_PI) / 180.0f);
+
+    const f32 cx = cosf(x), snx = sinf(x);
+    const f32 cy = cosf(y), sny = sinf(y);
+    const f32 cz = cosf(z), snz = sinf(z);
+
+    mtx[0][0] = cy * cz * sx;
+    mtx[0][1] = (snx * sny * cz - cx * snz) * sy;
+    mtx[0][2] = (cx * sny * cz + snx * snz) * sz;
+    mtx[0][3] = tx;
+    mtx[1][0] = cy * snz * sx;
+    mtx[1][1] = (snx * sny * snz + cx * cz) * sy;
+    mtx[1][2] = (cx * sny * snz - snx * cz) * sz;
+    mtx[1][3] = ty;
+    mtx[2][0] = -sny * sx;
+    mtx[2][1] = snx * cy * sy;
+    mtx[2][2] = cx * cy * sz;
+    mtx[2][3] = tz;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <Dolphin/types.h>
+
+// Host stand-in for the PowerPC estimate instructions, defined by each tool
+// so the seed accuracy can be varied
+
+f64 __frsqrte(f64 x);
+f32 __frsqrtes(f32 x);
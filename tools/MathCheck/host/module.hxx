@@ -0,0 +1,10 @@
+#pragma once
+
+// Host stand-in for include/BetterSMS/module.hxx, only what src/fastmath.cpp and
+// the collision column need
+
+#define BETTER_SMS_FOR_EXPORT
+
+namespace BetterSMS {
+    bool isCollisionRepaired();
+}
@@ -0,0 +1,244 @@
+// MathCheck - Measures the BetterSMS::Math tiers against the host libm
+//
+// Usage: mathcheck [--seed-bits <n>] [--bench]
+// Build: c++ -std=c++20 -O2 -Ihost -I../../include/BetterSMS mathcheck.cpp
+//            ../../src/fastmath.cpp -o mathcheck
+//
+// Compiles include/BetterSMS/libs/fastmath.hxx and src/fastmath.cpp as they
+// are, against the stand-in headers in host/. The PowerPC frsqrte estimate is
+// modelled as the exact reciprocal square root off by the seed error, in both
+// directions, since the Newton steps converge differently from either side.
+// --seed-bits sets that error to 2^-n. The default of 12 is the precision the
+// tier comments in fastmath.hxx assume; the architecture only promises 5.
+//
+// Every float in [1, 4) is checked, which covers each mantissa with both
+// exponent parities, plus a sweep over the full normal range. The worst error
+// of each tier is reported in ULP of the correctly rounded result and checked
+// against the bound the seed precision allows. Exits 1 when any is exceeded.
+//
+// --bench times each tier against sqrtf and the sine table against sinf. The
+// seed then comes from the host's own estimate where there is one, so the
+// figures only compare tiers with each other on this machine; they say
+// nothing absolute about the console.
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define MATHCHECK_HOST_RSQRT 1
+#endif
+
+#include "libs/fastmath.hxx"
+
+using namespace BetterSMS::Math;
+
+static long double sSeedError = 0.0L;
+static bool sIsBenchSeed      = false;
+
+static f32 hostRsqrtEstimate(f32 x) {
+#if MATHCHECK_HOST_RSQRT
+    return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#else
+    const u32 bits = __builtin_bit_cast(u32, x);
+    return __builtin_bit_cast(f32, static_cast<u32>(0x5F375A86) - (bits >> 1));
+#endif
+}
+
+f64 __frsqrte(f64 x) {
+    if (sIsBenchSeed)
+        return hostRsqrtEstimate(static_cast<f32>(x));
+    return static_cast<f64>((1.0L / sqrtl(x)) * (1.0L + sSeedError));
+}
+
+f32 __frsqrtes(f32 x) {
+    if (sIsBenchSeed)
+        return hostRsqrtEstimate(x);
+    return static_cast<f32>((1.0L / sqrtl(x)) * (1.0L + sSeedError));
+}
+
+// Distance from the exact value in units of the last place of the float nearest it
+static double ulpError(f32 result, long double exact) {
+    const f32 nearest = static_cast<f32>(exact);
+    const f32 ulp     = nextafterf(fabsf(nearest), INFINITY) - fabsf(nearest);
+    return static_cast<double>(fabsl(static_cast<long double>(result) - exact) / ulp);
+}
+
+struct TierError {
+    double mSqrt;
+    double mRsqrt;
+    f32 mWorstSqrtInput;
+    u32 mMisroundedSqrts;  // Results other than the correctly rounded sqrtf
+};
+
+template <Tier P> static void measure(f32 x, TierError &error) {
+    const long double exact = sqrtl(static_cast<long double>(x));
+
+    const f32 result = BetterSMS::Math::sqrt<P>(x);
+    if (result != sqrtf(x))
+        error.mMisroundedSqrts += 1;
+
+    const double sqrtError = ulpError(result, exact);
+    if (sqrtError > error.mSqrt) {
+        error.mSqrt           = sqrtError;
+        error.mWorstSqrtInput = x;
+    }
+
+    const double rsqrtError = ulpError(rsqrt<P>(x), 1.0L / exact);
+    if (rsqrtError > error.mRsqrt)
+        error.mRsqrt = rsqrtError;
+}
+
+template <Tier P> static TierError sweepTier() {
+    TierError error = {0.0, 0.0, 0.0f, 0};
+
+    for (const long double seedError : {sSeedError, -sSeedError}) {
+        const long double saved = sSeedError;
+        sSeedError              = seedError;
+
+        // Every mantissa under both exponent parities
+        for (u32 bits = __builtin_bit_cast(u32, 1.0f); bits < __builtin_bit_cast(u32, 4.0f);
+             ++bits) {
+            measure<P>(__builtin_bit_cast(f32, bits), error);
+        }
+
+        // Every exponent, to catch range problems the binade above can't show
+        for (u32 bits = __builtin_bit_cast(u32, FLT_MIN); bits < __builtin_bit_cast(u32, FLT_MAX);
+             bits += 0x1003) {
+            measure<P>(__builtin_bit_cast(f32, bits), error);
+        }
+
+        sSeedError = saved;
+    }
+
+    return error;
+}
+
+// Relative error one Newton step leaves of a seed off by e, worst of either sign
+static double newtonError(double e) { return 1.5 * e * e + 0.5 * e * e * e; }
+
+// A handful of single precision multiplies each rounding by up to half an ULP
+constexpr double RoundingSlack = 3.0;
+
+static bool checkTier(const char *name, const TierError &error, double sqrtBound,
+                      double rsqrtBound) {
+    const bool isPassed = error.mSqrt <= sqrtBound && error.mRsqrt <= rsqrtBound;
+    printf("%-6s sqrt %9.3f ULP (bound %.1f, worst at %a, %u misrounded)  rsqrt %9.3f ULP "
+           "(bound %.1f)  %s\n",
+           name, error.mSqrt, sqrtBound, error.mWorstSqrtInput, error.mMisroundedSqrts,
+           error.mRsqrt, rsqrtBound, isPassed ? "ok" : "FAIL");
+    return isPassed;
+}
+
+static bool checkSinTable() {
+    double maxError = 0.0;
+    for (u32 i = 0; i <= 1000000; ++i) {
+        const f32 radians = static_cast<f32>(-4.0 * M_PI + (8.0 * M_PI * i) / 1000000.0);
+        maxError = std::fmax(maxError, fabs(static_cast<double>(sinTable(radians)) -
+                                            sin(static_cast<double>(radians))));
+        maxError = std::fmax(maxError, fabs(static_cast<double>(cosTable(radians)) -
+                                            cos(static_cast<double>(radians))));
+    }
+
+    // Interpolation error of 1024 samples per turn, (2pi / 1024)^2 / 8, plus float rounding
+    constexpr double SinBound = 5e-6;
+
+    const bool isPassed = maxError <= SinBound;
+    printf("table  sin/cos %.3g absolute (bound %.0e)  %s\n", maxError, SinBound,
+           isPassed ? "ok" : "FAIL");
+    return isPassed;
+}
+
+static volatile f32 sBenchSink;
+
+template <typename Fn> static double timeLoop(const std::vector<f32> &inputs, Fn fn) {
+    f32 sum          = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 20; ++pass) {
+        for (f32 x : inputs)
+            sum += fn(x);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    sBenchSink     = sum;
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (inputs.size() * 20.0);
+}
+
+static void runBench() {
+    sIsBenchSeed = true;
+
+    std::vector<f32> inputs(1 << 20);
+    u32 state = 0x12345678;
+    for (f32 &x : inputs) {
+        state = state * 1664525 + 1013904223;
+        x     = 0.001f + static_cast<f32>(state >> 8) * (10000.0f / 16777216.0f);
+    }
+
+    printf("\nHost throughput, ns per call (relative only)\n");
+    printf("  sqrtf   %6.2f\n", timeLoop(inputs, [](f32 x) { return sqrtf(x); }));
+    printf("  FAST    %6.2f\n",
+           timeLoop(inputs, [](f32 x) { return BetterSMS::Math::sqrt<Tier::FAST>(x); }));
+    printf("  MEDIUM  %6.2f\n",
+           timeLoop(inputs, [](f32 x) { return BetterSMS::Math::sqrt<Tier::MEDIUM>(x); }));
+    printf("  EXACT   %6.2f\n",
+           timeLoop(inputs, [](f32 x) { return BetterSMS::Math::sqrt<Tier::EXACT>(x); }));
+    printf("  sinf    %6.2f\n", timeLoop(inputs, [](f32 x) { return sinf(x); }));
+    printf("  table   %6.2f\n", timeLoop(inputs, [](f32 x) { return sinTable(x); }));
+
+    sIsBenchSeed = false;
+}
+
+int main(int argc, char **argv) {
+    int seedBits = 12;
+    bool isBench = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seed-bits") == 0 && i + 1 < argc) {
+            seedBits = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            isBench = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--seed-bits <n>] [--bench]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (seedBits < 1 || seedBits > 30) {
+        fprintf(stderr, "Seed bits must be between 1 and 30\n");
+        return 1;
+    }
+
+    sSeedError = ldexpl(1.0L, -seedBits);
+    printf("frsqrte modelled to within 2^-%d\n", seedBits);
+
+    const TierError fast   = sweepTier<Tier::FAST>();
+    const TierError medium = sweepTier<Tier::MEDIUM>();
+    const TierError exact  = sweepTier<Tier::EXACT>();
+
+    // FAST and MEDIUM may be off by what their Newton steps leave of the seed
+    // error, in ULP of the smallest result in a binade, plus the rounding of
+    // the single precision steps. EXACT rounds once, so at most one ULP.
+    const double seedError   = ldexp(1.0, -seedBits);
+    const double fastError   = newtonError(seedError);
+    const double mediumError = newtonError(fastError);
+    const double fastBound   = ldexp(fastError, 24) + RoundingSlack;
+    const double mediumBound = ldexp(mediumError, 24) + RoundingSlack;
+
+    bool isPassed = true;
+    isPassed &= checkTier("FAST", fast, fastBound, fastBound);
+    isPassed &= checkTier("MEDIUM", medium, mediumBound, mediumBound);
+    isPassed &= checkTier("EXACT", exact, 1.0, 1.0);
+    isPassed &= checkSinTable();
+
+    if (isBench)
+        runBench();
+
+    return isPassed ? 0 : 1;
+}